@@ -0,0 +1,165 @@
+#pragma once
+
+#include <Dolphin/types.h>
+
+#include <JSystem/bits/c++config.h>
+#include <JSystem/memory.hxx>
+#include <JSystem/type_traits.hxx>
+#include <JSystem/utility.hxx>
+
+#include <JSystem/JGadget/UnorderedMap.hxx>
+#include <JSystem/JGadget/Vector.hxx>
+#include <JSystem/JKernel/JKRHeap.hxx>
+
+// Bump region that is rewound at the top of every game loop. Anything allocated from it is
+// only valid until the end of the frame, so it must never back state that outlives one.
+// There is no locking, only code running on the game thread may allocate from it.
+class TFrameArena {
+public:
+    TFrameArena(void *buffer, size_t size)
+        : mStart(static_cast<u8 *>(buffer)), mEnd(static_cast<u8 *>(buffer) + size),
+          mCursor(static_cast<u8 *>(buffer)), mHighWaterMark(0), mOverflowCount(0) {}
+
+    // Falls back to the system heap when the region is exhausted
+    void *alloc(size_t size, size_t align = 4) {
+        u8 *ptr = reinterpret_cast<u8 *>((reinterpret_cast<u32>(mCursor) + (align - 1)) &
+                                         ~(align - 1));
+        if (ptr + size > mEnd) {
+            mOverflowCount += 1;
+            return JKRHeap::alloc(size, align, JKRHeap::sSystemHeap);
+        }
+
+        mCursor = ptr + size;
+        if (getUsedSize() > mHighWaterMark)
+            mHighWaterMark = getUsedSize();
+        return ptr;
+    }
+
+    // Only overflow allocations are actually released, the rest waits for `reset()`
+    void free(void *ptr) {
+        if (!contains(ptr))
+            JKRHeap::free(ptr, nullptr);
+    }
+
+    void reset() { mCursor = mStart; }
+
+    bool contains(const void *ptr) const {
+        return static_cast<const u8 *>(ptr) >= mStart && static_cast<const u8 *>(ptr) < mEnd;
+    }
+
+    size_t getCapacity() const { return mEnd - mStart; }
+    size_t getUsedSize() const { return mCursor - mStart; }
+    size_t getHighWaterMark() const { return mHighWaterMark; }
+    u32 getOverflowCount() const { return mOverflowCount; }
+
+private:
+    u8 *mStart;
+    u8 *mEnd;
+    u8 *mCursor;
+    size_t mHighWaterMark;
+    u32 mOverflowCount;
+};
+
+namespace BetterSMS {
+    namespace Memory {
+        TFrameArena &getFrameArena();
+    }
+}  // namespace BetterSMS
+
+template <typename _T> class TFrameAllocator {
+public:
+    typedef _T value_type;
+    typedef _T *pointer;
+    typedef _T &reference;
+    typedef const _T *const_pointer;
+    typedef const _T &const_reference;
+    typedef size_t size_type;
+    typedef ptrdiff_t difference_type;
+    template <class U> struct rebind {
+        typedef TFrameAllocator<U> other;
+    };
+
+    _GLIBCXX20_CONSTEXPR TFrameAllocator() _GLIBCXX_USE_NOEXCEPT = default;
+    _GLIBCXX20_CONSTEXPR
+    TFrameAllocator(const TFrameAllocator &other) _GLIBCXX_USE_NOEXCEPT = default;
+    template <class _U>
+    _GLIBCXX20_CONSTEXPR TFrameAllocator(const TFrameAllocator<_U> &other) _GLIBCXX_USE_NOEXCEPT
+        : _00() {}
+
+    _GLIBCXX20_CONSTEXPR pointer address(reference _x) const { return JSystem::addressof(_x); }
+    const_pointer address(const_reference _x) const _GLIBCXX_NOEXCEPT {
+        return JSystem::addressof(_x);
+    }
+
+#if __cplusplus < 201703L
+    pointer allocate(size_type _n, const void *hint = 0) {
+        if (_n > max_size())
+            return nullptr;
+        return static_cast<_T *>(
+            BetterSMS::Memory::getFrameArena().alloc(_n * sizeof(value_type), 4));
+    }
+#elif __cplusplus >= 201703L
+#if __cplusplus == 201703L
+    pointer allocate(size_type _n, const void *hint) {
+        if (_n > max_size())
+            return nullptr;
+        return static_cast<_T *>(
+            BetterSMS::Memory::getFrameArena().alloc(_n * sizeof(value_type), 4));
+    }
+#endif
+
+    _GLIBCXX_NODISCARD _GLIBCXX20_CONSTEXPR pointer allocate(size_t _n) {
+        return static_cast<_T *>(
+            BetterSMS::Memory::getFrameArena().alloc(_n * sizeof(value_type), 4));
+    }
+#endif
+
+    _GLIBCXX20_CONSTEXPR void deallocate(pointer _p, size_type) {
+        BetterSMS::Memory::getFrameArena().free(_p);
+    }
+
+#if __cplusplus <= 201703L
+    size_type max_size() const _GLIBCXX_USE_NOEXCEPT { return size_t(-1) / sizeof(value_type); }
+#endif
+
+#if __cplusplus < 201103L
+    void construct(pointer _p, const value_type &_val) { ::new ((void *)_p) value_type(_val); }
+#elif __cplusplus <= 201703L
+    template <typename... _Args> void construct(pointer _p, _Args &&..._args) {
+        ::new ((void *)_p) value_type(JSystem::forward<_Args>(_args)...);
+    }
+#else
+    template <typename... _Args> constexpr void construct_at(pointer _p, _Args &&..._args) {
+        ::new ((void *)_p) value_type(JSystem::forward<_Args>(_args)...);
+    }
+#endif
+
+#if __cplusplus < 201103L
+    void destroy(pointer _p) { _p->~_T(); }
+#else
+    template <class _U> _GLIBCXX20_CONSTEXPR void destroy(_U *_p) { _p->~_U(); }
+#endif
+
+private:
+    u8 _00;
+};
+
+template <typename T>
+inline bool operator==(const TFrameAllocator<T> &, const TFrameAllocator<T> &) {
+    return true;
+}
+
+template <typename T>
+inline bool operator!=(const TFrameAllocator<T> &, const TFrameAllocator<T> &) {
+    return false;
+}
+
+namespace BetterSMS {
+    template <class _T> using TFrameVector = JGadget::TVector<_T, TFrameAllocator<_T>>;
+
+    template <class _Key, class _T, class _Hash = JSystem::hash<_Key>,
+              class _Pred = JSystem::equal_to<_Key>>
+    using TFrameUnorderedMap =
+        JGadget::TUnorderedMap<_Key, _T, _Hash, _Pred,
+                               TFrameAllocator<JGadget::TPair<const _Key, _T>>>;
+}  // namespace BetterSMS
@@ -9,6 +9,8 @@
 
 #include <JSystem/JKernel/JKRHeap.hxx>
 
+#include "../memory.hxx"
+
 template <typename _T> class TGlobalAllocator {
 public:
     typedef _T value_type;
@@ -38,23 +40,26 @@ public:
     pointer allocate(size_type _n, const void *hint = 0) {
         if (_n > max_size())
             return nullptr;
-        return static_cast<_T *>(::operator new(_n * sizeof(value_type), JKRHeap::sSystemHeap, 4));
+        return trackedAllocate(_n, __builtin_return_address(0));
     }
 #elif __cplusplus >= 201703L
 #if __cplusplus == 201703L
     pointer allocate(size_type _n, const void *hint) {
         if (_n > max_size())
             return nullptr;
-        return static_cast<_T *>(::operator new(_n * sizeof(value_type), JKRHeap::sSystemHeap, 4));
+        return trackedAllocate(_n, __builtin_return_address(0));
     }
 #endif
 
     _GLIBCXX_NODISCARD _GLIBCXX20_CONSTEXPR pointer allocate(size_t _n) {
-        return static_cast<_T *>(::operator new(_n * sizeof(value_type), JKRHeap::sSystemHeap, 4));
+        return trackedAllocate(_n, __builtin_return_address(0));
     }
 #endif
 
-    _GLIBCXX20_CONSTEXPR void deallocate(pointer _p, size_type) { ::operator delete(_p); }
+    _GLIBCXX20_CONSTEXPR void deallocate(pointer _p, size_type) {
+        BetterSMS::Memory::trackFree(_p);
+        ::operator delete(_p);
+    }
 
 #if __cplusplus <= 201703L
     size_type max_size() const _GLIBCXX_USE_NOEXCEPT { return size_t(-1) / sizeof(value_type); }
@@ -79,6 +84,13 @@ public:
 #endif
 
 private:
+    pointer trackedAllocate(size_type _n, const void *site) {
+        void *obj = ::operator new(_n * sizeof(value_type), JKRHeap::sSystemHeap, 4);
+        BetterSMS::Memory::trackAllocation(obj, _n * sizeof(value_type), JKRHeap::sSystemHeap,
+                                           site);
+        return static_cast<_T *>(obj);
+    }
+
     u8 _00;
 };
 
@@ -0,0 +1,201 @@
+#pragma once
+
+#include <Dolphin/mem.h>
+#include <Dolphin/types.h>
+
+#include <JSystem/memory.hxx>
+#include <JSystem/utility.hxx>
+
+#include <JSystem/JKernel/JKRHeap.hxx>
+#include <SMS/macros.h>
+
+class TObjectPoolBase;
+
+namespace BetterSMS {
+    namespace Memory {
+        void registerObjectPool(TObjectPoolBase *pool);
+        void deregisterObjectPool(TObjectPoolBase *pool);
+        TObjectPoolBase *getObjectPools();
+    }  // namespace Memory
+}  // namespace BetterSMS
+
+// Untyped core of the object pools: an intrusive free list threaded through the unused
+// slots, plus the counters shown by the heap monitor. Pools link themselves into a global
+// registry on construction so the monitor can find pools owned by modules too.
+class TObjectPoolBase {
+public:
+    TObjectPoolBase(const char *name, size_t slotSize);
+    virtual ~TObjectPoolBase();
+
+    const char *getName() const { return mName; }
+    size_t getLiveCount() const { return mLiveCount; }
+    size_t getPeakCount() const { return mPeakCount; }
+    size_t getCapacity() const { return mCapacity; }
+
+    TObjectPoolBase *getNextPool() const { return mNextPool; }
+
+    friend void BetterSMS::Memory::registerObjectPool(TObjectPoolBase *pool);
+    friend void BetterSMS::Memory::deregisterObjectPool(TObjectPoolBase *pool);
+
+protected:
+    struct FreeSlot {
+        FreeSlot *mNext;
+    };
+
+    void addSlots(void *slots, size_t count) {
+        u8 *slot = static_cast<u8 *>(slots);
+        for (size_t i = 0; i < count; ++i, slot += mSlotSize) {
+            pushSlot(slot);
+        }
+        mCapacity += count;
+    }
+
+    void *popSlot() {
+        FreeSlot *slot = mFreeList;
+        if (!slot)
+            return nullptr;
+
+        mFreeList = slot->mNext;
+
+#if SMS_DEBUG
+        memset(slot, 0xCD, mSlotSize);
+#endif
+
+        mLiveCount += 1;
+        if (mLiveCount > mPeakCount)
+            mPeakCount = mLiveCount;
+        return slot;
+    }
+
+    void releaseSlot(void *ptr) {
+        pushSlot(ptr);
+        mLiveCount -= 1;
+    }
+
+private:
+    void pushSlot(void *ptr) {
+#if SMS_DEBUG
+        // Stale pointers into freed objects read back as 0xDD
+        memset(ptr, 0xDD, mSlotSize);
+#endif
+        FreeSlot *slot = static_cast<FreeSlot *>(ptr);
+        slot->mNext    = mFreeList;
+        mFreeList      = slot;
+    }
+
+    const char *mName;
+    size_t mSlotSize;
+    FreeSlot *mFreeList;
+    size_t mLiveCount;
+    size_t mPeakCount;
+    size_t mCapacity;
+    TObjectPoolBase *mNextPool;
+};
+
+inline TObjectPoolBase::TObjectPoolBase(const char *name, size_t slotSize)
+    : mName(name), mSlotSize(slotSize < sizeof(FreeSlot) ? sizeof(FreeSlot) : slotSize),
+      mFreeList(nullptr), mLiveCount(0), mPeakCount(0), mCapacity(0), mNextPool(nullptr) {
+    BetterSMS::Memory::registerObjectPool(this);
+}
+
+inline TObjectPoolBase::~TObjectPoolBase() { BetterSMS::Memory::deregisterObjectPool(this); }
+
+// Fixed pool of `N` objects stored inline. Allocation and release are O(1) and never touch a
+// heap; `construct` returns nullptr once every slot is live.
+template <typename T, size_t N> class TObjectPool : public TObjectPoolBase {
+public:
+    TObjectPool(const char *name) : TObjectPoolBase(name, sizeof(Slot)) { addSlots(mSlots, N); }
+
+    TObjectPool(const TObjectPool &)            = delete;
+    TObjectPool &operator=(const TObjectPool &) = delete;
+
+    template <typename... _Args> T *construct(_Args &&...args) {
+        void *slot = popSlot();
+        if (!slot)
+            return nullptr;
+        return ::new (slot) T(JSystem::forward<_Args>(args)...);
+    }
+
+    void destroy(T *obj) {
+        if (!obj)
+            return;
+        obj->~T();
+        releaseSlot(obj);
+    }
+
+    bool owns(const void *ptr) const {
+        return static_cast<const void *>(mSlots) <= ptr &&
+               ptr < static_cast<const void *>(mSlots + N);
+    }
+
+private:
+    union Slot {
+        FreeSlot mFree;
+        alignas(T) u8 mStorage[sizeof(T)];
+    };
+
+    Slot mSlots[N];
+};
+
+// Pool that grows by chunks of `ChunkN` objects taken from `heap` whenever it runs dry. Chunks
+// are only given back when the pool itself is destroyed.
+template <typename T, size_t ChunkN> class TChunkedObjectPool : public TObjectPoolBase {
+public:
+    TChunkedObjectPool(const char *name, JKRHeap *heap = nullptr)
+        : TObjectPoolBase(name, sizeof(Slot)), mHeap(heap), mChunks(nullptr) {}
+
+    ~TChunkedObjectPool() override {
+        while (mChunks) {
+            Chunk *next = mChunks->mNext;
+            JKRHeap::free(mChunks, nullptr);
+            mChunks = next;
+        }
+    }
+
+    TChunkedObjectPool(const TChunkedObjectPool &)            = delete;
+    TChunkedObjectPool &operator=(const TChunkedObjectPool &) = delete;
+
+    template <typename... _Args> T *construct(_Args &&...args) {
+        void *slot = popSlot();
+        if (!slot) {
+            if (!grow())
+                return nullptr;
+            slot = popSlot();
+        }
+        return ::new (slot) T(JSystem::forward<_Args>(args)...);
+    }
+
+    void destroy(T *obj) {
+        if (!obj)
+            return;
+        obj->~T();
+        releaseSlot(obj);
+    }
+
+private:
+    union Slot {
+        FreeSlot mFree;
+        alignas(T) u8 mStorage[sizeof(T)];
+    };
+
+    struct Chunk {
+        Chunk *mNext;
+        Slot mSlots[ChunkN];
+    };
+
+    bool grow() {
+        JKRHeap *heap = mHeap ? mHeap : JKRHeap::sSystemHeap;
+
+        Chunk *chunk = static_cast<Chunk *>(JKRHeap::alloc(sizeof(Chunk), 32, heap));
+        if (!chunk)
+            return false;
+
+        chunk->mNext = mChunks;
+        mChunks      = chunk;
+        addSlots(chunk->mSlots, ChunkN);
+        return true;
+    }
+
+    JKRHeap *mHeap;
+    Chunk *mChunks;
+};
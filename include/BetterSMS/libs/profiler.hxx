@@ -1,35 +1,59 @@
 #pragma once
 
 #include <Dolphin/OS.h>
+#include <Dolphin/types.h>
 
 #include <SMS/macros.h>
 
 namespace BetterSMS {
+    namespace Profiler {
+        // Open a zone on the calling thread, nested inside whichever zone is open already.
+        // `name` is kept by pointer, so it must have static storage (a literal or SMS_FUNC_SIG)
+        void beginZone(const char *name);
+        // Close the innermost zone opened on the calling thread
+        void endZone();
+
+        // Print the zones recorded over the last `frames` frames as Chrome trace JSON
+        void dumpChromeTrace(u32 frames);
+    }  // namespace Profiler
+
+    // Scoped profiler zone. Samples are only collected once debug mode has been enabled, and
+    // are aggregated per frame instead of being reported on every destruction.
     class TProfiler {
     public:
         TProfiler()                  = delete;
         TProfiler(const TProfiler &) = delete;
         TProfiler(TProfiler &&)      = delete;
 
-        TProfiler(const char *function) : mFunction(function) {
-            OSInitStopwatch(&mStopwatch, mFunction);
-            start();
-        }
+        TProfiler(const char *function) : mFunction(function), mIsOpen(false) { start(); }
+        ~TProfiler() { stop(); }
 
-        ~TProfiler() {
-            report();
-            stop();
+        void start() {
+            if (mIsOpen)
+                return;
+            Profiler::beginZone(mFunction);
+            mIsOpen = true;
         }
 
-        void start() { OSStartStopwatch(&mStopwatch); }
-        void stop() { OSStopStopwatch(&mStopwatch); }
-        void report() { OSDumpStopwatch(&mStopwatch); }
+        void stop() {
+            if (!mIsOpen)
+                return;
+            Profiler::endZone();
+            mIsOpen = false;
+        }
 
     private:
         const char *mFunction;
-        OSStopwatch mStopwatch;
+        bool mIsOpen;
     };
 }  // namespace BetterSMS
 
-#define BETTERSMS_START_PROFILE BetterSMS::TProfiler __profiler = BetterSMS::TProfiler(SMS_FUNC_SIG)
-#define BETTERSMS_STOP_PROFILE  __profiler.~TProfiler()
\ No newline at end of file
+#define _BETTERSMS_PROFILE_CONCAT_(a, b) a##b
+#define _BETTERSMS_PROFILE_CONCAT(a, b)  _BETTERSMS_PROFILE_CONCAT_(a, b)
+
+#define BETTERSMS_PROFILE_ZONE(name)                                                               \
+    BetterSMS::TProfiler _BETTERSMS_PROFILE_CONCAT(__profileZone, __LINE__)(name)
+#define BETTERSMS_PROFILE_FUNCTION BETTERSMS_PROFILE_ZONE(SMS_FUNC_SIG)
+
+#define BETTERSMS_START_PROFILE BetterSMS::TProfiler __profiler(SMS_FUNC_SIG)
+#define BETTERSMS_STOP_PROFILE  __profiler.stop()
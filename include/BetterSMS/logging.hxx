@@ -1,10 +1,41 @@
 #pragma once
 
+#include <Dolphin/OS.h>
+#include <Dolphin/types.h>
+#include <SMS/assert.h>
+#include <SMS/macros.h>
+
 namespace BetterSMS {
     namespace Console {
+        enum class LogLevel : u8 { VERBOSE, INFO, WARNING, CRITICAL };
+
+        // Messages are formatted on the calling thread and queued, then printed with OSReport
+        // by a low priority thread. A full queue drops messages instead of blocking the caller
         void log(const char *msg, ...);
         void hardwareLog(const char *msg, ...);
         void emulatorLog(const char *msg, ...);
         void debugLog(const char *msg, ...);
+        void report(LogLevel level, const char *msg, ...);
+
+        // Print everything still queued from the calling thread, e.g. before a panic
+        void flush();
     }  // namespace Console
 }  // namespace BetterSMS
+
+// The header interface's asserts panic straight away, which would lose whatever the log thread
+// had not printed yet. Redeclared here so the queue is flushed first on every failure path
+#undef SMS_ASSERT
+#define SMS_ASSERT(expr, msg, ...)                                                                 \
+    do {                                                                                           \
+        if (!(expr)) {                                                                             \
+            BetterSMS::Console::flush();                                                           \
+            OSPanic(__FILE__, __LINE__, msg, ##__VA_ARGS__);                                       \
+        }                                                                                          \
+    } while (0)
+
+#undef SMS_DEBUG_ASSERT
+#if SMS_DEBUG
+#define SMS_DEBUG_ASSERT(expr, msg, ...) SMS_ASSERT(expr, msg, ##__VA_ARGS__)
+#else
+#define SMS_DEBUG_ASSERT(expr, msg, ...)
+#endif
@@ -21,6 +21,14 @@ namespace BetterSMS {
         void *calloc(const size_t size, const size_t alignment);
         void *hcalloc(JKRHeap *heap, const size_t size, const size_t alignment);
         void free(const void *ptr);
+
+        // Debug mode bookkeeping of live blocks, `site` is usually the caller's return address.
+        // Only `Memory::free` and the global allocator call `trackFree`. Blocks released with
+        // plain `delete` or `JKRHeap::free` stay in the table and are reported as leaks, call
+        // `trackFree` yourself before those. Stage heap blocks are dropped at stage exit
+        void trackAllocation(const void *ptr, size_t size, JKRHeap *heap, const void *site);
+        void trackFree(const void *ptr);
+        void dumpAllocations();  // CSV over OSReport
     }  // namespace Memory
 
     namespace PowerPC {
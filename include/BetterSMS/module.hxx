@@ -90,7 +90,10 @@ namespace BetterSMS {
         }
 
         inline void lock() { mIsUnlocked = false; }
-        inline void unlock() { mIsUnlocked = true; }
+        inline void unlock() {
+            mIsUnlocked = true;
+            Settings::requestUnlockCheck();
+        }
 
     private:
         bool mIsUnlocked;
@@ -121,7 +124,10 @@ namespace BetterSMS {
         }
 
         inline void lock() { mIsUnlocked = false; }
-        inline void unlock() { mIsUnlocked = true; }
+        inline void unlock() {
+            mIsUnlocked = true;
+            Settings::requestUnlockCheck();
+        }
 
     private:
         static void valueChanged(void *old, void *cur, ValueKind kind) {
@@ -143,7 +149,29 @@ namespace BetterSMS {
     bool isModuleRegistered(const char *key);
     bool registerModule(const ModuleInfo &info);
 
+    // Callback time charged to a module, in OS ticks
+    struct ModuleFrameCost {
+        u32 mLastTicks;  // Last frame
+        u32 mAvgTicks;   // Per frame average over the last 60 frames
+        u32 mPeakTicks;  // Worst frame over the last 60 frames
+    };
+
+    // Game, Stage, Debug and Player init/load/update callbacks are charged to the most recently
+    // registered module. Player message, state machine and collision callbacks aren't timed.
+    // Call this before registering callbacks to charge another module instead
+    void setCallbackOwner(const char *key);
+    bool getModuleFrameCost(const char *key, ModuleFrameCost &out);
+
+    enum class AutoSaveStage { IDLE, BOOKMARKS, FLAGS, SETTINGS, OPTIONS, DONE, FAILED };
+
+    // Invoked on the main thread each time the autosave enters a new stage.
+    // `status` is a CARD error code, and is only non-zero for FAILED
+    typedef void (*AutoSaveCallback)(AutoSaveStage stage, s32 status);
+
     bool triggerAutoSave();
+    bool isAutoSaveActive();
+    AutoSaveStage getAutoSaveStage();
+    bool addAutoSaveCallback(AutoSaveCallback cb);
 
     int getScreenRenderWidth();
     int getScreenOrthoWidth();
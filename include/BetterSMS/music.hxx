@@ -38,6 +38,25 @@ namespace BetterSMS {
         void setLooping(bool loop);
         void setLoopPoint(s32 start, s32 end);
 
+        // Whether /AudioRes/Streams/Music has a stream for the song. Answered from an index of
+        // the directory built at boot, so this never touches the disc
+        bool isStreamAvailable(u32 id);
+        bool isStreamAvailable(const char *name);
+
+        /*
+        / Software decoder, built with BETTER_SMS_SOFTWARE_MUSIC. Without it these play nothing
+        / and return false
+        */
+
+        // Decodes the song on the CPU and mixes it into the game's own audio output instead of
+        // using the drive's audio stream. The current song, decoded or streamed, fades out while
+        // this one fades in over `seconds`
+        bool crossfadeSong(const char *name, f32 seconds);
+        // Reads the whole stream into RAM and plays it once over the current song
+        bool playJingle(const char *name);
+        void stopDecodedSongs(f32 fadeTime);
+        bool isDecodedSongPlaying();
+
         /*
         / Audio streamer
         */
@@ -53,14 +72,25 @@ namespace BetterSMS {
         constexpr size_t AudioInterruptRate         = 2000;
         #endif
         constexpr size_t AudioPreparePreOffset   = 0x8000;
+        // Stream bytes ahead of a loop point or the end where the drive is polled every
+        // `AudioInterruptRate` samples. Elsewhere the position is predicted from the sample count
+        constexpr size_t AudioPollNearOffset     = AudioPreparePreOffset * 2;
+        constexpr size_t AudioPollWatchdogRate   = 96000;  // 2 seconds at 48kHz
         constexpr OSTime AudioFadeInterval       = 16;  // 16ms
 
+        // Stream ADPCM packs 28 stereo samples into each 32 byte frame
+        constexpr u32 AudioFrameSize    = 32;
+        constexpr u32 AudioFrameSamples = 28;
+
+        // Plain descriptor of a queued track, cheap to copy with interrupts disabled. Loop
+        // points are in stream bytes, -1 when unset
         struct AudioPacket {
             union Identifier {
                 u32 as_u32;
                 const char *as_string;
             };
 
+            // Layout of a stream's side-car .txt, only parsed when the stream index is built
             struct PacketParams : public TParams {
                 PacketParams()
                     : TParams(), SMS_TPARAM_INIT(mLoopStart, -1),
@@ -70,33 +100,47 @@ namespace BetterSMS {
                 TParamT<s32> mLoopEnd;
             };
 
-            AudioPacket() : mParams() { mIdentifier.as_u32 = 0xFFFFFFFF; }
+            AudioPacket() : mIsString(false), mStreamHandle(-1), mLoopStart(-1), mLoopEnd(-1) {
+                mIdentifier.as_u32 = 0xFFFFFFFF;
+            }
 
-            AudioPacket(u32 id) : mParams() {
+            AudioPacket(u32 id)
+                : mIsString(false), mStreamHandle(-1), mLoopStart(-1), mLoopEnd(-1) {
                 mIdentifier.as_u32 = id;
-                mIsString          = false;
             }
 
-            AudioPacket(const char *file) : mParams() {
+            AudioPacket(const char *file)
+                : mIsString(true), mStreamHandle(-1), mLoopStart(-1), mLoopEnd(-1) {
                 mIdentifier.as_string = file;
-                mIsString             = true;
             }
 
             bool isString() const { return mIsString; }
             const char *getString() const { return mIdentifier.as_string; }
             u32 getID() const { return mIdentifier.as_u32; }
 
-            s32 getLoopStart() const { return mParams.mLoopStart.get(); }
-            s32 getLoopEnd() const { return mParams.mLoopEnd.get(); }
+            // Index of the stream in the music directory, resolved once the packet is queued
+            s16 getStreamHandle() const { return mStreamHandle; }
+            void setStreamHandle(s16 handle) { mStreamHandle = handle; }
+
+            s32 getLoopStart() const { return mLoopStart; }
+            s32 getLoopEnd() const { return mLoopEnd; }
+            s32 getLoopStartSamples() const { return toSamples(mLoopStart); }
+            s32 getLoopEndSamples() const { return toSamples(mLoopEnd); }
 
             void setLoopPoint(s32 start, s32 length);
             void setLoopPoint(s32 start, size_t length);
             void setLoopPoint(f32 start, f32 length);
 
         private:
+            static s32 toSamples(s32 bytes) {
+                return bytes < 0 ? -1 : (bytes / AudioFrameSize) * AudioFrameSamples;
+            }
+
             bool mIsString;
+            s16 mStreamHandle;
             Identifier mIdentifier;
-            PacketParams mParams;
+            s32 mLoopStart;
+            s32 mLoopEnd;
         };
 
         class AudioStreamer {
@@ -111,7 +155,9 @@ namespace BetterSMS {
                 SEEK,
                 CLEAR,
                 FADE_OUT,
-                FADE_IN
+                FADE_IN,
+                STAGE,
+                HANDOVER
             };
 
         public:
@@ -129,6 +175,10 @@ namespace BetterSMS {
 
             u32 getErrorStatus() const { return mErrorStatus; }
 
+            // DVD commands issued by the streamer over the last second, and in total
+            u32 getDVDCommandsPerSecond() const { return mDVDCommandsPerSecond; }
+            u32 getDVDCommandsIssued() const { return mDVDCommandsIssued; }
+
             u32 getStreamLength() const { return mStreamEnd - mStreamPos; }
             u32 getStreamPos() const { return mStreamPos + getStreamStart(); }
             u32 getStreamStart() const { return mAudioHandle->mStart; }
@@ -177,6 +227,10 @@ namespace BetterSMS {
             void update_();
 
             void nextTrack_();
+            void stageNext_();
+            bool prepareNextStream_();
+            void finishHandover_(u32 playAddr);
+            void closeHandover_();
 
             bool startLowStream();
             void pauseLowStream();
@@ -185,6 +239,10 @@ namespace BetterSMS {
 
             bool canPlayNextTrack() const;
 
+            u32 getSamplesUntilPoll_(u32 sampleCount) const;
+            void syncStreamPos_(u32 streamPos);
+            void countDVDCommand_();
+
             static void cbForVolumeAlarm(OSAlarm *alarm, OSContext *context);
             static void cbForAIInterrupt(u32 trigger);
             static void cbForGetStreamErrorStatusAsync_(u32 result, DVDCommandBlock *cmdBlock);
@@ -213,6 +271,14 @@ namespace BetterSMS {
             u32 mStreamEnd;
             u32 mErrorStatus;
             u32 mLastErrorStatus;
+            u32 mSyncPos;
+            u32 mSyncSamples;
+            u32 mLastPollSamples;
+            u32 mDVDCommandCount;
+            u32 mDVDCommandsPerSecond;
+            u32 mDVDCommandsIssued;
+            OSTime mDVDCommandWindowStart;
+            bool mHasStreamSync;
             bool mPlayNextTrack;
             bool mRequestedNext;
             bool mRequestedStop;
@@ -26,12 +26,24 @@ namespace BetterSMS {
     namespace Player {
         struct TPlayerData;
 
+        // Interned data key, resolve once with getDataHandle and keep it around
+        typedef u32 DataHandle;
+
+        constexpr DataHandle InvalidDataHandle   = 0xFFFFFFFF;
+        constexpr DataHandle BetterSMSDataHandle = 0;
+
         // Get the specialized BetterSMS info of a player
         void *getRegisteredData(TMario *player, const char *key);
 
         // Get arbitrary module data for a player
         TPlayerData *getData(TMario *player);
 
+        // Resolve a data key to a handle, interning it if it is new
+        DataHandle getDataHandle(const char *key);
+
+        // Fast path for getRegisteredData, no string compares
+        void *getData(TMario *player, DataHandle handle);
+
         // Use this to have extended params by potentially inheriting TPlayerData
         bool registerData(TMario *player, const char *key, void *data);
         void deregisterData(TMario *player, const char *key);
@@ -63,17 +75,39 @@ namespace BetterSMS {
         typedef bool (*MachineCallback)(TMario *);
         typedef void (*CollisionCallback)(TMario *, const TBGCheckData *, InteractionFlags_);
 
+        // Tick cost of a player callback, as measured by OSGetTick around each call
+        struct CallbackCost {
+            u32 mLastTicks;
+            u32 mPeakTicks;
+            u32 mCallCount;
+        };
+
         // Add a function to call on player init
         bool addInitCallback(InitCallback);
+        bool addInitCallback(InitCallback, s32 priority);
         // Add a function to call after the player loads and initializes
         bool addLoadAfterCallback(LoadAfterCallback);
-        // Add a function to call on player update
+        bool addLoadAfterCallback(LoadAfterCallback, s32 priority);
+        // Add a function to call on player update (higher priorities run first)
         bool addUpdateCallback(UpdateCallback);
+        bool addUpdateCallback(UpdateCallback, s32 priority);
+
+        // Toggle a registered callback without removing it
+        bool setInitCallbackEnabled(InitCallback, bool enabled);
+        bool setLoadAfterCallbackEnabled(LoadAfterCallback, bool enabled);
+        bool setUpdateCallbackEnabled(UpdateCallback, bool enabled);
+
+        // Get the measured cost of a registered callback, nullptr if it isn't registered
+        const CallbackCost *getInitCallbackCost(InitCallback);
+        const CallbackCost *getLoadAfterCallbackCost(LoadAfterCallback);
+        const CallbackCost *getUpdateCallbackCost(UpdateCallback);
         // Add a function to call on player message
         bool addMessageCallback(u32 id, ReceiveMessageCallback);
-        // Register a function to call for a specific player state
+        // Register a function to call for a specific player state (shared states run in
+        // registration order until one returns false)
         bool registerStateMachine(u32 state, MachineCallback);
-        // Register a function to call for a specific collision type
+        // Register a function to call for a specific collision type (shared types run in
+        // registration order)
         bool registerCollisionHandler(u16 state, CollisionCallback);
 
         // Warps the player to a collision face
@@ -29,6 +29,7 @@
 #include <SMS/assert.h>
 
 #include "libs/global_list.hxx"
+#include "logging.hxx"
 
 namespace BetterSMS {
     bool areBugsPatched();
@@ -48,6 +49,10 @@ namespace BetterSMS {
 
         class SettingsGroup;
 
+        // Lets the unlock notifier know a setting's `isUnlocked()` may have changed, otherwise
+        // it only notices on its next periodic check
+        void requestUnlockCheck();
+
 #pragma region SettingImplementation
 
         template <typename T> struct ValueRange {
@@ -86,6 +91,7 @@ namespace BetterSMS {
                 if (static_cast<int>(priority) <= static_cast<int>(mEditPriority)) {
                     mIsUserEditable = editable;
                     mEditPriority   = priority;
+                    requestUnlockCheck();
                 }
             }
 
@@ -294,6 +300,9 @@ namespace BetterSMS {
             }
         };
 
+        // Groups that leave `mBannerImage` null (and aren't global) don't get a save file of
+        // their own, their settings are packed into the engine's save next to its banner/icons.
+        // Groups that don't fit the engine's one block save still get a file of their own
         struct SettingsSaveInfo {
             const char *mSaveName;
             size_t mBlocks;
@@ -318,10 +327,11 @@ namespace BetterSMS {
         public:
             SettingsGroup() = delete;
             SettingsGroup(u8 major, u8 minor, Priority prio)
-                : mModule(), mVersion((major << 8) | minor), mIOValid(true), mOrderPriority(prio), mSettings() {}
+                : mModule(), mVersion((major << 8) | minor), mIOValid(true), mSettings(),
+                  mSaveInfo(), mOrderPriority(prio) {}
             SettingsGroup(u8 major, u8 minor, const SettingsList &settings, Priority prio)
-                : mModule(), mVersion((major << 8) | minor), mIOValid(true), mOrderPriority(prio),
-                  mSettings(settings) {}
+                : mModule(), mVersion((major << 8) | minor), mIOValid(true),
+                  mSettings(settings), mSaveInfo(), mOrderPriority(prio) {}
 
             friend const char *Settings::getGroupName(const SettingsGroup &group);
 
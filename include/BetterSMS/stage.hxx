@@ -2,6 +2,7 @@
 
 #include <JSystem/J2D/J2DOrthoGraph.hxx>
 #include <JSystem/JDrama/JDRNameRef.hxx>
+#include <JSystem/JSupport/JSUMemoryStream.hxx>
 #include <SMS/MapObj/MapObjInit.hxx>
 #include <SMS/System/Application.hxx>
 #include <SMS/System/MarDirector.hxx>
@@ -26,6 +27,10 @@ namespace BetterSMS {
         bool isDivingStage(u8 area, u8 episode);
         bool isExStage(u8 area, u8 episode);
 
+        // Start reading the params of a stage in the background, so the next stage load
+        // parses them from memory instead of waiting on the disc
+        bool prefetchStageParams(u8 area, u8 episode);
+
 #pragma region ConfigImplementation
         struct TStageParams : public TParams {
 
@@ -60,12 +65,16 @@ namespace BetterSMS {
                     sStageConfig = nullptr;
             }
 
+            // Which .prm file (if any) the params were resolved from
+            enum class ConfigKind : u8 { NONE, SPECIFIC, GENERALIZED };
+
             static TStageParams *sStageConfig;
 
             static char *stageNameToParamPath(char *dst, const char *stage, bool global = false);
 
             bool isCustomConfig() const { return mIsCustomConfigLoaded; }
-            void load(const char *stageName);
+            ConfigKind load(const char *stageName);
+            void loadFromStream(JSUMemoryInputStream &stream);
             void reset();
 
             // Stage Info
@@ -107,6 +116,8 @@ namespace BetterSMS {
             TParamRT<f32> mGravityMultiplier;
 
         private:
+            bool loadFromPath(const char *path);
+
             bool mIsCustomConfigLoaded;
         };
 #pragma endregion
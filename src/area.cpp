@@ -5,6 +5,7 @@
 
 #include "module.hxx"
 #include "p_area.hxx"
+#include "stage.hxx"
 
 #define MESSAGE_NO_DATA "NO DATA"
 
@@ -132,7 +133,15 @@ void BetterSMS::Stage::setNextStageHandler(NextStageCallback callback) {
     sNextStageHandler = callback;
 }
 
-static void moveStageHandler(TMarDirector *director) { sNextStageHandler(director); }
+static void moveStageHandler(TMarDirector *director) {
+    sNextStageHandler(director);
+
+    // The target is final now, get its params off the disc while the loading screen runs
+    if (gpApplication.mNextScene.mEpisodeID != 0xFF) {
+        Stage::prefetchStageParams(gpApplication.mNextScene.mAreaID,
+                                   gpApplication.mNextScene.mEpisodeID);
+    }
+}
 SMS_PATCH_BL(SMS_PORT_REGION(0x80297E40, 0, 0, 0), moveStageHandler);
 SMS_PATCH_BL(SMS_PORT_REGION(0x80299244, 0, 0, 0), moveStageHandler);
 SMS_PATCH_BL(SMS_PORT_REGION(0x8029933C, 0, 0, 0), moveStageHandler);
@@ -1,24 +1,170 @@
 #include <Dolphin/CARD.h>
 
+#include <SMS/Manager/FlagManager.hxx>
+#include <SMS/System/Application.hxx>
+#include <SMS/System/CardManager.hxx>
+
+#include "libs/global_vector.hxx"
+#include "logging.hxx"
 #include "module.hxx"
 #include "p_autosave.hxx"
 #include "p_settings.hxx"
 
+using namespace BetterSMS;
+
 extern SavePromptsSetting gSavePromptSetting;
 
 static bool gIsAutoSaveActive = false;
+static AutoSaveStage sAutoSaveStage = AutoSaveStage::IDLE;
+static TGlobalVector<AutoSaveCallback> sAutoSaveCBs;
+
+static TCardBookmarkInfo sBookMarkInfo;
+
+// The flag block is serialized when the save is triggered so that gameplay
+// can keep mutating flags while the card catches up
+#define FLAG_SNAPSHOT_SIZE 0x2000
+
+// One byte past the save block, the stream clamps instead of failing so a
+// write reaching it means the flags no longer fit
+static u8 SMS_ALIGN(32) sFlagSnapshot[FLAG_SNAPSHOT_SIZE + 1];
+static size_t sFlagSnapshotSize = 0;
+
+// What writeOptionBlock left in mCommand, cleared by the card manager once the write lands
+static s32 sOptionsCommand = 0;
 
 static u8 SMS_ALIGN(32) gSaveThreadStack[0x4000];
 static OSThread gSaveThread;
 
-static void *saveAllThread(void *arg) {
-    if (SaveAllSettings() != CARD_ERROR_READY) {
+static volatile bool sIsSettingsStageDone = false;
+static volatile s32 sSettingsStageStatus  = CARD_ERROR_READY;
+
+static void setAutoSaveStage(AutoSaveStage stage, s32 status) {
+    sAutoSaveStage = stage;
+    for (auto &item : sAutoSaveCBs) {
+        item(stage, status);
+    }
+}
+
+static void finishAutoSave(s32 status) {
+    if (status != CARD_ERROR_READY) {
+        Console::log("Autosave failed during stage %d! (Status: %d)\n", sAutoSaveStage, status);
         gSavePromptSetting.setInt(SavePromptsSetting::ALL);
+        setAutoSaveStage(AutoSaveStage::FAILED, status);
+    } else {
+        setAutoSaveStage(AutoSaveStage::DONE, status);
     }
+
+    sAutoSaveStage    = AutoSaveStage::IDLE;
     gIsAutoSaveActive = false;
+}
+
+// Settings IO sleeps on the CARD callbacks, but mounting and file creation
+// are synchronous, so this stage alone runs off the main thread
+static void *saveSettingsThread(void *arg) {
+    s32 status = Settings::mountCard();
+    if (status >= CARD_ERROR_READY) {
+        status = Settings::saveAllSettings() ? CARD_ERROR_READY : CARD_ERROR_FATAL_ERROR;
+        Settings::unmountCard();
+    }
+
+    gpCardManager->mount_(true);
+
+    sSettingsStageStatus = status < CARD_ERROR_READY ? status : CARD_ERROR_READY;
+    sIsSettingsStageDone = true;
     return nullptr;
 }
 
+static void beginFlagsStage() {
+    JSUMemoryOutputStream out(nullptr, 0);
+    gpCardManager->getWriteStream(&out);
+    out.write(sFlagSnapshot, sFlagSnapshotSize);
+    gpCardManager->writeBlock(gpApplication.mCurrentSaveBlock);  // This is the block being used
+    setAutoSaveStage(AutoSaveStage::FLAGS, CARD_ERROR_READY);
+}
+
+static void beginSettingsStage() {
+    sIsSettingsStageDone = false;
+    sSettingsStageStatus = CARD_ERROR_READY;
+    setAutoSaveStage(AutoSaveStage::SETTINGS, CARD_ERROR_READY);
+
+    OSCreateThread(&gSaveThread, saveSettingsThread, nullptr,
+                   gSaveThreadStack + sizeof(gSaveThreadStack), sizeof(gSaveThreadStack), 17, 0);
+    OSResumeThread(&gSaveThread);
+}
+
+static void beginOptionsStage() {
+    setAutoSaveStage(AutoSaveStage::OPTIONS, CARD_ERROR_READY);
+
+    const s32 idleCommand = gpCardManager->mCommand;
+
+    JSUMemoryOutputStream out(nullptr, 0);
+    gpCardManager->getOptionWriteStream(&out);
+    TFlagManager::smInstance->saveOption(out);
+    gpCardManager->writeOptionBlock();
+
+    sOptionsCommand = gpCardManager->mCommand;
+
+    // Already landed, there is nothing left to poll for
+    if (sOptionsCommand == idleCommand)
+        finishAutoSave(gpCardManager->getLastStatus());
+}
+
+// Advances the autosave one stage at a time. The card manager offers no
+// completion callback, so its commands are checked once per frame instead
+// of being spun on
+BETTER_SMS_FOR_CALLBACK void processAutoSave(TApplication *app) {
+    switch (sAutoSaveStage) {
+    case AutoSaveStage::BOOKMARKS: {
+        if (gpCardManager->mCommand == TCardManager::GETBOOKMARKS)
+            return;
+
+        if (s32 status = gpCardManager->getLastStatus()) {
+            finishAutoSave(status);
+            return;
+        }
+
+        beginFlagsStage();
+        return;
+    }
+    case AutoSaveStage::FLAGS: {
+        if (gpCardManager->mCommand == TCardManager::SAVEBLOCK)
+            return;
+
+        if (s32 status = gpCardManager->getLastStatus()) {
+            finishAutoSave(status);
+            return;
+        }
+
+        gpCardManager->unmount();
+        TFlagManager::smInstance->saveSuccess();
+
+        beginSettingsStage();
+        return;
+    }
+    case AutoSaveStage::SETTINGS: {
+        if (!sIsSettingsStageDone)
+            return;
+
+        if (sSettingsStageStatus != CARD_ERROR_READY) {
+            finishAutoSave(sSettingsStageStatus);
+            return;
+        }
+
+        beginOptionsStage();
+        return;
+    }
+    case AutoSaveStage::OPTIONS: {
+        if (gpCardManager->mCommand == sOptionsCommand)
+            return;
+
+        finishAutoSave(gpCardManager->getLastStatus());
+        return;
+    }
+    default:
+        return;
+    }
+}
+
 BETTER_SMS_FOR_EXPORT bool BetterSMS::triggerAutoSave() {
     if (gIsAutoSaveActive || gSavePromptSetting.getInt() != SavePromptsSetting::AUTO_SAVE)
         return false;
@@ -27,10 +173,33 @@ BETTER_SMS_FOR_EXPORT bool BetterSMS::triggerAutoSave() {
     if (status != CARD_ERROR_READY && status != CARD_ERROR_NOCARD)
         return false;
 
+    {
+        JSUMemoryOutputStream out(sFlagSnapshot, sizeof(sFlagSnapshot));
+        TFlagManager::smInstance->save(out);
+        sFlagSnapshotSize = out.getPosition();
+    }
+
+    // Writing a truncated flag block would corrupt the save, fall back to prompts instead
+    if (sFlagSnapshotSize > FLAG_SNAPSHOT_SIZE) {
+        Console::log("Autosave flag block is larger than 0x%X bytes!\n", FLAG_SNAPSHOT_SIZE);
+        finishAutoSave(CARD_ERROR_INSSPACE);
+        return false;
+    }
+
     gIsAutoSaveActive = true;
-    OSCreateThread(&gSaveThread, saveAllThread, NULL, gSaveThreadStack + sizeof(gSaveThreadStack),
-                   sizeof(gSaveThreadStack), 17, 0);
-    OSResumeThread(&gSaveThread);
+    gpCardManager->getBookmarkInfos(&sBookMarkInfo);
+    setAutoSaveStage(AutoSaveStage::BOOKMARKS, CARD_ERROR_READY);
+    return true;
+}
+
+BETTER_SMS_FOR_EXPORT bool BetterSMS::isAutoSaveActive() { return gIsAutoSaveActive; }
+
+BETTER_SMS_FOR_EXPORT BetterSMS::AutoSaveStage BetterSMS::getAutoSaveStage() {
+    return sAutoSaveStage;
+}
+
+BETTER_SMS_FOR_EXPORT bool BetterSMS::addAutoSaveCallback(AutoSaveCallback cb) {
+    sAutoSaveCBs.push_back(cb);
     return true;
 }
 
@@ -51,6 +51,7 @@ static u32 initCollisionWarpLinks(const char *name) {
 
     if (warpDataArray) {
         parseWarpLinks(gpMapCollisionData, warpDataArray, 16040, 4);
+        warpDataArray->buildIndex();
     }
 
     return JDrama::TNameRef::calcKeyCode(name);
@@ -176,6 +176,7 @@ void TWarpCollisionList::addLink(TCollisionLink &link) {
         return;
     }
     mColList[mUsedSize++] = link;
+    mIsIndexDirty         = true;
 }
 
 void TWarpCollisionList::removeLink(const TBGCheckData *home, const TBGCheckData *target) {
@@ -203,6 +204,7 @@ void TWarpCollisionList::removeLinkByIndex(u32 index) {
     memmove(&mColList[index], &mColList[index + 1],
             sizeof(TCollisionLink *) * (mUsedSize - index + 1));
     mUsedSize -= 1;
+    mIsIndexDirty = true;
 }
 
 const TBGCheckData *TWarpCollisionList::resolveCollisionWarp(const TBGCheckData *colTriangle) {
@@ -212,111 +214,230 @@ const TBGCheckData *TWarpCollisionList::resolveCollisionWarp(const TBGCheckData
     return getNearestTarget(colTriangle);
 }
 
-const TBGCheckData *TWarpCollisionList::getNearestTarget(const TBGCheckData *colTriangle) const {
-    if (!TCollisionLink::isValidWarpCol(colTriangle))
-        return nullptr;
+static inline f32 getCenterAxis(const TVec3f &center, u8 axis) {
+    switch (axis) {
+    case 0:
+        return center.x;
+    case 1:
+        return center.y;
+    default:
+        return center.z;
+    }
+}
 
-    TVectorTriangle colVector(colTriangle->mVertices[0], colTriangle->mVertices[1],
-                              colTriangle->mVertices[2]);
-    TVectorTriangle targetVector;
+void TWarpCollisionList::releaseIndex() {
+    if (mCenters)
+        JKRHeap::free(mCenters, nullptr);
+    if (mHomeOrder)
+        JKRHeap::free(mHomeOrder, nullptr);
+    if (mKdOrder)
+        JKRHeap::free(mKdOrder, nullptr);
+
+    mCenters   = nullptr;
+    mHomeOrder = nullptr;
+    mKdOrder   = nullptr;
+    mKdSize    = 0;
+}
 
-    u16 matchedIndices[mMaxSize];
-    f32 nearestDist = __FLT_MAX__;
+void TWarpCollisionList::buildIndex() {
+    releaseIndex();
+    memset(mHomeStart, 0, sizeof(mHomeStart));
+    mIsIndexDirty = false;
 
-    switch (TCollisionLink::getSearchModeFrom(colTriangle)) {
-    case TCollisionLink::SearchMode::HOME_TO_TARGET: {
-        for (u32 i = 0; i < size(); ++i) {
-            const TCollisionLink &colLink = mColList[i];
-            if (colLink.getSearchMode() == TCollisionLink::SearchMode::DISTANCE ||
-                !colLink.isValidDest())
-                continue;
-            if (colLink.getHomeID() == TCollisionLink::getTargetIDFrom(colTriangle) &&
-                colLink.getThisColTriangle() != colTriangle) {
-                return colLink.getThisColTriangle();
-            }
-            return nullptr;
-        }
+    if (mUsedSize == 0)
+        return;
+
+    mCenters = reinterpret_cast<TVec3f *>(
+        JKRHeap::sCurrentHeap->alloc(sizeof(TVec3f) * mUsedSize, 4));
+    mHomeOrder =
+        reinterpret_cast<u16 *>(JKRHeap::sCurrentHeap->alloc(sizeof(u16) * mUsedSize, 4));
+    mKdOrder = reinterpret_cast<u16 *>(JKRHeap::sCurrentHeap->alloc(sizeof(u16) * mUsedSize, 4));
+
+    if (!mCenters || !mHomeOrder || !mKdOrder) {
+        Console::debugLog("TWarpCollisionList::buildIndex(): Not enough memory for the index!\n");
+        releaseIndex();
+        return;
     }
-    case TCollisionLink::SearchMode::DISTANCE: {
-        s32 numLinked = 0;
-        for (u32 i = 0; i < size(); ++i) {
-            const TCollisionLink &colLink = mColList[i];
-            f32 minDist                   = TCollisionLink::getMinTargetDistanceFrom(colTriangle);
-            if (!colLink.isValidDest())
-                continue;
-            if (GetSqrDistBetweenColTriangles(colLink.getThisColTriangle(), colTriangle) >
-                    (minDist * minDist) &&
-                colLink.getThisColTriangle() != colTriangle) {
-                matchedIndices[numLinked++] = i;
-            }
-        }
 
-        TVec3f a;
-        TVec3f b;
-        s32 index = -1;
+    // Centers are only ever needed for destinations, compute them once here
+    for (u32 i = 0; i < mUsedSize; ++i) {
+        const TBGCheckData *tri = mColList[i].mColTriangle;
+        TVectorTriangle triangle(tri->mVertices[0], tri->mVertices[1], tri->mVertices[2]);
+        triangle.center(mCenters[i]);
 
-        for (u32 i = 0; i < numLinked; ++i) {
-            targetVector.a = mColList[matchedIndices[i]].mColTriangle->mVertices[0];
-            targetVector.b = mColList[matchedIndices[i]].mColTriangle->mVertices[1];
-            targetVector.c = mColList[matchedIndices[i]].mColTriangle->mVertices[2];
+        if (!mColList[i].isValidDest())
+            continue;
 
-            TVec3f thisCenter;
-            TVec3f targetCenter;
+        mHomeStart[mColList[i].mHomeID + 1] += 1;
+        mKdOrder[mKdSize++] = i;
+    }
 
-            colVector.center(thisCenter);
-            targetVector.center(targetCenter);
+    // Counting sort by home ID, stable so buckets keep list order
+    u16 bucketCursor[256];
+    for (u32 i = 0; i < 256; ++i) {
+        mHomeStart[i + 1] += mHomeStart[i];
+        bucketCursor[i] = mHomeStart[i];
+    }
 
-            f32 sqrDist = PSVECSquareDistance(reinterpret_cast<Vec *>(&thisCenter),
-                                              reinterpret_cast<Vec *>(&targetCenter));
-            if (sqrDist < nearestDist) {
-                nearestDist = sqrDist;
-                index       = i;
+    for (u32 i = 0; i < mUsedSize; ++i) {
+        if (!mColList[i].isValidDest())
+            continue;
+        mHomeOrder[bucketCursor[mColList[i].mHomeID]++] = i;
+    }
+
+    buildKdTree(mKdOrder, mKdSize, 0);
+}
+
+// Arrange `order` so the median on `axis` sits at the midpoint, then recurse on both halves
+void TWarpCollisionList::buildKdTree(u16 *order, u16 count, u8 axis) {
+    if (count <= 1)
+        return;
+
+    const s32 mid = count / 2;
+
+    s32 lo = 0;
+    s32 hi = count - 1;
+    while (lo < hi) {
+        const f32 pivot = getCenterAxis(mCenters[order[(lo + hi) / 2]], axis);
+
+        s32 i = lo;
+        s32 j = hi;
+        while (i <= j) {
+            while (getCenterAxis(mCenters[order[i]], axis) < pivot)
+                ++i;
+            while (getCenterAxis(mCenters[order[j]], axis) > pivot)
+                --j;
+            if (i <= j) {
+                const u16 tmp = order[i];
+                order[i++]    = order[j];
+                order[j--]    = tmp;
             }
         }
-        if (index == -1)
-            return nullptr;
 
-        return mColList[matchedIndices[index]].mColTriangle;
+        if (mid <= j)
+            hi = j;
+        else if (mid >= i)
+            lo = i;
+        else
+            break;
     }
-    case TCollisionLink::SearchMode::BOTH: {
-        s32 numLinked = 0;
-        for (u32 i = 0; i < size(); ++i) {
-            if (!mColList[i].isValidDest())
+
+    const u8 nextAxis = (axis + 1) % 3;
+    buildKdTree(order, mid, nextAxis);
+    buildKdTree(order + mid + 1, count - mid - 1, nextAxis);
+}
+
+void TWarpCollisionList::searchKdTree(const u16 *order, u16 count, u8 axis, const TVec3f &point,
+                                      const TBGCheckData *exclude, f32 minSqrDist,
+                                      f32 &nearestSqrDist, u16 &nearestIndex) const {
+    if (count == 0)
+        return;
+
+    const u16 mid   = count / 2;
+    const u16 index = order[mid];
+
+    const TVec3f &center = mCenters[index];
+
+    const f32 sqrDist = PSVECSquareDistance(reinterpret_cast<const Vec *>(&point),
+                                            reinterpret_cast<const Vec *>(&center));
+    if (sqrDist > minSqrDist && sqrDist < nearestSqrDist &&
+        mColList[index].mColTriangle != exclude) {
+        nearestSqrDist = sqrDist;
+        nearestIndex   = index;
+    }
+
+    const f32 delta   = getCenterAxis(point, axis) - getCenterAxis(center, axis);
+    const u8 nextAxis = (axis + 1) % 3;
+
+    const u16 *lower     = order;
+    const u16 *upper     = order + mid + 1;
+    const u16 lowerCount = mid;
+    const u16 upperCount = count - mid - 1;
+
+    if (delta < 0.0f) {
+        searchKdTree(lower, lowerCount, nextAxis, point, exclude, minSqrDist, nearestSqrDist,
+                     nearestIndex);
+        if (delta * delta < nearestSqrDist)
+            searchKdTree(upper, upperCount, nextAxis, point, exclude, minSqrDist, nearestSqrDist,
+                         nearestIndex);
+    } else {
+        searchKdTree(upper, upperCount, nextAxis, point, exclude, minSqrDist, nearestSqrDist,
+                     nearestIndex);
+        if (delta * delta < nearestSqrDist)
+            searchKdTree(lower, lowerCount, nextAxis, point, exclude, minSqrDist, nearestSqrDist,
+                         nearestIndex);
+    }
+}
+
+const TBGCheckData *TWarpCollisionList::getNearestTarget(const TBGCheckData *colTriangle) {
+    if (!TCollisionLink::isValidWarpCol(colTriangle))
+        return nullptr;
+
+    if (mIsIndexDirty)
+        buildIndex();
+
+    if (!mCenters)
+        return nullptr;
+
+    TVec3f thisCenter;
+    {
+        TVectorTriangle colVector(colTriangle->mVertices[0], colTriangle->mVertices[1],
+                                  colTriangle->mVertices[2]);
+        colVector.center(thisCenter);
+    }
+
+    const u8 targetID     = TCollisionLink::getTargetIDFrom(colTriangle);
+    const u16 *bucket     = mHomeOrder + mHomeStart[targetID];
+    const u16 bucketCount = mHomeStart[targetID + 1] - mHomeStart[targetID];
+
+    switch (TCollisionLink::getSearchModeFrom(colTriangle)) {
+    case TCollisionLink::SearchMode::HOME_TO_TARGET: {
+        for (u32 i = 0; i < bucketCount; ++i) {
+            const TCollisionLink &colLink = mColList[bucket[i]];
+            if (colLink.getSearchMode() == TCollisionLink::SearchMode::DISTANCE)
                 continue;
-            if (mColList[i].getHomeID() == TCollisionLink::getTargetIDFrom(colTriangle) &&
-                mColList[i].getThisColTriangle() != colTriangle) {
-                matchedIndices[numLinked++] = i;
-            }
+            if (colLink.getThisColTriangle() != colTriangle)
+                return colLink.getThisColTriangle();
         }
+        return nullptr;
+    }
+    case TCollisionLink::SearchMode::DISTANCE: {
+        const f32 minDist = TCollisionLink::getMinTargetDistanceFrom(colTriangle);
 
-        TVec3f a;
-        TVec3f b;
-        s32 index = -1;
+        f32 nearestDist = __FLT_MAX__;
+        u16 index       = NullIndex;
 
-        for (u32 i = 0; i < numLinked; ++i) {
-            targetVector.a = mColList[matchedIndices[i]].mColTriangle->mVertices[0];
-            targetVector.b = mColList[matchedIndices[i]].mColTriangle->mVertices[1];
-            targetVector.c = mColList[matchedIndices[i]].mColTriangle->mVertices[2];
+        searchKdTree(mKdOrder, mKdSize, 0, thisCenter, colTriangle, minDist * minDist,
+                     nearestDist, index);
+        if (index == NullIndex)
+            return nullptr;
 
-            TVec3f thisCenter;
-            TVec3f targetCenter;
+        return mColList[index].mColTriangle;
+    }
+    case TCollisionLink::SearchMode::BOTH: {
+        f32 nearestDist = __FLT_MAX__;
+        u16 index       = NullIndex;
 
-            colVector.center(thisCenter);
-            targetVector.center(targetCenter);
+        for (u32 i = 0; i < bucketCount; ++i) {
+            const TCollisionLink &colLink = mColList[bucket[i]];
+            if (colLink.getThisColTriangle() == colTriangle)
+                continue;
 
             f32 sqrDist = PSVECSquareDistance(reinterpret_cast<Vec *>(&thisCenter),
-                                              reinterpret_cast<Vec *>(&targetCenter));
+                                              reinterpret_cast<Vec *>(&mCenters[bucket[i]]));
             if (sqrDist < nearestDist) {
                 nearestDist = sqrDist;
-                index       = i;
+                index       = bucket[i];
             }
         }
-        if (index == -1)
+        if (index == NullIndex)
             return nullptr;
 
-        return mColList[matchedIndices[index]].mColTriangle;
+        return mColList[index].mColTriangle;
     }
     }
+
+    return nullptr;
 }
 
 static void warpPlayerToPoint(TMario *player, const TVec3f &point) {
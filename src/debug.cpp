@@ -11,28 +11,31 @@
 
 #include "libs/container.hxx"
 #include "libs/global_vector.hxx"
+#include "libs/profiler.hxx"
 #include "libs/string.hxx"
 
 #include "module.hxx"
 
+#include "p_module.hxx"
+
 using namespace BetterSMS;
 
-static TGlobalVector<Debug::InitCallback> sDebugInitCBs;
-static TGlobalVector<Debug::UpdateCallback> sDebugUpdateCBs;
-static TGlobalVector<Debug::DrawCallback> sDebugDrawCBs;
+static TGlobalVector<TModuleCallback<Debug::InitCallback>> sDebugInitCBs;
+static TGlobalVector<TModuleCallback<Debug::UpdateCallback>> sDebugUpdateCBs;
+static TGlobalVector<TModuleCallback<Debug::DrawCallback>> sDebugDrawCBs;
 
 BETTER_SMS_FOR_EXPORT bool BetterSMS::Debug::addInitCallback(InitCallback cb) {
-    sDebugInitCBs.push_back(cb);
+    sDebugInitCBs.push_back(makeModuleCallback(cb, "Debug::Init"));
     return true;
 }
 
 BETTER_SMS_FOR_EXPORT bool BetterSMS::Debug::addUpdateCallback(UpdateCallback cb) {
-    sDebugUpdateCBs.push_back(cb);
+    sDebugUpdateCBs.push_back(makeModuleCallback(cb, "Debug::Update"));
     return true;
 }
 
 BETTER_SMS_FOR_EXPORT bool BetterSMS::Debug::addDrawCallback(DrawCallback cb) {
-    sDebugDrawCBs.push_back(cb);
+    sDebugDrawCBs.push_back(makeModuleCallback(cb, "Debug::Draw"));
     return true;
 }
 
@@ -44,6 +47,7 @@ BETTER_SMS_FOR_CALLBACK void initDebugCallbacks(TApplication *app) {
 
     auto *currentHeap = JKRHeap::sRootHeap->becomeCurrentHeap();
 
+    BETTERSMS_PROFILE_ZONE("Debug::Init");
     for (auto &item : sDebugInitCBs) {
         item(app);
     }
@@ -55,6 +59,7 @@ BETTER_SMS_FOR_CALLBACK void updateDebugCallbacks(TApplication *app) {
     if (!BetterSMS::isDebugMode())
         return;
 
+    BETTERSMS_PROFILE_ZONE("Debug::Update");
     for (auto &item : sDebugUpdateCBs) {
         item(app);
     }
@@ -64,6 +69,7 @@ BETTER_SMS_FOR_CALLBACK void drawDebugCallbacks(TApplication *app, const J2DOrth
     if (!BetterSMS::isDebugMode())
         return;
 
+    BETTERSMS_PROFILE_ZONE("Debug::Draw");
     for (auto &item : sDebugDrawCBs) {
         item(app, ortho);
     }
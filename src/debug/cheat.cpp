@@ -15,6 +15,7 @@
 #include "libs/cheathandler.hxx"
 #include "libs/constmath.hxx"
 #include "libs/geometry.hxx"
+#include "libs/profiler.hxx"
 #include "logging.hxx"
 #include "module.hxx"
 #include "raw_fn.hxx"
@@ -127,8 +128,16 @@ BETTER_SMS_FOR_CALLBACK void checkDebugMode(TMario *player, bool isMario) {
         ButtonsFramePressed(player->mController, gControlToggleGameUI) &&
         !ButtonsPressed(player->mController, gSecondaryMask);
 
+    const bool shouldDumpProfile =
+        ButtonsFramePressed(player->mController, gControlDumpProfile) &&
+        ButtonsPressed(player->mController, gSecondaryMask) && gDebugUIPage == 6;
+
     if (shouldToggleDebugUI) {
-        gDebugUIPage = (gDebugUIPage + 1) % 6;
+        gDebugUIPage = (gDebugUIPage + 1) % 9;
+    }
+
+    if (shouldDumpProfile && BetterSMS::isDebugMode()) {
+        Profiler::dumpChromeTrace(4);
     }
 
     if (shouldToggleGameUI && BetterSMS::isDebugMode()) {
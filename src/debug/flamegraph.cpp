@@ -0,0 +1,158 @@
+#include <Dolphin/OS.h>
+#include <Dolphin/types.h>
+
+#include <JSystem/J2D/J2DOrthoGraph.hxx>
+#include <JSystem/J2D/J2DPane.hxx>
+#include <JSystem/J2D/J2DTextBox.hxx>
+#include <SMS/System/Application.hxx>
+#include <SMS/raw_fn.hxx>
+
+#include "debug.hxx"
+#include "libs/profiler.hxx"
+#include "module.hxx"
+
+#include "p_debug.hxx"
+#include "p_profiler.hxx"
+
+using namespace BetterSMS;
+
+#define FLAME_PAGE_MAX_DEPTH     8
+#define FLAME_PAGE_MAX_LINES     22
+#define FLAME_PAGE_UPDATE_FRAMES 30
+
+static s16 gFlameGraphX = 10, gFlameGraphY = 40;
+static u16 gFlameGraphWidth = 600, gFlameRowHeight = 8;
+
+static s16 gFlameTextY = gFlameGraphY + (FLAME_PAGE_MAX_DEPTH * gFlameRowHeight) + 8;
+static s16 gFlameFontWidth = 10, gFlameFontHeight = 11;
+
+static J2DTextBox *gpProfilerStringW = nullptr;
+static J2DTextBox *gpProfilerStringB = nullptr;
+static char sProfilerStringBuffer[FLAME_PAGE_MAX_LINES * 72]{};
+static u32 sProfilerPageTimer = 0;
+
+static const JUtility::TColor sFlameColors[] = {
+    {230, 120, 40, 220}, {220, 180, 40, 220}, {200, 80, 60, 220},
+    {240, 150, 90, 220}, {190, 140, 30, 220}, {230, 90, 110, 220},
+};
+
+static f32 getTicksAsMilliseconds(u32 ticks) {
+    return static_cast<f32>(OSTicksToMicroseconds(static_cast<u64>(ticks))) / 1000.0f;
+}
+
+BETTER_SMS_FOR_CALLBACK void initProfilerMonitor(TApplication *app) {
+    gpProfilerStringW                  = new J2DTextBox(gpSystemFont->mFont, "");
+    gpProfilerStringB                  = new J2DTextBox(gpSystemFont->mFont, "");
+    gpProfilerStringW->mStrPtr         = sProfilerStringBuffer;
+    gpProfilerStringB->mStrPtr         = sProfilerStringBuffer;
+    gpProfilerStringW->mNewlineSize    = gFlameFontHeight;
+    gpProfilerStringW->mCharSizeX      = gFlameFontWidth;
+    gpProfilerStringW->mCharSizeY      = gFlameFontHeight;
+    gpProfilerStringB->mNewlineSize    = gFlameFontHeight;
+    gpProfilerStringB->mCharSizeX      = gFlameFontWidth;
+    gpProfilerStringB->mCharSizeY      = gFlameFontHeight;
+    gpProfilerStringW->mGradientTop    = {255, 255, 255, 255};
+    gpProfilerStringW->mGradientBottom = {255, 255, 255, 255};
+    gpProfilerStringB->mGradientTop    = {0, 0, 0, 255};
+    gpProfilerStringB->mGradientBottom = {0, 0, 0, 255};
+
+    sProfilerPageTimer = 0;
+}
+
+// Depth first over the parent links. A child discovered after a sibling of its parent would
+// otherwise be listed below that sibling, siblings themselves keep their discovery order
+static void orderProfileZones(const ProfileZoneStats *zones, size_t zoneCount, s16 parent,
+                              u8 *orderOut, size_t &orderCount) {
+    // A parent is always discovered before its children
+    for (size_t i = parent + 1; i < zoneCount; ++i) {
+        if (zones[i].mParent != parent)
+            continue;
+        orderOut[orderCount++] = i;
+        orderProfileZones(zones, zoneCount, i, orderOut, orderCount);
+    }
+}
+
+static void updateProfilerText() {
+    const ProfileZoneStats *zones;
+    const size_t zoneCount = getProfileZones(zones);
+
+    u8 order[PROFILE_MAX_ZONES];
+    size_t orderCount = 0;
+    orderProfileZones(zones, zoneCount, -1, order, orderCount);
+
+    char *dst   = sProfilerStringBuffer;
+    size_t size = sizeof(sProfilerStringBuffer);
+
+    int written = snprintf(dst, size, "Frame %.02f ms, %lu dropped      min    avg    max\n",
+                           getTicksAsMilliseconds(getLastProfileFrameTicks()),
+                           getProfileDroppedZones());
+
+    size_t lines = 1;
+    for (size_t i = 0; i < orderCount && lines < FLAME_PAGE_MAX_LINES; ++i) {
+        if (written < 0 || static_cast<size_t>(written) >= size)
+            break;
+        dst += written;
+        size -= written;
+
+        const ProfileZoneStats &zone = zones[order[i]];
+        written = snprintf(dst, size, "%u %*s%-*.*s %6.02f %6.02f %6.02f\n", zone.mThread,
+                           zone.mDepth, "", 30 - zone.mDepth, 30 - zone.mDepth, zone.mName,
+                           getTicksAsMilliseconds(zone.mMinTicks),
+                           getTicksAsMilliseconds(zone.mAvgTicks),
+                           getTicksAsMilliseconds(zone.mMaxTicks));
+        lines += 1;
+    }
+}
+
+BETTER_SMS_FOR_CALLBACK void updateProfilerMonitor(TApplication *app) {
+    if (!gpProfilerStringW || gDebugUIPage != 6 || !BetterSMS::isDebugMode())
+        return;
+
+    if (sProfilerPageTimer++ % FLAME_PAGE_UPDATE_FRAMES != 0)
+        return;
+
+    updateProfilerText();
+}
+
+// Bars of the game thread's zones, placed by where they started in the last frame and
+// scaled by how long they ran relative to the whole frame
+static void drawFlameGraph() {
+    const u32 frameTicks = getLastProfileFrameTicks();
+    if (frameTicks == 0)
+        return;
+
+    const s16 adjust = getScreenRatioAdjustX();
+    const s16 x      = gFlameGraphX - adjust;
+    const f32 width  = static_cast<f32>(gFlameGraphWidth + (adjust * 2));
+
+    J2DFillBox(x, gFlameGraphY, width, FLAME_PAGE_MAX_DEPTH * gFlameRowHeight, {0, 0, 0, 170});
+
+    const ProfileZoneStats *zones;
+    const size_t zoneCount = getProfileZones(zones);
+
+    for (size_t i = 0; i < zoneCount; ++i) {
+        const ProfileZoneStats &zone = zones[i];
+        if (zone.mThread != 0 || zone.mLastCalls == 0 || zone.mDepth >= FLAME_PAGE_MAX_DEPTH)
+            continue;
+
+        const f32 start    = static_cast<f32>(zone.mLastStart) / frameTicks;
+        const f32 duration = static_cast<f32>(zone.mLastTicks) / frameTicks;
+
+        const f32 barX = Min(start, 1.0f) * width;
+        const f32 barW = Max(Min(duration, 1.0f - Min(start, 1.0f)) * width, 1.0f);
+
+        J2DFillBox(x + barX, gFlameGraphY + (zone.mDepth * gFlameRowHeight), barW,
+                   gFlameRowHeight - 1, sFlameColors[i % 6]);
+    }
+}
+
+BETTER_SMS_FOR_CALLBACK void drawProfilerMonitor(TApplication *app, const J2DOrthoGraph *graph) {
+    if (!gpProfilerStringW || gDebugUIPage != 6 || !BetterSMS::isDebugMode())
+        return;
+
+    drawFlameGraph();
+
+    s16 adjust = getScreenRatioAdjustX();
+    gpProfilerStringB->draw(gFlameGraphX - adjust + 1, gFlameTextY + 1);
+    gpProfilerStringW->draw(gFlameGraphX - adjust, gFlameTextY);
+}
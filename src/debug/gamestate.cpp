@@ -29,6 +29,10 @@ using namespace BetterSMS;
 
 
 extern int gDebugUIPage;
+extern u32 gStageParamsCacheHits;
+extern u32 gStageParamsCacheMisses;
+extern u32 gCollisionMemoHits;
+extern u32 gCollisionMemoMisses;
 
 static s16 gMonitorX = 10, gMonitorY = 180;
 static s16 gFontWidth = 11, gFontHeight = 11;
@@ -44,7 +48,7 @@ static J2DTextBox *gpCameraStateStringB    = nullptr;
 
 static char sPlayerStringBuffer[300]{};
 static char sWorldStringBuffer[300]{};
-static char sCollisionStringBuffer[350]{};
+static char sCollisionStringBuffer[400]{};
 static char sCameraStringBuffer[200]{};
 
 static size_t sHitObjCount = 0;
@@ -172,11 +176,13 @@ BETTER_SMS_FOR_CALLBACK void updateGameStateMonitor(TApplication *app) {
              "  Area ID:        %d\n"
              "  Episode ID:     %d\n"
              "  Warp ID:        0x%X\n"
-             "  Perform Objs:  %lu\n",
+             "  Perform Objs:  %lu\n"
+             "  Prm Cache:     %lu hits, %lu misses\n",
              director->mAreaID, director->mEpisodeID,
-             ((director->mAreaID + 1) << 8) | director->mEpisodeID, sHitObjCount);
+             ((director->mAreaID + 1) << 8) | director->mEpisodeID, sHitObjCount,
+             gStageParamsCacheHits, gStageParamsCacheMisses);
 
-    snprintf(sCollisionStringBuffer, 350,
+    snprintf(sCollisionStringBuffer, 400,
              "Collision Stats:\n"
              "  Triangles:       %lu\n"
              "  Static Lists:    %lu\n"
@@ -187,12 +193,14 @@ BETTER_SMS_FOR_CALLBACK void updateGameStateMonitor(TApplication *app) {
              "  Floor Value:    0x%hX\n"
              "  Wall Normal:    %.02f, %.02f, %.02f\n"
              "  Wall Type:      0x%hX\n"
-             "  Wall Value:     0x%hX\n",
+             "  Wall Value:     0x%hX\n"
+             "  Probe Memo:     %lu hits, %lu misses\n",
              gpMapCollisionData->mCheckDataCount, gpMapCollisionData->mCheckListStaticCount,
              gpMapCollisionData->mCheckListMax - gpMapCollisionData->mCheckListMoveRemaining,
              gpMapCollisionData->mCheckListWarpCount, floorColNormal.x, floorColNormal.y,
              floorColNormal.z, floorColType, floorColValue, wallColNormal.x, wallColNormal.y,
-             wallColNormal.z, wallColType, wallColValue);
+             wallColNormal.z, wallColType, wallColValue, gCollisionMemoHits,
+             gCollisionMemoMisses);
 
     TVec3f translation, rotation, scale;
     Matrix::decompose(gpCamera->mTRSMatrix, translation, rotation, scale);
@@ -0,0 +1,62 @@
+#include <Dolphin/types.h>
+
+#include <JSystem/J2D/J2DOrthoGraph.hxx>
+#include <JSystem/J2D/J2DTextBox.hxx>
+#include <SMS/System/Application.hxx>
+#include <SMS/raw_fn.hxx>
+
+#include "debug.hxx"
+#include "module.hxx"
+
+#include "p_debug.hxx"
+#include "p_logging.hxx"
+
+using namespace BetterSMS;
+
+#define LOG_PAGE_UPDATE_FRAMES 10
+
+static s16 gLogViewX = 10, gLogViewY = 180;
+static s16 gLogViewFontWidth = 10, gLogViewFontHeight = 11;
+
+static J2DTextBox *gpLogViewStringW = nullptr;
+static J2DTextBox *gpLogViewStringB = nullptr;
+static char sLogViewBuffer[LOG_HISTORY_LINES * (LOG_HISTORY_WIDTH + 1) + 1]{};
+static u32 sLogViewTimer = 0;
+
+BETTER_SMS_FOR_CALLBACK void initLogViewMonitor(TApplication *app) {
+    gpLogViewStringW                  = new J2DTextBox(gpSystemFont->mFont, "");
+    gpLogViewStringB                  = new J2DTextBox(gpSystemFont->mFont, "");
+    gpLogViewStringW->mStrPtr         = sLogViewBuffer;
+    gpLogViewStringB->mStrPtr         = sLogViewBuffer;
+    gpLogViewStringW->mNewlineSize    = gLogViewFontHeight;
+    gpLogViewStringW->mCharSizeX      = gLogViewFontWidth;
+    gpLogViewStringW->mCharSizeY      = gLogViewFontHeight;
+    gpLogViewStringB->mNewlineSize    = gLogViewFontHeight;
+    gpLogViewStringB->mCharSizeX      = gLogViewFontWidth;
+    gpLogViewStringB->mCharSizeY      = gLogViewFontHeight;
+    gpLogViewStringW->mGradientTop    = {255, 255, 255, 255};
+    gpLogViewStringW->mGradientBottom = {255, 255, 255, 255};
+    gpLogViewStringB->mGradientTop    = {0, 0, 0, 255};
+    gpLogViewStringB->mGradientBottom = {0, 0, 0, 255};
+
+    sLogViewTimer = 0;
+}
+
+BETTER_SMS_FOR_CALLBACK void updateLogViewMonitor(TApplication *app) {
+    if (!gpLogViewStringW || gDebugUIPage != 8 || !BetterSMS::isDebugMode())
+        return;
+
+    if (sLogViewTimer++ % LOG_PAGE_UPDATE_FRAMES != 0)
+        return;
+
+    copyLogHistory(sLogViewBuffer, sizeof(sLogViewBuffer));
+}
+
+BETTER_SMS_FOR_CALLBACK void drawLogViewMonitor(TApplication *app, const J2DOrthoGraph *graph) {
+    if (!gpLogViewStringW || gDebugUIPage != 8 || !BetterSMS::isDebugMode())
+        return;
+
+    s16 adjust = getScreenRatioAdjustX();
+    gpLogViewStringB->draw(gLogViewX - adjust + 1, gLogViewY + 1);
+    gpLogViewStringW->draw(gLogViewX - adjust, gLogViewY);
+}
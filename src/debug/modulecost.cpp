@@ -0,0 +1,152 @@
+#include <Dolphin/OS.h>
+#include <Dolphin/string.h>
+#include <Dolphin/types.h>
+
+#include <JSystem/J2D/J2DOrthoGraph.hxx>
+#include <JSystem/J2D/J2DTextBox.hxx>
+#include <SMS/System/Application.hxx>
+#include <SMS/raw_fn.hxx>
+
+#include "debug.hxx"
+#include "module.hxx"
+
+#include "p_debug.hxx"
+#include "p_module.hxx"
+
+using namespace BetterSMS;
+
+// Share of the frame a single module or hook may take before it is highlighted
+#define MODULE_COST_BUDGET        0.1f
+#define MODULE_COST_HOOK_LINES    10
+#define MODULE_COST_UPDATE_FRAMES 30
+#define MODULE_COST_BUFFER_SIZE   1400
+
+static s16 gModuleCostX = 10, gModuleCostY = 40;
+static s16 gModuleCostFontWidth = 10, gModuleCostFontHeight = 11;
+
+// Lines over budget go to the red buffer and leave an empty line in the white one, so the two
+// boxes can be drawn on top of each other
+static J2DTextBox *gpModuleCostStringW  = nullptr;
+static J2DTextBox *gpModuleCostStringR  = nullptr;
+static J2DTextBox *gpModuleCostStringBW = nullptr;
+static J2DTextBox *gpModuleCostStringBR = nullptr;
+static char sModuleCostBuffer[MODULE_COST_BUFFER_SIZE]{};
+static char sModuleCostOverBuffer[MODULE_COST_BUFFER_SIZE]{};
+static size_t sModuleCostLength = 0, sModuleCostOverLength = 0;
+static u32 sModuleCostTimer = 0;
+
+static J2DTextBox *makeModuleCostTextBox(char *buffer, JUtility::TColor color) {
+    auto *textBox            = new J2DTextBox(gpSystemFont->mFont, "");
+    textBox->mStrPtr         = buffer;
+    textBox->mNewlineSize    = gModuleCostFontHeight;
+    textBox->mCharSizeX      = gModuleCostFontWidth;
+    textBox->mCharSizeY      = gModuleCostFontHeight;
+    textBox->mGradientTop    = color;
+    textBox->mGradientBottom = color;
+    return textBox;
+}
+
+static f32 getTicksAsMilliseconds(u32 ticks) {
+    return static_cast<f32>(OSTicksToMicroseconds(static_cast<u64>(ticks))) / 1000.0f;
+}
+
+static void appendToBuffer(char *buffer, size_t &length, const char *text) {
+    const size_t textLength = strlen(text);
+    if (length + textLength >= MODULE_COST_BUFFER_SIZE)
+        return;
+    memcpy(buffer + length, text, textLength + 1);
+    length += textLength;
+}
+
+static void appendCostLine(const char *line, bool isOverBudget) {
+    if (isOverBudget) {
+        appendToBuffer(sModuleCostOverBuffer, sModuleCostOverLength, line);
+        appendToBuffer(sModuleCostBuffer, sModuleCostLength, "\n");
+    } else {
+        appendToBuffer(sModuleCostBuffer, sModuleCostLength, line);
+        appendToBuffer(sModuleCostOverBuffer, sModuleCostOverLength, "\n");
+    }
+}
+
+BETTER_SMS_FOR_CALLBACK void initModuleCostMonitor(TApplication *app) {
+    gpModuleCostStringW  = makeModuleCostTextBox(sModuleCostBuffer, {255, 255, 255, 255});
+    gpModuleCostStringR  = makeModuleCostTextBox(sModuleCostOverBuffer, {230, 60, 40, 255});
+    gpModuleCostStringBW = makeModuleCostTextBox(sModuleCostBuffer, {0, 0, 0, 255});
+    gpModuleCostStringBR = makeModuleCostTextBox(sModuleCostOverBuffer, {0, 0, 0, 255});
+
+    sModuleCostTimer = 0;
+}
+
+BETTER_SMS_FOR_CALLBACK void updateModuleCostMonitor(TApplication *app) {
+    if (!gpModuleCostStringW || gDebugUIPage != 7 || !BetterSMS::isDebugMode())
+        return;
+
+    if (sModuleCostTimer++ % MODULE_COST_UPDATE_FRAMES != 0)
+        return;
+
+    const u32 budgetTicks =
+        static_cast<u32>((OS_TIMER_CLOCK / BetterSMS::getFrameRate()) * MODULE_COST_BUDGET);
+
+    sModuleCostLength        = 0;
+    sModuleCostOverLength    = 0;
+    sModuleCostBuffer[0]     = '\0';
+    sModuleCostOverBuffer[0] = '\0';
+
+    char line[96];
+
+    snprintf(line, sizeof(line), "Module Costs (budget %.02f ms)       last    avg   peak\n",
+             getTicksAsMilliseconds(budgetTicks));
+    appendCostLine(line, false);
+
+    const ModuleCostInfo *modules;
+    const size_t moduleCount = getModuleCosts(modules);
+    for (size_t i = 0; i < moduleCount; ++i) {
+        const ModuleFrameCost &cost = modules[i].mCost;
+        snprintf(line, sizeof(line), "  %-32.32s %6.02f %6.02f %6.02f\n", modules[i].mName,
+                 getTicksAsMilliseconds(cost.mLastTicks), getTicksAsMilliseconds(cost.mAvgTicks),
+                 getTicksAsMilliseconds(cost.mPeakTicks));
+        appendCostLine(line, cost.mAvgTicks > budgetTicks);
+    }
+
+    appendCostLine("Most Expensive Hooks:\n", false);
+
+    const CallbackCostInfo *hooks;
+    const size_t hookCount = getCallbackCosts(hooks);
+
+    // Partial selection of the most expensive hooks by average, without reordering the table
+    u32 prevAvg      = 0xFFFFFFFF;
+    size_t prevIndex = hookCount;
+    for (size_t n = 0; n < MODULE_COST_HOOK_LINES; ++n) {
+        size_t best = hookCount;
+        for (size_t i = 0; i < hookCount; ++i) {
+            const u32 avg = hooks[i].mAvgTicks;
+            if (avg > prevAvg || (avg == prevAvg && i <= prevIndex))
+                continue;
+            if (best == hookCount || avg > hooks[best].mAvgTicks)
+                best = i;
+        }
+
+        if (best == hookCount || hooks[best].mAvgTicks == 0)
+            break;
+
+        const CallbackCostInfo &hook = hooks[best];
+        snprintf(line, sizeof(line), "  %-16s %p %-14.14s %6.02f %6.02f\n", hook.mHook,
+                 hook.mCallback, hook.mModule >= 0 ? modules[hook.mModule].mName : "(unowned)",
+                 getTicksAsMilliseconds(hook.mAvgTicks), getTicksAsMilliseconds(hook.mPeakTicks));
+        appendCostLine(line, hook.mAvgTicks > budgetTicks);
+
+        prevAvg   = hook.mAvgTicks;
+        prevIndex = best;
+    }
+}
+
+BETTER_SMS_FOR_CALLBACK void drawModuleCostMonitor(TApplication *app, const J2DOrthoGraph *graph) {
+    if (!gpModuleCostStringW || gDebugUIPage != 7 || !BetterSMS::isDebugMode())
+        return;
+
+    s16 adjust = getScreenRatioAdjustX();
+    gpModuleCostStringBW->draw(gModuleCostX - adjust + 1, gModuleCostY + 1);
+    gpModuleCostStringBR->draw(gModuleCostX - adjust + 1, gModuleCostY + 1);
+    gpModuleCostStringW->draw(gModuleCostX - adjust, gModuleCostY);
+    gpModuleCostStringR->draw(gModuleCostX - adjust, gModuleCostY);
+}
@@ -14,15 +14,18 @@
 #include "debug.hxx"
 #include "libs/cheathandler.hxx"
 #include "libs/constmath.hxx"
+#include "libs/frame_allocator.hxx"
+#include "libs/object_pool.hxx"
 #include "logging.hxx"
 #include "module.hxx"
 
 #include "p_debug.hxx"
+#include "p_memory.hxx"
 
 using namespace BetterSMS;
 
-static s16 gBaseMonitorX = 10, gMonitorY = 443;
-static u16 gMonitorWidth = 210, gMonitorHeight = 6 * 3;
+static s16 gBaseMonitorX = 10, gMonitorY = 438;
+static u16 gMonitorWidth = 210, gMonitorHeight = 6 * 4;
 
 static f32 gSystemHeapMaxUsage, gCurrentHeapMaxUsage, gRootHeapMaxUsage;
 static JKRHeap *gCurrentHeap = nullptr;
@@ -51,6 +54,34 @@ static void drawHeapUsage(JKRHeap *heap, f32 &maxUsage, JUtility::TColor color,
     }
 }
 
+// Current frame's arena use, with the all-time high-water mark as the marker
+static void drawFrameArenaUsage(const TFrameArena &arena, JUtility::TColor color, u16 y) {
+    const f32 capacity     = static_cast<f32>(arena.getCapacity());
+    const f32 currentUsage = static_cast<f32>(arena.getUsedSize()) / capacity;
+    const f32 maxUsage     = static_cast<f32>(arena.getHighWaterMark()) / capacity;
+
+    {
+        s16 adjust = getScreenRatioAdjustX();
+        drawMonitorBar(currentUsage, maxUsage, color, (gBaseMonitorX - adjust) + 2, y,
+                       (gMonitorWidth + adjust) - 6, 4);
+    }
+}
+
+// Live objects of a pool, with its peak as the marker
+static void drawObjectPoolUsage(const TObjectPoolBase &pool, JUtility::TColor color, u16 y) {
+    const f32 capacity     = static_cast<f32>(pool.getCapacity());
+    const f32 currentUsage = static_cast<f32>(pool.getLiveCount()) / capacity;
+    const f32 maxUsage     = static_cast<f32>(pool.getPeakCount()) / capacity;
+
+    {
+        s16 adjust = getScreenRatioAdjustX();
+        drawMonitorBar(currentUsage, maxUsage, color, (gBaseMonitorX - adjust) + 2, y,
+                       (gMonitorWidth + adjust) - 6, 4);
+    }
+}
+
+#define MAX_MONITORED_POOLS 4
+
 BETTER_SMS_FOR_CALLBACK void resetMonitor(TApplication *app) { gCurrentHeapMaxUsage = 0.0f; }
 
 BETTER_SMS_FOR_CALLBACK void drawMonitor(TApplication *app, const J2DOrthoGraph *graph) {
@@ -66,13 +97,135 @@ BETTER_SMS_FOR_CALLBACK void drawMonitor(TApplication *app, const J2DOrthoGraph
         gCurrentHeapMaxUsage = 0.0f;
     }
 
+    const TObjectPoolBase *pools[MAX_MONITORED_POOLS];
+    size_t poolCount = 0;
+    for (TObjectPoolBase *pool = Memory::getObjectPools();
+         pool && poolCount < MAX_MONITORED_POOLS; pool = pool->getNextPool()) {
+        if (pool->getCapacity() > 0)
+            pools[poolCount++] = pool;
+    }
+
+    // Grow upwards so the heap bars keep their place
+    const s16 monitorY = gMonitorY - (poolCount * 5);
+
     {
         s16 adjust = getScreenRatioAdjustX();
-        J2DFillBox(gBaseMonitorX - adjust, gMonitorY, gMonitorWidth + adjust, gMonitorHeight,
-                   {0, 0, 0, 170});
+        J2DFillBox(gBaseMonitorX - adjust, monitorY, gMonitorWidth + adjust,
+                   gMonitorHeight + (poolCount * 5), {0, 0, 0, 170});
+    }
+
+    for (size_t i = 0; i < poolCount; ++i) {
+        drawObjectPoolUsage(*pools[i], {200, 80, 200, 255}, monitorY + 2 + (i * 5));
     }
 
     drawHeapUsage(systemHeap, gSystemHeapMaxUsage, {220, 50, 30, 255}, gMonitorY + 2);
     drawHeapUsage(currentHeap, gCurrentHeapMaxUsage, {30, 230, 30, 255}, gMonitorY + 7);
     drawHeapUsage(rootHeap, gRootHeapMaxUsage, {40, 30, 230, 255}, gMonitorY + 12);
-}
\ No newline at end of file
+    drawFrameArenaUsage(Memory::getFrameArena(), {230, 200, 30, 255}, gMonitorY + 17);
+}
+
+// -- MEMORY PAGE -- //
+
+#define MEMORY_PAGE_SITE_COUNT    5
+#define MEMORY_PAGE_UPDATE_FRAMES 30
+
+static s16 gMemoryPageX = 10, gMemoryPageY = 180;
+static s16 gMemoryFontWidth = 11, gMemoryFontHeight = 11;
+
+static J2DTextBox *gpMemoryStringW = nullptr;
+static J2DTextBox *gpMemoryStringB = nullptr;
+static char sMemoryStringBuffer[700]{};
+static u32 sMemoryPageTimer = 0;
+
+static int printHeapFragmentation(char *dst, size_t size, const char *name, JKRHeap *heap) {
+    const size_t totalFree   = heap->getTotalFreeSize();
+    const size_t largestFree = heap->getFreeSize();
+    const f32 fragmentation =
+        totalFree > 0 ? 1.0f - (static_cast<f32>(largestFree) / totalFree) : 0.0f;
+    return snprintf(dst, size, "  %-8s %6lu free, %6lu largest, %.02f frag\n", name, totalFree,
+                    largestFree, fragmentation);
+}
+
+// Clamps to the end of the buffer so truncated lines can't run past it
+static void advanceMemoryString(char *&dst, size_t &size, int written) {
+    if (written < 0 || static_cast<size_t>(written) >= size) {
+        dst += size > 0 ? size - 1 : 0;
+        size = size > 0 ? 1 : 0;
+        return;
+    }
+    dst += written;
+    size -= written;
+}
+
+BETTER_SMS_FOR_CALLBACK void initMemoryMonitor(TApplication *app) {
+    gpMemoryStringW                  = new J2DTextBox(gpSystemFont->mFont, "");
+    gpMemoryStringB                  = new J2DTextBox(gpSystemFont->mFont, "");
+    gpMemoryStringW->mStrPtr         = sMemoryStringBuffer;
+    gpMemoryStringB->mStrPtr         = sMemoryStringBuffer;
+    gpMemoryStringW->mNewlineSize    = gMemoryFontHeight;
+    gpMemoryStringW->mCharSizeX      = gMemoryFontWidth;
+    gpMemoryStringW->mCharSizeY      = gMemoryFontHeight;
+    gpMemoryStringB->mNewlineSize    = gMemoryFontHeight;
+    gpMemoryStringB->mCharSizeX      = gMemoryFontWidth;
+    gpMemoryStringB->mCharSizeY      = gMemoryFontHeight;
+    gpMemoryStringW->mGradientTop    = {255, 255, 255, 255};
+    gpMemoryStringW->mGradientBottom = {255, 255, 255, 255};
+    gpMemoryStringB->mGradientTop    = {0, 0, 0, 255};
+    gpMemoryStringB->mGradientBottom = {0, 0, 0, 255};
+
+    sMemoryPageTimer = 0;
+}
+
+// Walking the side table is too slow to do every frame, so the page is refreshed periodically
+BETTER_SMS_FOR_CALLBACK void updateMemoryMonitor(TApplication *app) {
+    if (!gpMemoryStringW || gDebugUIPage != 5 || !BetterSMS::isDebugMode())
+        return;
+
+    if (sMemoryPageTimer++ % MEMORY_PAGE_UPDATE_FRAMES != 0)
+        return;
+
+    char *dst   = sMemoryStringBuffer;
+    size_t size = sizeof(sMemoryStringBuffer);
+
+    advanceMemoryString(dst, size, snprintf(dst, size, "Memory Stats:\n"));
+
+    JKRHeap *heaps[]        = {JKRHeap::sSystemHeap, JKRHeap::sCurrentHeap, JKRHeap::sRootHeap};
+    const char *heapNames[] = {"System:", "Current:", "Root:"};
+    for (size_t i = 0; i < 3; ++i) {
+        if (!heaps[i])
+            continue;
+        advanceMemoryString(dst, size,
+                            printHeapFragmentation(dst, size, heapNames[i], heaps[i]));
+    }
+
+    size_t trackedBytes;
+    u32 trackedBlocks, untracked;
+    getTrackedTotals(trackedBytes, trackedBlocks, untracked);
+
+    const StageLeakReport &leaks = getLastStageLeakReport();
+
+    advanceMemoryString(dst, size,
+                        snprintf(dst, size,
+                                 "  Tracked:    %lu bytes in %lu blocks (%lu dropped)\n"
+                                 "  Stage Leak: %lu bytes in %lu blocks\n"
+                                 "Top Sites:\n",
+                                 trackedBytes, trackedBlocks, untracked, leaks.mBytes,
+                                 leaks.mBlocks));
+
+    AllocationSiteStat sites[MEMORY_PAGE_SITE_COUNT];
+    const size_t siteCount = getAllocationSiteStats(sites, MEMORY_PAGE_SITE_COUNT);
+    for (size_t i = 0; i < siteCount; ++i) {
+        advanceMemoryString(dst, size,
+                            snprintf(dst, size, "  %p  %6lu bytes (%lu)\n", sites[i].mSite,
+                                     sites[i].mBytes, sites[i].mBlocks));
+    }
+}
+
+BETTER_SMS_FOR_CALLBACK void drawMemoryMonitor(TApplication *app, const J2DOrthoGraph *graph) {
+    if (!gpMemoryStringW || gDebugUIPage != 5 || !BetterSMS::isDebugMode())
+        return;
+
+    s16 adjust = getScreenRatioAdjustX();
+    gpMemoryStringB->draw(gMemoryPageX - adjust + 1, gMemoryPageY + 1);
+    gpMemoryStringW->draw(gMemoryPageX - adjust, gMemoryPageY);
+}
@@ -25,7 +25,7 @@
 
 using namespace BetterSMS;
 
-static char sStringBuffer[100]{};
+static char sStringBuffer[140]{};
 static J2DTextBox *gpMusicStringW = nullptr;
 static J2DTextBox *gpMusicStringB = nullptr;
 static bool sIsInitialized        = false;
@@ -71,13 +71,15 @@ void printStreamInfo(TApplication *app, const J2DOrthoGraph *graph) {
     u32 streamPos   = streamer->getStreamPos();
     u32 streamSize  = streamEnd - streamStart;
 
-    snprintf(sStringBuffer, 100,
+    snprintf(sStringBuffer, sizeof(sStringBuffer),
              "Stream:\n"
              "  Status:      %lu\n"
              "  CurAddress: 0x%lX\n"
              "  EndAddress: 0x%lX\n"
-             "  FInfoSize:    0x%lX",
-             streamer->getErrorStatus(), streamPos, streamEnd, streamSize);
+             "  FInfoSize:    0x%lX\n"
+             "  DVD Cmds/s:  %lu",
+             streamer->getErrorStatus(), streamPos, streamEnd, streamSize,
+             streamer->getDVDCommandsPerSecond());
 
     gpMusicStringB->draw(111, 103);
     gpMusicStringW->draw(110, 102);
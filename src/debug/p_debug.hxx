@@ -28,6 +28,7 @@ constexpr auto gControlToggleDebugActive = TMarioGamePad::DPAD_UP;    // Activat
 constexpr auto gControlToggleDebugState  = TMarioGamePad::DPAD_UP;    // Secondary
 constexpr auto gControlToggleDebugUI     = TMarioGamePad::DPAD_DOWN;  // Secondary
 constexpr auto gControlToggleGameUI      = TMarioGamePad::DPAD_DOWN;
+constexpr auto gControlDumpProfile       = TMarioGamePad::DPAD_RIGHT;  // Secondary, profiler page
 
 constexpr auto gControlToggleFastMovement = TMarioGamePad::START;
 constexpr auto gControlXYZMoveUp          = TMarioGamePad::A;
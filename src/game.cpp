@@ -6,20 +6,25 @@
 #include <SMS/raw_fn.hxx>
 
 #include "libs/container.hxx"
+#include "libs/frame_allocator.hxx"
 #include "libs/global_vector.hxx"
+#include "libs/profiler.hxx"
 #include "libs/string.hxx"
 
 #include "game.hxx"
 #include "module.hxx"
 
+#include "p_module.hxx"
+#include "p_profiler.hxx"
+
 using namespace BetterSMS;
 
 static size_t sMaxShines = 120;
-static TGlobalVector<Game::InitCallback> sGameInitCBs;
-static TGlobalVector<Game::BootCallback> sGameBootCBs;
-static TGlobalVector<Game::LoopCallback> sGameLoopCBs;
-static TGlobalVector<Game::DrawCallback> sGameDrawCBs;
-static TGlobalVector<Game::ChangeCallback> sGameChangeCBs;
+static TGlobalVector<TModuleCallback<Game::InitCallback>> sGameInitCBs;
+static TGlobalVector<TModuleCallback<Game::BootCallback>> sGameBootCBs;
+static TGlobalVector<TModuleCallback<Game::LoopCallback>> sGameLoopCBs;
+static TGlobalVector<TModuleCallback<Game::DrawCallback>> sGameDrawCBs;
+static TGlobalVector<TModuleCallback<Game::ChangeCallback>> sGameChangeCBs;
 
 BETTER_SMS_FOR_EXPORT size_t BetterSMS::Game::getMaxShines() { return sMaxShines; }
 
@@ -31,36 +36,37 @@ BETTER_SMS_FOR_EXPORT void BetterSMS::Game::setMaxShines(size_t maxShines) {
 
 // Register a function to be called on game init
 BETTER_SMS_FOR_EXPORT bool BetterSMS::Game::addInitCallback(InitCallback cb) {
-    sGameInitCBs.push_back(cb);
+    sGameInitCBs.push_back(makeModuleCallback(cb, "Game::Init"));
     return true;
 }
 
 // Register a function to be called on game boot
 BETTER_SMS_FOR_EXPORT bool BetterSMS::Game::addBootCallback(BootCallback cb) {
-    sGameBootCBs.push_back(cb);
+    sGameBootCBs.push_back(makeModuleCallback(cb, "Game::Boot"));
     return true;
 }
 
 // Register a function to be called every game loop
 BETTER_SMS_FOR_EXPORT bool BetterSMS::Game::addLoopCallback(LoopCallback cb) {
-    sGameLoopCBs.push_back(cb);
+    sGameLoopCBs.push_back(makeModuleCallback(cb, "Game::Loop"));
     return true;
 }
 
 // Register a function to be called after the game draws graphics
 BETTER_SMS_FOR_EXPORT bool BetterSMS::Game::addPostDrawCallback(DrawCallback cb) {
-    sGameDrawCBs.push_back(cb);
+    sGameDrawCBs.push_back(makeModuleCallback(cb, "Game::PostDraw"));
     return true;
 }
 
 // Register a function to be called on game context change
 BETTER_SMS_FOR_EXPORT bool BetterSMS::Game::addChangeCallback(ChangeCallback cb) {
-    sGameChangeCBs.push_back(cb);
+    sGameChangeCBs.push_back(makeModuleCallback(cb, "Game::Change"));
     return true;
 }
 
 // extern -> custom app proc
 void gameInitCallbackHandler(TApplication *app) {
+    BETTERSMS_PROFILE_ZONE("Game::Init");
     for (auto &item : sGameInitCBs) {
         item(&gpApplication);
     }
@@ -68,6 +74,7 @@ void gameInitCallbackHandler(TApplication *app) {
 
 // extern -> custom app proc
 void gameBootCallbackHandler(TApplication *app) {
+    BETTERSMS_PROFILE_ZONE("Game::Boot");
     for (auto &item : sGameBootCBs) {
         item(&gpApplication);
     }
@@ -80,8 +87,16 @@ extern void drawDebugCallbacks(TApplication *, const J2DOrthoGraph *);
 
 // extern -> custom app proc
 s32 gameLoopCallbackHandler(JDrama::TDirector *director) {
-    for (auto &item : sGameLoopCBs) {
-        item(&gpApplication);
+    // Nothing allocated from the frame arena survives into the next frame
+    Memory::getFrameArena().reset();
+    updateProfiler();
+    updateCallbackCosts();
+
+    {
+        BETTERSMS_PROFILE_ZONE("Game::Loop");
+        for (auto &item : sGameLoopCBs) {
+            item(&gpApplication);
+        }
     }
 
     updateStageCallbacks(&gpApplication);
@@ -111,6 +126,7 @@ void gameDrawCallbackHandler() {
         drawDebugCallbacks(&gpApplication, &ortho);
 
         {
+            BETTERSMS_PROFILE_ZONE("Game::PostDraw");
             for (auto &item : sGameDrawCBs) {
                 item(&gpApplication, &ortho);
             }
@@ -123,8 +139,11 @@ extern void exitStageCallbacks(TApplication *);
 
 // extern -> custom app proc
 void gameChangeCallbackHandler(TApplication *app) {
-    for (auto &item : sGameChangeCBs) {
-        item(&gpApplication);
+    {
+        BETTERSMS_PROFILE_ZONE("Game::Change");
+        for (auto &item : sGameChangeCBs) {
+            item(&gpApplication);
+        }
     }
 
     exitStageCallbacks(app);
@@ -1,15 +1,281 @@
 #include <Dolphin/OS.h>
 #include <Dolphin/printf.h>
 #include <Dolphin/stdarg.h>
+#include <Dolphin/string.h>
 #include <SMS/macros.h>
 
+#include "libs/lock.hxx"
 #include "logging.hxx"
 #include "module.hxx"
 
+#include "p_logging.hxx"
+
+using namespace BetterSMS;
+
+// Callers format into a fixed queue with interrupts held off only for the copy, and a low
+// priority thread prints the queue. Nothing on the caller's side waits on OSReport or a lock
+// that OSReport may hold.
+
+#define LOG_QUEUE_SIZE  64  // Must be a power of two
+#define LOG_LINE_SIZE   128
+#define LOG_RATE_SLOTS  32
+#define LOG_RATE_PROBES 4  // Slots a format string may land in
+#define LOG_RATE_LIMIT  8  // Messages per format string per second
+#define LOG_THREAD_PRIO 31
+
+struct LogEntry {
+    u32 mHash;
+    u16 mRepeats;
+    Console::LogLevel mLevel;
+    char mText[LOG_LINE_SIZE];
+};
+
+struct LogRateSlot {
+    const char *mFormat;
+    OSTick mWindowStart;
+    u16 mCount;
+    u16 mSuppressed;
+};
+
+static LogEntry sLogQueue[LOG_QUEUE_SIZE];
+static u32 sLogHead    = 0;
+static u32 sLogTail    = 0;
+static u32 sLogDropped = 0;
+
+static LogRateSlot sLogRates[LOG_RATE_SLOTS];
+
+static char sLogHistory[LOG_HISTORY_LINES][LOG_HISTORY_WIDTH];
+static u32 sLogHistoryHead = 0;
+
+static u8 SMS_ALIGN(32) sLogThreadStack[0x2000];
+static OSThread sLogThread;
+static OSThreadQueue sLogThreadQueue;
+static bool sIsLogThreadStarted = false;
+
+static const char *sLogLevelPrefixes[] = {"", "", "[WARNING] ", "[CRITICAL] "};
+
+static u32 hashLogText(const char *text) {
+    u32 hash = 0x811C9DC5;
+    for (; *text; ++text) {
+        hash ^= static_cast<u8>(*text);
+        hash *= 0x01000193;
+    }
+    return hash;
+}
+
+static bool isLogRateExpired(const LogRateSlot &slot, OSTick now) {
+    return OSDiffTick(now, slot.mWindowStart) > static_cast<s32>(OS_TIMER_CLOCK);
+}
+
+// A format string that fires more than LOG_RATE_LIMIT times in a second has the rest of its
+// lines for that second dropped, and the next line it logs reports how many were lost.
+// A slot still counting for another format is never taken over, if every slot a format may
+// land in is busy it just isn't limited. An expired slot handed to another format reports the
+// previous format's tally instead, `suppressedFormatOut` names whose tally it is
+static bool checkLogRate(const char *format, const char *&suppressedFormatOut,
+                         u16 &suppressedOut) {
+    TAtomicGuard guard;
+
+    const u32 home   = reinterpret_cast<u32>(format) >> 2;
+    const OSTick now = OSGetTick();
+
+    LogRateSlot *slot = nullptr;
+    LogRateSlot *free = nullptr;
+    for (u32 i = 0; i < LOG_RATE_PROBES; ++i) {
+        LogRateSlot &probe = sLogRates[(home + i) % LOG_RATE_SLOTS];
+        if (probe.mFormat == format) {
+            slot = &probe;
+            break;
+        }
+        if (!free && (!probe.mFormat || isLogRateExpired(probe, now)))
+            free = &probe;
+    }
+
+    suppressedFormatOut = nullptr;
+    suppressedOut       = 0;
+
+    if (!slot) {
+        if (!free)
+            return true;
+        slot = free;
+    } else if (!isLogRateExpired(*slot, now)) {
+        if (slot->mCount >= LOG_RATE_LIMIT) {
+            slot->mSuppressed += 1;
+            return false;
+        }
+        slot->mCount += 1;
+        return true;
+    }
+
+    if (slot->mFormat && slot->mSuppressed > 0) {
+        suppressedFormatOut = slot->mFormat;
+        suppressedOut       = slot->mSuppressed;
+    }
+
+    slot->mFormat      = format;
+    slot->mWindowStart = now;
+    slot->mCount       = 1;
+    slot->mSuppressed  = 0;
+    return true;
+}
+
+static void pushLogEntry(Console::LogLevel level, const char *text) {
+    const u32 hash = hashLogText(text);
+
+    {
+        TAtomicGuard guard;
+
+        // Repeats of a line that hasn't been printed yet only bump its counter
+        if (sLogHead != sLogTail) {
+            LogEntry &last = sLogQueue[(sLogHead - 1) & (LOG_QUEUE_SIZE - 1)];
+            if (last.mHash == hash && last.mLevel == level && last.mRepeats < 0xFFFF) {
+                last.mRepeats += 1;
+                return;
+            }
+        }
+
+        if (sLogHead - sLogTail >= LOG_QUEUE_SIZE) {
+            sLogDropped += 1;
+            return;
+        }
+
+        LogEntry &entry = sLogQueue[sLogHead & (LOG_QUEUE_SIZE - 1)];
+        entry.mHash     = hash;
+        entry.mRepeats  = 0;
+        entry.mLevel    = level;
+        strncpy(entry.mText, text, LOG_LINE_SIZE - 1);
+        entry.mText[LOG_LINE_SIZE - 1] = '\0';
+
+        sLogHead += 1;
+    }
+
+    if (sIsLogThreadStarted)
+        OSWakeupThread(&sLogThreadQueue);
+}
+
+static void queueLog(Console::LogLevel level, const char *msg, va_list vargs) {
+    const char *suppressedFormat;
+    u16 suppressed;
+    if (!checkLogRate(msg, suppressedFormat, suppressed))
+        return;
+
+    char text[LOG_LINE_SIZE];
+
+    if (suppressed > 0) {
+        snprintf(text, sizeof(text), "[LOG] Dropped %u repeats of \"%.48s\"\n", suppressed,
+                 suppressedFormat);
+        pushLogEntry(Console::LogLevel::WARNING, text);
+    }
+
+    const char *prefix        = sLogLevelPrefixes[static_cast<u8>(level)];
+    const size_t prefixLength = strlen(prefix);
+    memcpy(text, prefix, prefixLength);
+    vsnprintf(text + prefixLength, sizeof(text) - prefixLength, msg, vargs);
+
+    pushLogEntry(level, text);
+}
+
+static void recordLogHistory(const char *text) {
+    char *line = sLogHistory[sLogHistoryHead % LOG_HISTORY_LINES];
+
+    size_t length = 0;
+    while (length < LOG_HISTORY_WIDTH - 1 && text[length] && text[length] != '\n') {
+        line[length] = text[length];
+        length += 1;
+    }
+    line[length] = '\0';
+
+    sLogHistoryHead += 1;
+}
+
+static bool popLogEntry(LogEntry &out, u32 &droppedOut) {
+    TAtomicGuard guard;
+
+    droppedOut  = sLogDropped;
+    sLogDropped = 0;
+
+    if (sLogHead == sLogTail)
+        return false;
+
+    out = sLogQueue[sLogTail & (LOG_QUEUE_SIZE - 1)];
+    sLogTail += 1;
+
+    recordLogHistory(out.mText);
+    return true;
+}
+
+static void drainLogQueue() {
+    LogEntry entry;
+    u32 dropped;
+
+    while (true) {
+        const bool hasEntry = popLogEntry(entry, dropped);
+
+        if (dropped > 0)
+            OSReport("[LOG] Dropped %lu messages, the queue was full\n", dropped);
+
+        if (!hasEntry)
+            break;
+
+        OSReport("%s", entry.mText);
+        if (entry.mRepeats > 0)
+            OSReport("[LOG] ^ Repeated %u more times\n", entry.mRepeats);
+    }
+}
+
+static void *logThreadMain(void *param) {
+    while (true) {
+        {
+            TAtomicGuard guard;
+            while (sLogHead == sLogTail && sLogDropped == 0) {
+                OSSleepThread(&sLogThreadQueue);
+            }
+        }
+
+        drainLogQueue();
+    }
+
+    return nullptr;
+}
+
+void initConsoleLog() {
+    if (sIsLogThreadStarted)
+        return;
+
+    OSInitThreadQueue(&sLogThreadQueue);
+    OSCreateThread(&sLogThread, logThreadMain, nullptr,
+                   sLogThreadStack + sizeof(sLogThreadStack), sizeof(sLogThreadStack),
+                   LOG_THREAD_PRIO, OS_THREAD_ATTR_DETACH);
+    OSResumeThread(&sLogThread);
+
+    sIsLogThreadStarted = true;
+}
+
+size_t copyLogHistory(char *dst, size_t size) {
+    if (size == 0)
+        return 0;
+
+    TAtomicGuard guard;
+
+    const u32 count = sLogHistoryHead < LOG_HISTORY_LINES ? sLogHistoryHead : LOG_HISTORY_LINES;
+
+    size_t length = 0;
+    for (u32 i = sLogHistoryHead - count; i != sLogHistoryHead; ++i) {
+        const int written =
+            snprintf(dst + length, size - length, "%s\n", sLogHistory[i % LOG_HISTORY_LINES]);
+        if (written < 0 || static_cast<size_t>(written) >= size - length)
+            break;
+        length += written;
+    }
+
+    dst[length] = '\0';
+    return length;
+}
+
 BETTER_SMS_FOR_EXPORT void BetterSMS::Console::log(const char *msg, ...) {
     va_list vargs;
     va_start(vargs, msg);
-    OSReport(msg, vargs);
+    queueLog(LogLevel::INFO, msg, vargs);
     va_end(vargs);
 }
 
@@ -19,7 +285,7 @@ BETTER_SMS_FOR_EXPORT void BetterSMS::Console::hardwareLog(const char *msg, ...)
 
     va_list vargs;
     va_start(vargs, msg);
-    OSReport(msg, vargs);
+    queueLog(LogLevel::INFO, msg, vargs);
     va_end(vargs);
 }
 
@@ -29,7 +295,7 @@ BETTER_SMS_FOR_EXPORT void BetterSMS::Console::emulatorLog(const char *msg, ...)
 
     va_list vargs;
     va_start(vargs, msg);
-    OSReport(msg, vargs);
+    queueLog(LogLevel::INFO, msg, vargs);
     va_end(vargs);
 }
 
@@ -39,6 +305,18 @@ BETTER_SMS_FOR_EXPORT void BetterSMS::Console::debugLog(const char *msg, ...) {
 
     va_list vargs;
     va_start(vargs, msg);
-    OSReport(msg, vargs);
+    queueLog(LogLevel::VERBOSE, msg, vargs);
     va_end(vargs);
-}
\ No newline at end of file
+}
+
+BETTER_SMS_FOR_EXPORT void BetterSMS::Console::report(LogLevel level, const char *msg, ...) {
+    if (level == LogLevel::VERBOSE && !BetterSMS::isDebugMode())
+        return;
+
+    va_list vargs;
+    va_start(vargs, msg);
+    queueLog(level, msg, vargs);
+    va_end(vargs);
+}
+
+BETTER_SMS_FOR_EXPORT void BetterSMS::Console::flush() { drainLogQueue(); }
@@ -4,9 +4,14 @@
 #include <JSystem/JKernel/JKRHeap.hxx>
 #include <SMS/macros.h>
 
+#include "libs/frame_allocator.hxx"
+#include "libs/lock.hxx"
+#include "libs/object_pool.hxx"
 #include "memory.hxx"
 #include "module.hxx"
 
+#include "p_memory.hxx"
+
 BETTER_SMS_FOR_EXPORT void BetterSMS::Cache::flush(void *addr, size_t size) {
     DCFlushRange(addr, size);
     ICInvalidateRange(addr, size);
@@ -33,29 +38,257 @@ BETTER_SMS_FOR_EXPORT void BetterSMS::Cache::disable() {
     ICDisable();
 }
 
+// -- ALLOCATION TRACKING -- //
+//
+// Live blocks are kept in an open addressed side table keyed by address, only while debug
+// mode is on. Removal shifts the following run back so lookups never need tombstones.
+
+#define MAX_TRACKED_ALLOCATIONS 1024
+
+struct TrackedAllocation {
+    const void *mPtr;
+    const void *mSite;
+    JKRHeap *mHeap;
+    u32 mSize : 24;
+    u32 mStage : 8;
+};
+
+static TrackedAllocation sTrackedAllocations[MAX_TRACKED_ALLOCATIONS];
+static size_t sTrackedCount  = 0;
+static u32 sUntrackedCount   = 0;
+static u8 sTrackedStage      = 0;
+static StageLeakReport sLastStageLeaks;
+
+static size_t getTrackedSlot(const void *ptr) {
+    u32 x = reinterpret_cast<u32>(ptr) >> 3;
+    x     = ((x >> 16) ^ x) * 0x45d9f3b;
+    return ((x >> 16) ^ x) & (MAX_TRACKED_ALLOCATIONS - 1);
+}
+
+BETTER_SMS_FOR_EXPORT void BetterSMS::Memory::trackAllocation(const void *ptr, size_t size,
+                                                              JKRHeap *heap, const void *site) {
+    if (!ptr || !BetterSMS::isDebugMode())
+        return;
+
+    TAtomicGuard guard;
+
+    // Keep a quarter free so probe runs stay short
+    if (sTrackedCount >= (MAX_TRACKED_ALLOCATIONS / 4) * 3) {
+        sUntrackedCount += 1;
+        return;
+    }
+
+    size_t slot = getTrackedSlot(ptr);
+    while (sTrackedAllocations[slot].mPtr) {
+        slot = (slot + 1) & (MAX_TRACKED_ALLOCATIONS - 1);
+    }
+
+    TrackedAllocation &entry = sTrackedAllocations[slot];
+    entry.mPtr               = ptr;
+    entry.mSite              = site;
+    entry.mHeap              = heap;
+    entry.mSize              = size;
+    entry.mStage             = sTrackedStage;
+    sTrackedCount += 1;
+}
+
+// Entries only ever move to an earlier slot (wrapping), callers walking the table forward
+// have to look at `slot` again after this
+static void removeTrackedSlot(size_t slot) {
+    // Shift back every following entry that would no longer be reachable
+    size_t hole = slot;
+    for (size_t next = (hole + 1) & (MAX_TRACKED_ALLOCATIONS - 1);
+         sTrackedAllocations[next].mPtr; next = (next + 1) & (MAX_TRACKED_ALLOCATIONS - 1)) {
+        const size_t home = getTrackedSlot(sTrackedAllocations[next].mPtr);
+        const bool isHomeBetween =
+            hole <= next ? (hole < home && home <= next) : (hole < home || home <= next);
+        if (isHomeBetween)
+            continue;
+
+        sTrackedAllocations[hole] = sTrackedAllocations[next];
+        hole                      = next;
+    }
+
+    sTrackedAllocations[hole].mPtr = nullptr;
+    sTrackedCount -= 1;
+}
+
+BETTER_SMS_FOR_EXPORT void BetterSMS::Memory::trackFree(const void *ptr) {
+    if (!ptr || sTrackedCount == 0)
+        return;
+
+    TAtomicGuard guard;
+
+    size_t slot = getTrackedSlot(ptr);
+    while (sTrackedAllocations[slot].mPtr != ptr) {
+        if (!sTrackedAllocations[slot].mPtr)
+            return;
+        slot = (slot + 1) & (MAX_TRACKED_ALLOCATIONS - 1);
+    }
+
+    removeTrackedSlot(slot);
+}
+
+BETTER_SMS_FOR_EXPORT void BetterSMS::Memory::dumpAllocations() {
+    OSReport("ptr,size,heap,site,stage\n");
+    for (size_t i = 0; i < MAX_TRACKED_ALLOCATIONS; ++i) {
+        const TrackedAllocation &entry = sTrackedAllocations[i];
+        if (!entry.mPtr)
+            continue;
+        OSReport("%p,%lu,%p,%p,%u\n", entry.mPtr, entry.mSize, entry.mHeap, entry.mSite,
+                 entry.mStage);
+    }
+}
+
+void getTrackedTotals(size_t &bytesOut, u32 &blocksOut, u32 &untrackedOut) {
+    bytesOut = 0;
+    for (size_t i = 0; i < MAX_TRACKED_ALLOCATIONS; ++i) {
+        if (sTrackedAllocations[i].mPtr)
+            bytesOut += sTrackedAllocations[i].mSize;
+    }
+    blocksOut    = sTrackedCount;
+    untrackedOut = sUntrackedCount;
+}
+
+size_t getAllocationSiteStats(AllocationSiteStat *out, size_t maxCount) {
+    AllocationSiteStat sites[MAX_ALLOCATION_SITES];
+    size_t siteCount = 0;
+
+    for (size_t i = 0; i < MAX_TRACKED_ALLOCATIONS; ++i) {
+        const TrackedAllocation &entry = sTrackedAllocations[i];
+        if (!entry.mPtr)
+            continue;
+
+        size_t j = 0;
+        while (j < siteCount && sites[j].mSite != entry.mSite) {
+            ++j;
+        }
+
+        if (j == siteCount) {
+            if (siteCount == MAX_ALLOCATION_SITES)
+                continue;
+            sites[siteCount++] = {entry.mSite, 0, 0};
+        }
+
+        sites[j].mBytes += entry.mSize;
+        sites[j].mBlocks += 1;
+    }
+
+    // Partial selection sort, only the top few are ever shown
+    const size_t count = siteCount < maxCount ? siteCount : maxCount;
+    for (size_t i = 0; i < count; ++i) {
+        size_t best = i;
+        for (size_t j = i + 1; j < siteCount; ++j) {
+            if (sites[j].mBytes > sites[best].mBytes)
+                best = j;
+        }
+
+        AllocationSiteStat tmp = sites[i];
+        sites[i]               = sites[best];
+        sites[best]            = tmp;
+        out[i]                 = sites[i];
+    }
+
+    return count;
+}
+
+const StageLeakReport &getLastStageLeakReport() { return sLastStageLeaks; }
+
+// Whatever this stage allocated outside of its own heap and never gave back
+BETTER_SMS_FOR_CALLBACK void diffStageAllocations(TApplication *app) {
+    if (!BetterSMS::isDebugMode())
+        return;
+
+    sLastStageLeaks = {0, 0};
+
+    OSReport("ptr,size,heap,site\n");
+    for (size_t i = 0; i < MAX_TRACKED_ALLOCATIONS; ++i) {
+        const TrackedAllocation &entry = sTrackedAllocations[i];
+        if (!entry.mPtr || entry.mStage != sTrackedStage || entry.mHeap == JKRHeap::sCurrentHeap)
+            continue;
+
+        sLastStageLeaks.mBytes += entry.mSize;
+        sLastStageLeaks.mBlocks += 1;
+        OSReport("%p,%lu,%p,%p\n", entry.mPtr, entry.mSize, entry.mHeap, entry.mSite);
+    }
+
+    OSReport("Stage leak diff: %lu bytes in %lu blocks\n", sLastStageLeaks.mBytes,
+             sLastStageLeaks.mBlocks);
+
+    // The stage heap is about to be torn down as a whole, its blocks are gone either way and
+    // their addresses get handed out again next stage
+    {
+        TAtomicGuard guard;
+        for (size_t i = 0; i < MAX_TRACKED_ALLOCATIONS;) {
+            const TrackedAllocation &entry = sTrackedAllocations[i];
+            if (!entry.mPtr || entry.mHeap != JKRHeap::sCurrentHeap) {
+                ++i;
+                continue;
+            }
+            removeTrackedSlot(i);
+        }
+    }
+
+    sTrackedStage += 1;
+}
+
+static void *trackedAlloc(JKRHeap *heap, size_t size, size_t alignment, const void *site) {
+    void *obj = JKRHeap::alloc(size, alignment, heap);
+    BetterSMS::Memory::trackAllocation(obj, size, heap, site);
+    return obj;
+}
+
 BETTER_SMS_FOR_EXPORT void *BetterSMS::Memory::malloc(const size_t size, const size_t alignment) {
-    return JKRHeap::sCurrentHeap->alloc(size, alignment);
+    return trackedAlloc(JKRHeap::sCurrentHeap, size, alignment, __builtin_return_address(0));
 }
 
 BETTER_SMS_FOR_EXPORT void *BetterSMS::Memory::hmalloc(JKRHeap *heap, const size_t size,
                                                        const size_t alignment) {
-    return JKRHeap::alloc(size, alignment, heap);
+    return trackedAlloc(heap, size, alignment, __builtin_return_address(0));
 }
 
 BETTER_SMS_FOR_EXPORT void *BetterSMS::Memory::calloc(const size_t size, const size_t alignment) {
-    void *obj = malloc(size, alignment);
+    void *obj =
+        trackedAlloc(JKRHeap::sCurrentHeap, size, alignment, __builtin_return_address(0));
     memset(obj, 0, size);
     return obj;
 }
 
 BETTER_SMS_FOR_EXPORT void *BetterSMS::Memory::hcalloc(JKRHeap *heap, const size_t size,
                                                        const size_t alignment) {
-    void *obj = hmalloc(heap, size, alignment);
+    void *obj = trackedAlloc(heap, size, alignment, __builtin_return_address(0));
     memset(obj, 0, size);
     return obj;
 }
 
-BETTER_SMS_FOR_EXPORT void BetterSMS::Memory::free(const void *ptr) { delete (u8 *)ptr; }
+BETTER_SMS_FOR_EXPORT void BetterSMS::Memory::free(const void *ptr) {
+    trackFree(ptr);
+    delete (u8 *)ptr;
+}
+
+static u8 SMS_ALIGN(32) sFrameArenaBuffer[0x2000];
+static TFrameArena sFrameArena(sFrameArenaBuffer, sizeof(sFrameArenaBuffer));
+
+BETTER_SMS_FOR_EXPORT TFrameArena &BetterSMS::Memory::getFrameArena() { return sFrameArena; }
+
+// Intrusive through TObjectPoolBase so pools constructed during static init can register
+static TObjectPoolBase *sObjectPools = nullptr;
+
+BETTER_SMS_FOR_EXPORT void BetterSMS::Memory::registerObjectPool(TObjectPoolBase *pool) {
+    pool->mNextPool = sObjectPools;
+    sObjectPools    = pool;
+}
+
+BETTER_SMS_FOR_EXPORT void BetterSMS::Memory::deregisterObjectPool(TObjectPoolBase *pool) {
+    for (TObjectPoolBase **link = &sObjectPools; *link; link = &(*link)->mNextPool) {
+        if (*link == pool) {
+            *link = pool->mNextPool;
+            return;
+        }
+    }
+}
+
+BETTER_SMS_FOR_EXPORT TObjectPoolBase *BetterSMS::Memory::getObjectPools() { return sObjectPools; }
 
 BETTER_SMS_FOR_EXPORT u32 *BetterSMS::PowerPC::getBranchDest(u32 *bAddr) {
     s32 offset;
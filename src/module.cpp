@@ -15,6 +15,7 @@
 #include "debug.hxx"
 #include "game.hxx"
 #include "libs/optional.hxx"
+#include "libs/profiler.hxx"
 #include "loading.hxx"
 #include "logging.hxx"
 #include "memory.hxx"
@@ -79,6 +80,7 @@ bool BetterSMS::isModuleRegistered(const char *key) {
 
 bool BetterSMS::registerModule(const ModuleInfo &info) {
     if (isModuleRegistered(info.mName)) {
+        BetterSMS::Console::flush();
         OSPanic(__FILE__, __LINE__,
                 "Module \"%s\" is trying to register under the name \"%s\", which is "
                 "already taken!",
@@ -86,9 +88,126 @@ bool BetterSMS::registerModule(const ModuleInfo &info) {
         return false;
     }
     gModuleInfos.push_back(info);
+    invalidateSettingsGroups();
+    setCallbackOwner(info.mName);
     return true;
 }
 
+// -- CALLBACK COSTS -- //
+//
+// Every callback registered through the Game, Stage, Debug and Player hooks times itself
+// into a slot here. Slots are summed per owning module and published over a rolling window.
+
+#define CALLBACK_COST_WINDOW 60
+
+static CallbackCostInfo sCallbackCosts[MAX_COSTED_CALLBACKS];
+static size_t sCallbackCostCount = 0;
+
+static ModuleCostInfo sModuleCosts[MAX_COSTED_MODULES];
+static size_t sModuleCostCount = 0;
+
+static s16 sCallbackOwner     = -1;
+static u32 sCallbackCostFrame = 0;
+
+static s16 getModuleCostSlot(const char *key) {
+    for (size_t i = 0; i < sModuleCostCount; ++i) {
+        if (strcmp(sModuleCosts[i].mName, key) == 0)
+            return i;
+    }
+
+    if (sModuleCostCount >= MAX_COSTED_MODULES)
+        return -1;
+
+    ModuleCostInfo &cost = sModuleCosts[sModuleCostCount];
+    memset(&cost, 0, sizeof(cost));
+    cost.mName = key;
+    return sModuleCostCount++;
+}
+
+void BetterSMS::setCallbackOwner(const char *key) {
+    sCallbackOwner = key ? getModuleCostSlot(key) : -1;
+}
+
+bool BetterSMS::getModuleFrameCost(const char *key, ModuleFrameCost &out) {
+    for (size_t i = 0; i < sModuleCostCount; ++i) {
+        if (strcmp(sModuleCosts[i].mName, key) == 0) {
+            out = sModuleCosts[i].mCost;
+            return true;
+        }
+    }
+    return false;
+}
+
+s16 registerCallbackCost(const void *callback, const char *hook) {
+    if (sCallbackCostCount >= MAX_COSTED_CALLBACKS)
+        return -1;
+
+    CallbackCostInfo &cost = sCallbackCosts[sCallbackCostCount];
+    memset(&cost, 0, sizeof(cost));
+    cost.mCallback = callback;
+    cost.mHook     = hook;
+    cost.mModule   = sCallbackOwner;
+    return sCallbackCostCount++;
+}
+
+void recordCallbackCost(s16 slot, u32 ticks) {
+    if (slot < 0)
+        return;
+    sCallbackCosts[slot].mFrameTicks += ticks;
+}
+
+void updateCallbackCosts() {
+    const bool isWindowDone = ++sCallbackCostFrame >= CALLBACK_COST_WINDOW;
+
+    for (size_t i = 0; i < sCallbackCostCount; ++i) {
+        CallbackCostInfo &cost = sCallbackCosts[i];
+
+        if (cost.mModule >= 0)
+            sModuleCosts[cost.mModule].mFrameTicks += cost.mFrameTicks;
+
+        cost.mLastTicks = cost.mFrameTicks;
+        cost.mWindowSum += cost.mFrameTicks;
+        cost.mWindowPeak = Max(cost.mWindowPeak, cost.mFrameTicks);
+        cost.mFrameTicks = 0;
+
+        if (isWindowDone) {
+            cost.mAvgTicks   = cost.mWindowSum / CALLBACK_COST_WINDOW;
+            cost.mPeakTicks  = cost.mWindowPeak;
+            cost.mWindowSum  = 0;
+            cost.mWindowPeak = 0;
+        }
+    }
+
+    for (size_t i = 0; i < sModuleCostCount; ++i) {
+        ModuleCostInfo &cost = sModuleCosts[i];
+
+        cost.mCost.mLastTicks = cost.mFrameTicks;
+        cost.mWindowSum += cost.mFrameTicks;
+        cost.mWindowPeak = Max(cost.mWindowPeak, cost.mFrameTicks);
+        cost.mFrameTicks = 0;
+
+        if (isWindowDone) {
+            cost.mCost.mAvgTicks  = cost.mWindowSum / CALLBACK_COST_WINDOW;
+            cost.mCost.mPeakTicks = cost.mWindowPeak;
+            cost.mWindowSum       = 0;
+            cost.mWindowPeak      = 0;
+        }
+    }
+
+    if (isWindowDone)
+        sCallbackCostFrame = 0;
+}
+
+size_t getCallbackCosts(const CallbackCostInfo *&costsOut) {
+    costsOut = sCallbackCosts;
+    return sCallbackCostCount;
+}
+
+size_t getModuleCosts(const ModuleCostInfo *&costsOut) {
+    costsOut = sModuleCosts;
+    return sModuleCostCount;
+}
+
 // ================================= //
 
 using namespace BetterSMS;
@@ -116,6 +235,24 @@ extern void updateFluddNozzle(TApplication *);
 
 extern void drawMonitor(TApplication *, const J2DOrthoGraph *);
 extern void resetMonitor(TApplication *);
+extern void initMemoryMonitor(TApplication *);
+extern void updateMemoryMonitor(TApplication *);
+extern void drawMemoryMonitor(TApplication *, const J2DOrthoGraph *);
+extern void diffStageAllocations(TApplication *);
+
+extern void initProfiler(TApplication *);
+extern void initProfilerMonitor(TApplication *);
+extern void updateProfilerMonitor(TApplication *);
+extern void drawProfilerMonitor(TApplication *, const J2DOrthoGraph *);
+
+extern void initModuleCostMonitor(TApplication *);
+extern void updateModuleCostMonitor(TApplication *);
+extern void drawModuleCostMonitor(TApplication *, const J2DOrthoGraph *);
+
+extern void initConsoleLog();
+extern void initLogViewMonitor(TApplication *);
+extern void updateLogViewMonitor(TApplication *);
+extern void drawLogViewMonitor(TApplication *, const J2DOrthoGraph *);
 
 extern void initFPSMonitor(TApplication *);
 extern void updateFPSMonitor(TApplication *);
@@ -179,6 +316,9 @@ extern void forceValidRidingAnimation(TMario *player, bool isMario);
 
 // MUSIC
 extern void stopMusicOnExitStage(TApplication *app);
+extern void initStreamIndex(TApplication *app);
+extern void initSoftwareMusic(TApplication *app);
+extern void updateSoftwareMusic(TApplication *app);
 extern void initStreamInfo(TApplication *app);
 extern void printStreamInfo(TApplication *app, const J2DOrthoGraph *graph);
 
@@ -200,12 +340,16 @@ extern void resetPlayerDatas(TMarDirector *application);
 extern void initAutoSaveIcon(TApplication *);
 extern void updateAutoSaveIcon(TApplication *);
 extern void drawAutoSaveIcon(TApplication *, const J2DOrthoGraph *);
+extern void processAutoSave(TApplication *);
 
 // STAGES
 extern void initAreaInfo();
+extern void invalidateStageParamsCache(TApplication *);
 extern void initializeMapObjWave(TMarDirector *director);
 
 extern void patches_staticResetter(TMarDirector *);
+extern void buildWallEdgeTable(TMarDirector *);
+extern void releaseWallEdgeTable(TApplication *);
 
 // TOOLBOX
 
@@ -225,6 +369,7 @@ void __cvt_ull_dbl();
 #endif  // __cplusplus
 
 static void initLib() {
+    initConsoleLog();
     makeExtendedObjDataTable();
     initLoadingScreen();
     initExtendedPlayerAnims();
@@ -233,9 +378,6 @@ static void initLib() {
 
     initializeTaskBuffers();
 
-    // Toolbox Listener
-    Game::addLoopCallback(processCurrentTask);
-
     // SETTINGS
     {
         sSettingsGroup.addSetting(&gBugFixesSetting);
@@ -266,6 +408,9 @@ static void initLib() {
         BetterSMS::registerModule(sBetterSMSInfo);
     }
 
+    // Toolbox Listener, registered after the module so its time is charged to the engine
+    Game::addLoopCallback(processCurrentTask);
+
     //
 
     // Set up application context handlers
@@ -287,6 +432,7 @@ static void initLib() {
 
     //// AUTO SAVE
     Game::addBootCallback(initAutoSaveIcon);
+    Game::addLoopCallback(processAutoSave);
     Game::addLoopCallback(updateAutoSaveIcon);
     Game::addPostDrawCallback(drawAutoSaveIcon);
 
@@ -340,6 +486,24 @@ static void initLib() {
     Debug::addDrawCallback(drawMonitor);
     Stage::addExitCallback(resetMonitor);
 
+    Debug::addInitCallback(initMemoryMonitor);
+    Debug::addUpdateCallback(updateMemoryMonitor);
+    Debug::addDrawCallback(drawMemoryMonitor);
+    Stage::addExitCallback(diffStageAllocations);
+
+    Debug::addInitCallback(initProfiler);
+    Debug::addInitCallback(initProfilerMonitor);
+    Debug::addUpdateCallback(updateProfilerMonitor);
+    Debug::addDrawCallback(drawProfilerMonitor);
+
+    Debug::addInitCallback(initModuleCostMonitor);
+    Debug::addUpdateCallback(updateModuleCostMonitor);
+    Debug::addDrawCallback(drawModuleCostMonitor);
+
+    Debug::addInitCallback(initLogViewMonitor);
+    Debug::addUpdateCallback(updateLogViewMonitor);
+    Debug::addDrawCallback(drawLogViewMonitor);
+
     Debug::addInitCallback(initFPSMonitor);
     Debug::addUpdateCallback(updateFPSMonitor);
     Debug::addDrawCallback(drawFPSMonitor);
@@ -355,6 +519,11 @@ static void initLib() {
     Stage::addInitCallback(resetDebugState);
 
     // Music
+    Game::addBootCallback(initStreamIndex);
+#if BETTER_SMS_SOFTWARE_MUSIC
+    Game::addBootCallback(initSoftwareMusic);
+    Game::addLoopCallback(updateSoftwareMusic);
+#endif
     Game::addChangeCallback(stopMusicOnExitStage);
     Debug::addInitCallback(initStreamInfo);
     Debug::addDrawCallback(printStreamInfo);
@@ -369,6 +538,7 @@ static void initLib() {
 
     Stage::addInitCallback(resetPlayerDatas);
     Stage::addInitCallback(initializeMapObjWave);
+    Stage::addExitCallback(invalidateStageParamsCache);
 
     Stage::addInitCallback(updateFPS);
     Stage::addUpdateCallback(updateFPS);
@@ -381,6 +551,8 @@ static void initLib() {
 
     // PATCHES
     Stage::addInitCallback(patches_staticResetter);
+    Stage::addInitCallback(buildWallEdgeTable);
+    Stage::addExitCallback(releaseWallEdgeTable);
 }
 
 static void destroyLib() {}
@@ -400,6 +572,9 @@ KURIBO_MODULE_BEGIN(BETTER_SMS_MODULE_NAME, BETTER_SMS_AUTHOR_NAME, BETTER_SMS_V
         KURIBO_EXPORT_AS(BetterSMS::isModuleRegistered, "isModuleRegistered__9BetterSMSFPCc");
         KURIBO_EXPORT_AS(BetterSMS::registerModule,
                          "registerModule__9BetterSMSFRCQ29BetterSMS10ModuleInfo");
+        KURIBO_EXPORT_AS(BetterSMS::setCallbackOwner, "setCallbackOwner__9BetterSMSFPCc");
+        KURIBO_EXPORT_AS(BetterSMS::getModuleFrameCost,
+                         "getModuleFrameCost__9BetterSMSFPCcRQ29BetterSMS15ModuleFrameCost");
         KURIBO_EXPORT_AS(BetterSMS::isGameEmulated, "isGameEmulated__9BetterSMSFv");
         KURIBO_EXPORT_AS(BetterSMS::isMusicBeingStreamed, "isMusicBeingStreamed__9BetterSMSFv");
         KURIBO_EXPORT_AS(BetterSMS::isMusicStreamingAllowed,
@@ -417,6 +592,10 @@ KURIBO_MODULE_BEGIN(BETTER_SMS_MODULE_NAME, BETTER_SMS_AUTHOR_NAME, BETTER_SMS_V
         KURIBO_EXPORT_AS(BetterSMS::getCollisionFixesSetting,
                          "getCollisionFixesSetting__9BetterSMSFv");
         KURIBO_EXPORT_AS(BetterSMS::triggerAutoSave, "triggerAutoSave__9BetterSMSFv");
+        KURIBO_EXPORT_AS(BetterSMS::isAutoSaveActive, "isAutoSaveActive__9BetterSMSFv");
+        KURIBO_EXPORT_AS(BetterSMS::getAutoSaveStage, "getAutoSaveStage__9BetterSMSFv");
+        KURIBO_EXPORT_AS(BetterSMS::addAutoSaveCallback,
+                         "addAutoSaveCallback__9BetterSMSFPFQ29BetterSMS13AutoSaveStagel_v");
 
         /* SETTINGS */
         KURIBO_EXPORT_AS(BetterSMS::areBugsPatched, "areBugsPatched__9BetterSMSFv");
@@ -431,6 +610,8 @@ KURIBO_MODULE_BEGIN(BETTER_SMS_MODULE_NAME, BETTER_SMS_AUTHOR_NAME, BETTER_SMS_V
             "getGroupName__Q29BetterSMS8SettingsFRCQ39BetterSMS8Settings13SettingsGroup");
         KURIBO_EXPORT_AS(BetterSMS::Settings::mountCard, "mountCard__Q29BetterSMS8SettingsFv");
         KURIBO_EXPORT_AS(BetterSMS::Settings::unmountCard, "unmountCard__Q29BetterSMS8SettingsFv");
+        KURIBO_EXPORT_AS(BetterSMS::Settings::requestUnlockCheck,
+                         "requestUnlockCheck__Q29BetterSMS8SettingsFv");
         KURIBO_EXPORT_AS(
             BetterSMS::Settings::loadSettingsGroup,
             "loadSettingsGroup__Q29BetterSMS8SettingsFRQ39BetterSMS8Settings13SettingsGroup");
@@ -463,6 +644,9 @@ KURIBO_MODULE_BEGIN(BETTER_SMS_MODULE_NAME, BETTER_SMS_AUTHOR_NAME, BETTER_SMS_V
         KURIBO_EXPORT_AS(BetterSMS::Console::emulatorLog, "emulatorLog__Q29BetterSMS7ConsoleFPCce");
         KURIBO_EXPORT_AS(BetterSMS::Console::hardwareLog, "hardwareLog__Q29BetterSMS7ConsoleFPCce");
         KURIBO_EXPORT_AS(BetterSMS::Console::debugLog, "debugLog__Q29BetterSMS7ConsoleFPCce");
+        KURIBO_EXPORT_AS(BetterSMS::Console::report,
+                         "report__Q29BetterSMS7ConsoleFQ39BetterSMS7Console8LogLevelPCce");
+        KURIBO_EXPORT_AS(BetterSMS::Console::flush, "flush__Q29BetterSMS7ConsoleFv");
 
         /* DEBUG */
         KURIBO_EXPORT_AS(BetterSMS::Debug::addInitCallback,
@@ -479,6 +663,22 @@ KURIBO_MODULE_BEGIN(BETTER_SMS_MODULE_NAME, BETTER_SMS_AUTHOR_NAME, BETTER_SMS_V
         KURIBO_EXPORT_AS(BetterSMS::Memory::hmalloc, "hmalloc__Q29BetterSMS6MemoryFP7JKRHeapUlUl");
         KURIBO_EXPORT_AS(BetterSMS::Memory::hcalloc, "hcalloc__Q29BetterSMS6MemoryFP7JKRHeapUlUl");
         KURIBO_EXPORT_AS(BetterSMS::Memory::free, "free__Q29BetterSMS6MemoryFPCv");
+        KURIBO_EXPORT_AS(BetterSMS::Memory::trackAllocation,
+                         "trackAllocation__Q29BetterSMS6MemoryFPCvUlP7JKRHeapPCv");
+        KURIBO_EXPORT_AS(BetterSMS::Memory::trackFree, "trackFree__Q29BetterSMS6MemoryFPCv");
+        KURIBO_EXPORT_AS(BetterSMS::Memory::dumpAllocations,
+                         "dumpAllocations__Q29BetterSMS6MemoryFv");
+        KURIBO_EXPORT_AS(BetterSMS::Memory::getFrameArena, "getFrameArena__Q29BetterSMS6MemoryFv");
+        KURIBO_EXPORT_AS(BetterSMS::Memory::registerObjectPool,
+                         "registerObjectPool__Q29BetterSMS6MemoryFP15TObjectPoolBase");
+        KURIBO_EXPORT_AS(BetterSMS::Memory::deregisterObjectPool,
+                         "deregisterObjectPool__Q29BetterSMS6MemoryFP15TObjectPoolBase");
+        KURIBO_EXPORT_AS(BetterSMS::Memory::getObjectPools, "getObjectPools__Q29BetterSMS6MemoryFv");
+        KURIBO_EXPORT_AS(BetterSMS::Profiler::beginZone,
+                         "beginZone__Q29BetterSMS8ProfilerFPCc");
+        KURIBO_EXPORT_AS(BetterSMS::Profiler::endZone, "endZone__Q29BetterSMS8ProfilerFv");
+        KURIBO_EXPORT_AS(BetterSMS::Profiler::dumpChromeTrace,
+                         "dumpChromeTrace__Q29BetterSMS8ProfilerFUl");
         KURIBO_EXPORT_AS(BetterSMS::PowerPC::getBranchDest,
                          "getBranchDest__Q29BetterSMS7PowerPCFPUl");
         KURIBO_EXPORT_AS(BetterSMS::PowerPC::writeU8, "writeU8__Q29BetterSMS7PowerPCFPUcUc");
@@ -496,7 +696,14 @@ KURIBO_MODULE_BEGIN(BETTER_SMS_MODULE_NAME, BETTER_SMS_AUTHOR_NAME, BETTER_SMS_V
         /* PLAYER */
         KURIBO_EXPORT_AS(BetterSMS::Player::getRegisteredData,
                          "getRegisteredData__Q29BetterSMS6PlayerFP6TMarioPCc");
-        KURIBO_EXPORT_AS(BetterSMS::Player::getData, "getData__Q29BetterSMS6PlayerFP6TMario");
+        KURIBO_EXPORT_AS(
+            static_cast<Player::TPlayerData *(*)(TMario *)>(BetterSMS::Player::getData),
+            "getData__Q29BetterSMS6PlayerFP6TMario");
+        KURIBO_EXPORT_AS((static_cast<void *(*)(TMario *, Player::DataHandle)>(
+                             BetterSMS::Player::getData)),
+                         "getData__Q29BetterSMS6PlayerFP6TMarioUl");
+        KURIBO_EXPORT_AS(BetterSMS::Player::getDataHandle,
+                         "getDataHandle__Q29BetterSMS6PlayerFPCc");
         KURIBO_EXPORT_AS(BetterSMS::Player::registerData,
                          "registerData__Q29BetterSMS6PlayerFP6TMarioPCcPv");
         KURIBO_EXPORT_AS(BetterSMS::Player::deregisterData,
@@ -509,12 +716,36 @@ KURIBO_MODULE_BEGIN(BETTER_SMS_MODULE_NAME, BETTER_SMS_AUTHOR_NAME, BETTER_SMS_V
                          "addAnimationData__Q29BetterSMS6PlayerFPCcbbUcUc");
         KURIBO_EXPORT_AS(BetterSMS::Player::addAnimationDataEx,
                          "addAnimationDataEx__Q29BetterSMS6PlayerFUsPCcbbUcUc");
-        KURIBO_EXPORT_AS(BetterSMS::Player::addInitCallback,
-                         "addInitCallback__Q29BetterSMS6PlayerFPFP6TMariob_v");
-        KURIBO_EXPORT_AS(BetterSMS::Player::addLoadAfterCallback,
+        KURIBO_EXPORT_AS(
+            static_cast<bool (*)(Player::InitCallback)>(BetterSMS::Player::addInitCallback),
+            "addInitCallback__Q29BetterSMS6PlayerFPFP6TMariob_v");
+        KURIBO_EXPORT_AS((static_cast<bool (*)(Player::InitCallback, s32)>(
+                             BetterSMS::Player::addInitCallback)),
+                         "addInitCallback__Q29BetterSMS6PlayerFPFP6TMariob_vl");
+        KURIBO_EXPORT_AS(static_cast<bool (*)(Player::LoadAfterCallback)>(
+                             BetterSMS::Player::addLoadAfterCallback),
                          "addLoadAfterCallback__Q29BetterSMS6PlayerFPFP6TMario_v");
-        KURIBO_EXPORT_AS(BetterSMS::Player::addUpdateCallback,
-                         "addUpdateCallback__Q29BetterSMS6PlayerFPFP6TMariob_v");
+        KURIBO_EXPORT_AS((static_cast<bool (*)(Player::LoadAfterCallback, s32)>(
+                             BetterSMS::Player::addLoadAfterCallback)),
+                         "addLoadAfterCallback__Q29BetterSMS6PlayerFPFP6TMario_vl");
+        KURIBO_EXPORT_AS(
+            static_cast<bool (*)(Player::UpdateCallback)>(BetterSMS::Player::addUpdateCallback),
+            "addUpdateCallback__Q29BetterSMS6PlayerFPFP6TMariob_v");
+        KURIBO_EXPORT_AS((static_cast<bool (*)(Player::UpdateCallback, s32)>(
+                             BetterSMS::Player::addUpdateCallback)),
+                         "addUpdateCallback__Q29BetterSMS6PlayerFPFP6TMariob_vl");
+        KURIBO_EXPORT_AS(BetterSMS::Player::setInitCallbackEnabled,
+                         "setInitCallbackEnabled__Q29BetterSMS6PlayerFPFP6TMariob_vb");
+        KURIBO_EXPORT_AS(BetterSMS::Player::setLoadAfterCallbackEnabled,
+                         "setLoadAfterCallbackEnabled__Q29BetterSMS6PlayerFPFP6TMario_vb");
+        KURIBO_EXPORT_AS(BetterSMS::Player::setUpdateCallbackEnabled,
+                         "setUpdateCallbackEnabled__Q29BetterSMS6PlayerFPFP6TMariob_vb");
+        KURIBO_EXPORT_AS(BetterSMS::Player::getInitCallbackCost,
+                         "getInitCallbackCost__Q29BetterSMS6PlayerFPFP6TMariob_v");
+        KURIBO_EXPORT_AS(BetterSMS::Player::getLoadAfterCallbackCost,
+                         "getLoadAfterCallbackCost__Q29BetterSMS6PlayerFPFP6TMario_v");
+        KURIBO_EXPORT_AS(BetterSMS::Player::getUpdateCallbackCost,
+                         "getUpdateCallbackCost__Q29BetterSMS6PlayerFPFP6TMariob_v");
         KURIBO_EXPORT_AS(BetterSMS::Player::addMessageCallback,
                          "addMessageCallback__Q29BetterSMS6PlayerFUlPFP6TMarioP9THitActorUl_b");
         KURIBO_EXPORT_AS(BetterSMS::Player::registerStateMachine,
@@ -544,6 +775,16 @@ KURIBO_MODULE_BEGIN(BETTER_SMS_MODULE_NAME, BETTER_SMS_AUTHOR_NAME, BETTER_SMS_V
         KURIBO_EXPORT_AS(BetterSMS::Music::setMaxVolume, "setMaxVolume__Q29BetterSMS5MusicFUc");
         KURIBO_EXPORT_AS(BetterSMS::Music::setLooping, "setLooping__Q29BetterSMS5MusicFb");
         KURIBO_EXPORT_AS(BetterSMS::Music::setLoopPoint, "setLoopPoint__Q29BetterSMS5MusicFll");
+        KURIBO_EXPORT_AS(static_cast<bool (*)(u32)>(BetterSMS::Music::isStreamAvailable),
+                         "isStreamAvailable__Q29BetterSMS5MusicFUl");
+        KURIBO_EXPORT_AS(static_cast<bool (*)(const char *)>(BetterSMS::Music::isStreamAvailable),
+                         "isStreamAvailable__Q29BetterSMS5MusicFPCc");
+        KURIBO_EXPORT_AS(BetterSMS::Music::crossfadeSong, "crossfadeSong__Q29BetterSMS5MusicFPCcf");
+        KURIBO_EXPORT_AS(BetterSMS::Music::playJingle, "playJingle__Q29BetterSMS5MusicFPCc");
+        KURIBO_EXPORT_AS(BetterSMS::Music::stopDecodedSongs,
+                         "stopDecodedSongs__Q29BetterSMS5MusicFf");
+        KURIBO_EXPORT_AS(BetterSMS::Music::isDecodedSongPlaying,
+                         "isDecodedSongPlaying__Q29BetterSMS5MusicFv");
 
         /* THP */
         KURIBO_EXPORT_AS(BetterSMS::THP::addTHP, "addTHP__Q29BetterSMS3THPFUcPCc");
@@ -614,6 +855,8 @@ KURIBO_MODULE_BEGIN(BETTER_SMS_MODULE_NAME, BETTER_SMS_AUTHOR_NAME, BETTER_SMS_V
         KURIBO_EXPORT_AS(BetterSMS::Stage::getStageName, "getStageName__Q29BetterSMS5StageFUcUc");
         KURIBO_EXPORT_AS(BetterSMS::Stage::isDivingStage, "isDivingStage__Q29BetterSMS5StageFUcUc");
         KURIBO_EXPORT_AS(BetterSMS::Stage::isExStage, "isExStage__Q29BetterSMS5StageFUcUc");
+        KURIBO_EXPORT_AS(BetterSMS::Stage::prefetchStageParams,
+                         "prefetchStageParams__Q29BetterSMS5StageFUcUc");
 
         /* TIME */
         KURIBO_EXPORT_AS(BetterSMS::Time::buildDate, "buildDate__Q29BetterSMS4TimeFv");
@@ -1,6 +1,7 @@
 
 #include <Dolphin/DVD.h>
 #include <Dolphin/OS.h>
+#include <Dolphin/ctype.h>
 #include <Dolphin/printf.h>
 #include <Dolphin/string.h>
 #include <JSystem/JSupport/JSUStream.hxx>
@@ -20,6 +21,8 @@
 #include "music.hxx"
 #include "stage.hxx"
 
+#include "p_music.hxx"
+
 using namespace BetterSMS;
 using namespace BetterSMS::Music;
 
@@ -78,9 +81,185 @@ BETTER_SMS_FOR_EXPORT void Music::setLoopPoint(s32 start, s32 end) {
     packet.setLoopPoint(start, end);
 }
 
+#pragma region StreamIndex
+
+#define STREAM_INDEX_MAX   128
+#define STREAM_INDEX_NO_ID 0xFFFF
+
+static const char *sStreamDirectory = "/AudioRes/Streams/Music";
+
+static StreamIndexEntry sStreamIndex[STREAM_INDEX_MAX];
+static size_t sStreamIndexCount = 0;
+static bool sIsStreamIndexBuilt = false;
+
+// Matches the case insensitive lookup the FST does for paths
+static bool isStreamNameEqual(const StreamIndexEntry &entry, const char *name) {
+    for (size_t i = 0; i < entry.mNameLength; ++i) {
+        if (tolower(entry.mName[i]) != tolower(name[i]))
+            return false;
+    }
+    return name[entry.mNameLength] == '\0';
+}
+
+// Disc file names keep whatever case they were built with, like the name lookups above
+static bool isStreamFileName(const char *name, size_t length) {
+    static const char extension[] = ".adp";
+
+    if (length <= 4)
+        return false;
+
+    for (size_t i = 0; i < 4; ++i) {
+        if (tolower(name[length - 4 + i]) != extension[i])
+            return false;
+    }
+    return true;
+}
+
+static u16 parseStreamID(const char *name, size_t length) {
+    if (length == 0 || length > 5)
+        return STREAM_INDEX_NO_ID;
+
+    u32 id = 0;
+    for (size_t i = 0; i < length; ++i) {
+        if (!isdigit(name[i]))
+            return STREAM_INDEX_NO_ID;
+        id = (id * 10) + (name[i] - '0');
+    }
+
+    return id < STREAM_INDEX_NO_ID ? id : STREAM_INDEX_NO_ID;
+}
+
+static void loadStreamLoopPoints(StreamIndexEntry &entry) {
+    char cfgPath[0x40];
+    snprintf(cfgPath, sizeof(cfgPath), "%s/%.*s.txt", sStreamDirectory, entry.mNameLength,
+             entry.mName);
+
+    const s32 entrynum = DVDConvertPathToEntrynum(cfgPath);
+    if (entrynum < 0)
+        return;
+
+    DVDFileInfo fileInfo;
+    if (!DVDFastOpen(entrynum, &fileInfo))
+        return;
+
+    const u32 size = OSRoundUp32B(fileInfo.mLen);
+    void *buffer   = JKRHeap::alloc(size, 32, JKRHeap::sSystemHeap);
+    if (buffer) {
+        if (DVDReadPrio(&fileInfo, buffer, size, 0, 2) >= 0) {
+            AudioPacket::PacketParams params;
+            JSUMemoryInputStream stream(buffer, fileInfo.mLen);
+            params.load(stream);
+
+            entry.mLoopStart = params.mLoopStart.get();
+            entry.mLoopEnd   = params.mLoopEnd.get();
+        }
+        JKRHeap::free(buffer, JKRHeap::sSystemHeap);
+    }
+
+    DVDClose(&fileInfo);
+}
+
+static void buildStreamIndex() {
+    if (sIsStreamIndexBuilt)
+        return;
+    sIsStreamIndexBuilt = true;
+
+    DVDDir dir;
+    if (!DVDOpenDir(sStreamDirectory, &dir))
+        return;
+
+    DVDDirEntry dirEntry;
+    while (DVDReadDir(&dir, &dirEntry)) {
+        if (dirEntry.mIsDir)
+            continue;
+
+        const size_t nameLength = strlen(dirEntry.mName);
+        if (!isStreamFileName(dirEntry.mName, nameLength))
+            continue;
+
+        if (sStreamIndexCount >= STREAM_INDEX_MAX) {
+            OSReport("[AUDIO_STREAM] Too many streams, only %d are indexed!\n", STREAM_INDEX_MAX);
+            break;
+        }
+
+        StreamIndexEntry &entry = sStreamIndex[sStreamIndexCount++];
+        entry.mName             = dirEntry.mName;
+        entry.mNameLength       = nameLength - 4;
+        entry.mID               = parseStreamID(entry.mName, entry.mNameLength);
+        entry.mEntryNum         = dirEntry.mEntryNum;
+        entry.mLoopStart        = -1;
+        entry.mLoopEnd          = -1;
+
+        loadStreamLoopPoints(entry);
+    }
+
+    DVDCloseDir(&dir);
+}
+
+const StreamIndexEntry *findStreamEntry(u32 id) {
+    buildStreamIndex();
+
+    if (id >= STREAM_INDEX_NO_ID)
+        return nullptr;
+
+    for (size_t i = 0; i < sStreamIndexCount; ++i) {
+        if (sStreamIndex[i].mID == id)
+            return &sStreamIndex[i];
+    }
+
+    return nullptr;
+}
+
+const StreamIndexEntry *findStreamEntry(const char *name) {
+    buildStreamIndex();
+
+    if (!name)
+        return nullptr;
+
+    for (size_t i = 0; i < sStreamIndexCount; ++i) {
+        if (isStreamNameEqual(sStreamIndex[i], name))
+            return &sStreamIndex[i];
+    }
+
+    return nullptr;
+}
+
+static const StreamIndexEntry *findStreamEntry(const AudioPacket &packet) {
+    if (packet.getStreamHandle() >= 0)
+        return &sStreamIndex[packet.getStreamHandle()];
+
+    return packet.isString() ? findStreamEntry(packet.getString())
+                             : findStreamEntry(packet.getID());
+}
+
+BETTER_SMS_FOR_CALLBACK void initStreamIndex(TApplication *app) { buildStreamIndex(); }
+
+BETTER_SMS_FOR_EXPORT bool Music::isStreamAvailable(u32 id) {
+    return findStreamEntry(id) != nullptr;
+}
+
+BETTER_SMS_FOR_EXPORT bool Music::isStreamAvailable(const char *name) {
+    return findStreamEntry(name) != nullptr;
+}
+
+#pragma endregion
+
 #pragma region Implementation
 
 static SMS_ALIGN(32) DVDFileInfo sAudioFInfo;
+static SMS_ALIGN(32) DVDFileInfo sNextAudioFInfo;
+
+// Gapless handover state of the streamer. Kept out of AudioStreamer so the class keeps the
+// layout modules were built against
+struct TStreamHandover {
+    DVDFileInfo *mNextAudioHandle;  // Spare handle, swapped with mAudioHandle on a switch
+    s32 mNextAudioSlot;             // Queue slot opened in the spare handle, -1 if none
+    u32 mQueueGeneration;           // Bumped whenever the queue is cleared
+    bool mIsNextPrepared;
+    bool mIsHandoverPending;
+};
+
+static TStreamHandover sHandover = {&sNextAudioFInfo, -1, 0, false, false};
 
 static bool _startPaused = false;
 static bool _mIsPlaying  = false;
@@ -104,7 +283,9 @@ AudioStreamer AudioStreamer::sInstance = AudioStreamer(AudioThreadPriority, &sAu
 
 AudioStreamer::AudioStreamer(OSPriority priority, DVDFileInfo *fInfo)
     : mAudioHandle(fInfo), mPlayNextTrack(true), mRequestedNext(false), mRequestedPause(false),
-      mRequestedPlay(false), mRequestedStop(false), mStreamPos(0), mStreamEnd(0), _mAudioIndex(0),
+      mRequestedPlay(false), mRequestedStop(false), mStreamPos(0), mStreamEnd(0), mSyncPos(0),
+      mSyncSamples(0), mLastPollSamples(0), mDVDCommandCount(0), mDVDCommandsPerSecond(0),
+      mDVDCommandsIssued(0), mDVDCommandWindowStart(0), mHasStreamSync(false), _mAudioIndex(0),
       _mDelayedTime(0.0f), _mFadeTime(0.0f), _mWhere(0), _mWhence(JSUStreamSeekFrom::BEGIN),
       _mVolLeft(AudioVolumeDefault), _mVolRight(AudioVolumeDefault),
       _mFullVolLeft(AudioVolumeDefault), _mFullVolRight(AudioVolumeDefault),
@@ -124,6 +305,8 @@ AudioStreamer::~AudioStreamer() {
 
     DVDCancelStream(&mStopBlock);
     DVDClose(mAudioHandle);
+    if (sHandover.mNextAudioSlot >= 0 || sHandover.mIsHandoverPending)
+        DVDClose(sHandover.mNextAudioHandle);
 
     deinitalizeSubsystem();
 }
@@ -192,6 +375,12 @@ void AudioStreamer::mainLoop_(void *param) {
         case AudioStreamer::AudioCommand::CLEAR:
             clear_();
             break;
+        case AudioStreamer::AudioCommand::STAGE:
+            stageNext_();
+            break;
+        case AudioStreamer::AudioCommand::HANDOVER:
+            closeHandover_();
+            break;
         default:
             break;
         }
@@ -209,13 +398,13 @@ u32 AudioStreamer::getLoopStart() const {
     return start & ~0x7FFF;
 }
 
-u32 AudioStreamer::getLoopEnd() const {
-    const AudioPacket &packet = getCurrentAudio();
-    u32 end = packet.getLoopEnd() >= 0 ? Min(packet.getLoopEnd(), mAudioHandle->mLen)
-                                       : mAudioHandle->mLen;
+static u32 getPacketLoopEnd(const AudioPacket &packet, const DVDFileInfo *handle) {
+    u32 end = packet.getLoopEnd() >= 0 ? Min(packet.getLoopEnd(), handle->mLen) : handle->mLen;
     return end & ~0x7FFF;
 }
 
+u32 AudioStreamer::getLoopEnd() const { return getPacketLoopEnd(getCurrentAudio(), mAudioHandle); }
+
 void AudioStreamer::setLooping(bool loop) { _mIsLooping = loop; }
 
 void AudioStreamer::setVolumeLR(u8 left, u8 right) {
@@ -245,16 +434,43 @@ void AudioStreamer::setVolumeFadeTo(u8 to, f32 seconds) {
 }
 
 bool AudioStreamer::queueAudio(const AudioPacket &packet) {
-    for (u32 i = 0; i < AudioQueueSize; ++i) {
-        AudioPacket &slot = _mAudioQueue[(i + _mAudioIndex) % AudioQueueSize];
-        if (slot.getID() == 0xFFFFFFFF) {
-            slot = packet;
-            return true;
+    const StreamIndexEntry *entry = findStreamEntry(packet);
+    if (!entry) {
+        if (packet.isString())
+            OSReport("[AUDIO_STREAM] No stream named \"%s\"!\n", packet.getString());
+        else
+            OSReport("[AUDIO_STREAM] No stream with ID %lu!\n", packet.getID());
+        return false;
+    }
+
+    AudioPacket resolved = packet;
+    resolved.setStreamHandle(entry - sStreamIndex);
+
+    // Loop points given by the caller win over the ones from the side-car file
+    if (resolved.getLoopStart() < 0 && resolved.getLoopEnd() < 0)
+        resolved.setLoopPoint(entry->mLoopStart, entry->mLoopEnd);
+
+    bool isQueued = false;
+    {
+        TAtomicGuard guard;
+
+        for (u32 i = 0; i < AudioQueueSize; ++i) {
+            AudioPacket &slot = _mAudioQueue[(i + _mAudioIndex) % AudioQueueSize];
+            if (slot.getID() == 0xFFFFFFFF) {
+                slot     = resolved;
+                isQueued = true;
+                break;
+            }
         }
     }
 
-    OSReport("[AUDIO_STREAM] Queue is full!\n");
-    return false;
+    if (!isQueued) {
+        OSReport("[AUDIO_STREAM] Queue is full!\n");
+        return false;
+    }
+
+    OSSendMessage(&mMessageQueue, static_cast<u32>(AudioCommand::STAGE), OS_MESSAGE_NOBLOCK);
+    return true;
 }
 
 static OSTime sStartTime     = 0;
@@ -363,6 +579,7 @@ SMS_NO_INLINE bool AudioStreamer::play_() {
 
     bool isStreamAllowed = BetterSMS::isMusicStreamingAllowed();
     if (!isStreamAllowed) {
+        BetterSMS::Console::flush();
         OSPanic(__FILE__, __LINE__,
                 "A music stream attempted to play, but music streaming is disabled! Set byte 8 of "
                 "boot.bin to 0x01 to enable music streaming.");
@@ -523,6 +740,14 @@ SMS_NO_INLINE void AudioStreamer::update_() {
 
     fadeAudio_();
 
+    const OSTime now = OSGetTime();
+    if (now - mDVDCommandWindowStart >= OSMillisecondsToTicks(1000)) {
+        TAtomicGuard guard;
+        mDVDCommandsPerSecond  = mDVDCommandCount;
+        mDVDCommandCount       = 0;
+        mDVDCommandWindowStart = now;
+    }
+
     // Check if volume has finished fading for pause/stop
     const u8 curVolume = ((_mVolLeft + _mVolRight) / 2);
     if (curVolume == _mTargetVolume) {
@@ -539,13 +764,22 @@ SMS_NO_INLINE void AudioStreamer::update_() {
                 stopLowStream();
 
                 if (mRequestedClear) {
-                    TAtomicGuard guard;
-
-                    _mAudioIndex = 0;
-                    for (size_t i = 0; i < 4; ++i) {
-                        _mAudioQueue[i] = AudioPacket();
+                    bool wasStaged;
+                    {
+                        TAtomicGuard guard;
+
+                        _mAudioIndex = 0;
+                        for (size_t i = 0; i < 4; ++i) {
+                            _mAudioQueue[i] = AudioPacket();
+                        }
+                        wasStaged                = sHandover.mNextAudioSlot >= 0;
+                        sHandover.mNextAudioSlot = -1;
+                        mRequestedClear          = false;
+                        sHandover.mQueueGeneration += 1;
                     }
-                    mRequestedClear = false;
+
+                    if (wasStaged)
+                        DVDClose(sHandover.mNextAudioHandle);
                 }
             }
 
@@ -581,42 +815,140 @@ void AudioStreamer::nextTrack_() {
     }
 }
 
-SMS_NO_INLINE bool AudioStreamer::startLowStream() {
-    const AudioPacket &packet = getCurrentAudio();
+static bool openAudioPacket(const AudioPacket &packet, DVDFileInfo *handle) {
+    const StreamIndexEntry *entry = findStreamEntry(packet);
+    if (!entry)
+        return false;
 
-    char adpPath[0x40];
-    char cfgPath[0x40];
+    return DVDFastOpen(entry->mEntryNum, handle);
+}
+
+// Resolves and opens the track queued after the current one, so switching to it later needs
+// no file system work. Runs on the streamer thread, never from the fade alarm
+SMS_NO_INLINE void AudioStreamer::stageNext_() {
+    s32 slot;
+    u32 generation;
+    AudioPacket packet;
+
+    {
+        TAtomicGuard guard;
+
+        // The spare handle still holds the previous track until the handover is closed
+        if (sHandover.mNextAudioSlot >= 0 || sHandover.mIsHandoverPending)
+            return;
+
+        slot       = (_mAudioIndex + 1) % AudioQueueSize;
+        packet     = _mAudioQueue[slot];
+        generation = sHandover.mQueueGeneration;
+    }
 
     if (packet.getID() == 0xFFFFFFFF)
+        return;
+
+    if (!openAudioPacket(packet, sHandover.mNextAudioHandle)) {
+        OSReport("[AUDIO_STREAM] Failed to stage next track!\n");
+        return;
+    }
+
+    {
+        TAtomicGuard guard;
+
+        // The queue was cleared while the file was being opened
+        if (generation == sHandover.mQueueGeneration) {
+            sHandover.mNextAudioSlot = slot;
+            return;
+        }
+    }
+
+    DVDClose(sHandover.mNextAudioHandle);
+}
+
+// Queues the staged track behind the current one on the drive, which starts it as soon as the
+// current stream runs out
+SMS_NO_INLINE bool AudioStreamer::prepareNextStream_() {
+    if (sHandover.mNextAudioSlot < 0 || sHandover.mIsNextPrepared)
         return false;
 
-    if (packet.isString()) {
-        snprintf(adpPath, 64, "/AudioRes/Streams/Music/%s.adp", packet.getString());
-        snprintf(cfgPath, 64, "/AudioRes/Streams/Music/%s.txt", packet.getString());
-    } else {
-        snprintf(adpPath, 64, "/AudioRes/Streams/Music/%lu.adp", packet.getID());
-        snprintf(cfgPath, 64, "/AudioRes/Streams/Music/%lu.txt", packet.getID());
+    const AudioPacket &packet = _mAudioQueue[sHandover.mNextAudioSlot];
+
+    sHandover.mIsNextPrepared = true;
+    countDVDCommand_();
+    DVDPrepareStreamAsync(sHandover.mNextAudioHandle,
+                          getPacketLoopEnd(packet, sHandover.mNextAudioHandle), 0, nullptr);
+    return true;
+}
+
+// Called from the play address poll once the drive has left the current track. The previous
+// file is closed on the streamer thread, which then stages the next track into its handle
+SMS_NO_INLINE void AudioStreamer::finishHandover_(u32 playAddr) {
+    DVDFileInfo *prevHandle      = mAudioHandle;
+    mAudioHandle                 = sHandover.mNextAudioHandle;
+    sHandover.mNextAudioHandle   = prevHandle;
+    sHandover.mNextAudioSlot     = -1;
+    sHandover.mIsNextPrepared    = false;
+    sHandover.mIsHandoverPending = true;
+
+    nextTrack_();
+
+    mStreamPos = playAddr - getStreamStart();
+    mStreamEnd = getLoopEnd() - AudioPreparePreOffset;
+    syncStreamPos_(mStreamPos);
+
+    countDVDCommand_();
+    DVDStopStreamAtEndAsync(&mPrepareBlock, AudioStreamer::cbForStopStreamAtEndAsync_);
+    OSSendMessage(&mMessageQueue, static_cast<u32>(AudioCommand::HANDOVER), OS_MESSAGE_NOBLOCK);
+}
+
+SMS_NO_INLINE void AudioStreamer::closeHandover_() {
+    if (!sHandover.mIsHandoverPending)
+        return;
+
+    DVDClose(sHandover.mNextAudioHandle);
+    {
+        TAtomicGuard guard;
+        sHandover.mIsHandoverPending = false;
     }
 
-    if (!DVDOpen(adpPath, mAudioHandle))
+    OSReport("[AUDIO_STREAM] Switched to next track without a gap\n");
+    stageNext_();
+}
+
+SMS_NO_INLINE bool AudioStreamer::startLowStream() {
+    const AudioPacket &packet = getCurrentAudio();
+
+    if (packet.getID() == 0xFFFFFFFF)
+        return false;
+
+    if (sHandover.mNextAudioSlot == _mAudioIndex) {
+        DVDFileInfo *prevHandle    = mAudioHandle;
+        mAudioHandle               = sHandover.mNextAudioHandle;
+        sHandover.mNextAudioHandle = prevHandle;
+        sHandover.mNextAudioSlot   = -1;
+    } else if (!openAudioPacket(packet, mAudioHandle)) {
         return false;
+    }
 
     AISetStreamVolLeft(_mVolLeft);
     AISetStreamVolRight(_mVolRight);
     AIResetStreamSampleCount();
     AISetStreamTrigger(Music::AudioInterruptRate);
     AISetStreamPlayState(true);
+    mHasStreamSync   = false;
+    mLastPollSamples = 0;
 
+    countDVDCommand_();
     DVDPrepareStreamAsync(mAudioHandle, getLoopEnd(), 0, AudioStreamer::cbForPrepareStreamAsync_);
     mStreamEnd = getLoopEnd() - AudioPreparePreOffset;
     mStreamPos = 0;
 
+    OSSendMessage(&mMessageQueue, static_cast<u32>(AudioCommand::STAGE), OS_MESSAGE_NOBLOCK);
     return true;
 }
 
 SMS_NO_INLINE void AudioStreamer::pauseLowStream() {
     OSReport("[AUDIO_STREAM] Pausing stream...\n");
     AISetStreamPlayState(false);
+    countDVDCommand_();
     DVDStopStreamAtEndAsync(&mPauseBlock, nullptr);
     // DVDCancelStreamAsync(&mStopBlock, cbForCancelStreamOnPauseAsync_);
 }
@@ -630,6 +962,7 @@ SMS_NO_INLINE bool AudioStreamer::seekLowStream(s32 streamPos) {
 
     OSReport("[AUDIO_STREAM] Seeking to %d\n", streamPos);
 
+    countDVDCommand_();
     return DVDCancelStreamAsync(&mSeekBlock, AudioStreamer::cbForCancelStreamOnSeekAsync_);
 }
 
@@ -638,6 +971,7 @@ SMS_NO_INLINE bool AudioStreamer::stopLowStream() {
     AISetStreamVolLeft(0);
     AISetStreamVolRight(0);
     AISetStreamPlayState(false);
+    countDVDCommand_();
     return DVDCancelStreamAsync(&mStopBlock, AudioStreamer::cbForCancelStreamOnStopAsync_);
 }
 
@@ -645,19 +979,57 @@ bool BetterSMS::Music::AudioStreamer::canPlayNextTrack() const {
     return mPlayNextTrack && mErrorStatus == 0;
 }
 
+// Samples to wait before the drive has to be asked where it is. Between polls the position is
+// extrapolated from the last reported address, so the drive is only queried when the stream
+// nears its loop point or end, or when the watchdog runs out
+u32 AudioStreamer::getSamplesUntilPoll_(u32 sampleCount) const {
+    if (mErrorStatus != 1 || !mHasStreamSync || sHandover.mIsNextPrepared)
+        return 0;
+
+    const u32 sinceLastPoll = sampleCount - mLastPollSamples;
+    if (sinceLastPoll >= AudioPollWatchdogRate)
+        return 0;
+
+    const u32 predictedPos =
+        mSyncPos + ((sampleCount - mSyncSamples) / AudioFrameSamples) * AudioFrameSize;
+    if (predictedPos + AudioPollNearOffset >= mStreamEnd)
+        return 0;
+
+    const u32 bytesUntilNear       = mStreamEnd - (predictedPos + AudioPollNearOffset);
+    const u32 samplesUntilNear     = (bytesUntilNear / AudioFrameSize) * AudioFrameSamples;
+    const u32 samplesUntilWatchdog = AudioPollWatchdogRate - sinceLastPoll;
+
+    u32 samples = samplesUntilNear < samplesUntilWatchdog ? samplesUntilNear : samplesUntilWatchdog;
+    if (samples < AudioInterruptRate)
+        samples = AudioInterruptRate;
+    return samples;
+}
+
+void AudioStreamer::syncStreamPos_(u32 streamPos) {
+    mSyncPos       = streamPos;
+    mSyncSamples   = AIGetStreamSampleCount();
+    mHasStreamSync = true;
+}
+
+void AudioStreamer::countDVDCommand_() {
+    TAtomicGuard guard;
+    mDVDCommandCount += 1;
+    mDVDCommandsIssued += 1;
+}
+
 void AudioPacket::setLoopPoint(s32 start, s32 end) {
-    mParams.mLoopStart.set(start);
-    mParams.mLoopEnd.set(end);
+    mLoopStart = start;
+    mLoopEnd   = end;
 }
 
 void AudioPacket::setLoopPoint(s32 start, size_t length) {
-    mParams.mLoopStart.set(start);
-    mParams.mLoopEnd.set(start + length);
+    mLoopStart = start;
+    mLoopEnd   = start + length;
 }
 
 void AudioPacket::setLoopPoint(f32 start, f32 length) {
-    mParams.mLoopStart.set(start);
-    mParams.mLoopEnd.set(start + length);
+    mLoopStart = static_cast<s32>(start);
+    mLoopEnd   = static_cast<s32>(start + length);
 }
 
 SMS_NO_INLINE void AudioStreamer::cbForVolumeAlarm(OSAlarm *alarm, OSContext *context) {
@@ -667,8 +1039,16 @@ SMS_NO_INLINE void AudioStreamer::cbForVolumeAlarm(OSAlarm *alarm, OSContext *co
 
 SMS_NO_INLINE void AudioStreamer::cbForAIInterrupt(u32 trigger) {
     AudioStreamer *streamer = AudioStreamer::getInstance();
-    // streamer->mStreamPos    = trigger * (48000.0f / AudioStreamRate);
+
+    const u32 samplesUntilPoll = streamer->getSamplesUntilPoll_(trigger);
+    if (samplesUntilPoll > 0) {
+        AISetStreamTrigger(trigger + samplesUntilPoll);
+        return;
+    }
+
     AISetStreamTrigger(trigger + Music::AudioInterruptRate);
+    streamer->mLastPollSamples = trigger;
+    streamer->countDVDCommand_();
     DVDGetStreamPlayAddrAsync(&streamer->mAIInteruptBlock,
                               AudioStreamer::cbForGetStreamPlayAddrAsync_);
 }
@@ -690,6 +1070,7 @@ SMS_NO_INLINE void AudioStreamer::cbForGetStreamPlayAddrAsync_(u32 result,
 
     AudioStreamer *streamer = AudioStreamer::getInstance();
 
+    streamer->countDVDCommand_();
     DVDGetStreamErrorStatusAsync(&streamer->mPlayAddrBlock,
                                  AudioStreamer::cbForGetStreamErrorStatusAsync_);
 
@@ -697,7 +1078,19 @@ SMS_NO_INLINE void AudioStreamer::cbForGetStreamPlayAddrAsync_(u32 result,
         return;
     }
 
+    // The drive moves on to the prepared track by itself, we only follow it. The next track
+    // may be the same file, so the handover is the address leaving what is left of this one
+    if (sHandover.mIsNextPrepared) {
+        const u32 playedStart = streamer->getStreamPos();
+        const u32 playedEnd   = streamer->getStreamStart() + streamer->getLoopEnd();
+        if (result < playedStart || result >= playedEnd) {
+            streamer->finishHandover_(result);
+        }
+        return;
+    }
+
     streamer->mStreamPos = result - streamer->getStreamStart();
+    streamer->syncStreamPos_(streamer->mStreamPos);
 
     // Check if we've reached the end of the stream
     if (streamer->getStreamPos() < streamer->getStreamEnd()) {
@@ -710,13 +1103,14 @@ SMS_NO_INLINE void AudioStreamer::cbForGetStreamPlayAddrAsync_(u32 result,
         streamer->_mWhere  = streamer->getLoopStart();
         streamer->_mWhence = BEGIN;
         streamer->seek_();
-    } else {
+    } else if (!streamer->prepareNextStream_()) {
         streamer->skip_();
     }
 }
 
 SMS_NO_INLINE void AudioStreamer::cbForPrepareStreamAsync_(u32 result, DVDFileInfo *finfo) {
     AudioStreamer *streamer = AudioStreamer::getInstance();
+    streamer->countDVDCommand_();
     DVDStopStreamAtEndAsync(&streamer->mPrepareBlock, AudioStreamer::cbForStopStreamAtEndAsync_);
     _mIsPlaying = true;
     _mIsPaused  = false;
@@ -732,15 +1126,20 @@ SMS_NO_INLINE void AudioStreamer::cbForCancelStreamOnStopAsync_(u32 result,
     streamer->mStreamPos                      = 0;
     streamer->mStreamEnd                      = 0;
     streamer->mErrorStatus                    = 0;
+    sHandover.mIsNextPrepared                 = false;
     _mIsPlaying                               = false;
     _mIsPaused                                = false;
 }
 
 SMS_NO_INLINE void AudioStreamer::cbForCancelStreamOnSeekAsync_(u32 result,
                                                                 DVDCommandBlock *callback) {
-    AudioStreamer *streamer = AudioStreamer::getInstance();
+    AudioStreamer *streamer   = AudioStreamer::getInstance();
+    sHandover.mIsNextPrepared = false;
+    streamer->mHasStreamSync  = false;
     AIResetStreamSampleCount();
     AISetStreamTrigger(Music::AudioInterruptRate);
+    streamer->mLastPollSamples = 0;
+    streamer->countDVDCommand_();
     DVDPrepareStreamAsync(streamer->mAudioHandle, streamer->getLoopEnd() - streamer->mStreamPos,
                           streamer->mStreamPos, AudioStreamer::cbForPrepareStreamAsync_);
 }
@@ -1020,6 +1419,7 @@ BETTER_SMS_FOR_CALLBACK void stopMusicOnExitStage(TApplication *app) {
         AudioStreamer *streamer = AudioStreamer::getInstance();
         streamer->stop(PauseFadeSpeed);
         streamer->clear();
+        Music::stopDecodedSongs(PauseFadeSpeed);
     }
 }
 
@@ -1030,6 +1430,7 @@ static void fadeStreamOnFadeBgm(void *fadeX, f32 blend) {
         u8 volume  = static_cast<f32>(streamer->getFullVolumeLR()) * scaler;
         streamer->setVolumeLR(volume, volume);
     }
+    setDecodedSongBlend(blend);
 
     xFadeBgm__10MSBgmXFadeFf(fadeX, blend);
 }
@@ -1046,6 +1447,7 @@ static void fadeStreamOnFadeBgmForce(void *fadeX, f32 blend) {
         u8 volume  = static_cast<f32>(streamer->getFullVolumeLR()) * scaler;
         streamer->setVolumeLR(volume, volume);
     }
+    setDecodedSongBlend(blend);
 
     xFadeBgmForce__10MSBgmXFadeFf(fadeX, blend);
 }
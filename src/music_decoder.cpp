@@ -0,0 +1,587 @@
+#include <Dolphin/AI.h>
+#include <Dolphin/DVD.h>
+#include <Dolphin/OS.h>
+#include <Dolphin/types.h>
+#include <JSystem/JKernel/JKRHeap.hxx>
+#include <SMS/MSound/MSBGM.hxx>
+#include <SMS/System/Application.hxx>
+#include <SMS/System/MarDirector.hxx>
+#include <SMS/macros.h>
+
+#include "libs/lock.hxx"
+#include "logging.hxx"
+#include "module.hxx"
+#include "music.hxx"
+
+#include "p_adpcm.hxx"
+#include "p_music.hxx"
+
+#if BETTER_SMS_SOFTWARE_MUSIC
+
+using namespace BetterSMS;
+using namespace BetterSMS::Music;
+
+// Streams are read in chunks into a small ring, decoded on the decoder thread into a PCM ring,
+// and mixed into each block the game's mixer hands to the AI DMA. Jingles are read whole and
+// decoded from RAM, so they never hold the drive once started.
+
+#define DECODER_VOICES      3
+#define DECODER_READ_SIZE   0x4000  // Must be a multiple of the ADP frame size
+#define DECODER_PCM_FRAMES  4096    // Must be a power of two
+#define DECODER_JINGLE_MAX  0x40000
+#define DECODER_STREAM_RATE 48000
+#define DECODER_THREAD_PRIO AudioThreadPriority
+
+#define DECODER_VOLUME_FULL (0x8000 << 8)  // Q15 gain, with 8 bits kept for slow ramps
+#define DECODER_HOLD_FADE   0.8f              // Same fade the drive stream pauses with
+
+static_assert(ADPFrameSize == AudioFrameSize && ADPFrameSamples == AudioFrameSamples,
+              "The ADP kernel and the streamer disagree on the frame layout");
+
+enum class DecoderVoiceState : u8 { IDLE, PLAYING, STOPPING, FINISHED };
+enum class DecoderChunkState : u8 { EMPTY, READING, READY };
+
+struct DecoderVoice {
+    SMS_ALIGN(32) DVDFileInfo mFileInfo;
+
+    // Two read chunks for streamed songs, a single chunk holding the whole file for jingles
+    u8 *mChunks;
+    u32 mChunkSize;
+    u8 mChunkCount;
+    volatile DecoderChunkState mChunkState[2];
+    u32 mChunkBytes[2];
+    u32 mChunkOffset[2];  // File offset each chunk was read from
+    u8 mReadChunk;
+    u8 mDecodeChunk;
+    u32 mDecodeOffset;
+
+    u32 mFileOffset;
+    u32 mLoopStart;
+    u32 mLoopEnd;
+    bool mIsLooping;
+    bool mIsResident;
+    bool mIsSong;
+    volatile bool mIsReadDone;
+    volatile bool mIsDecodeDone;
+
+    ADPHistory mHistory[2];
+    ADPHistory mLoopHistory[2];  // Decoder state on entering the loop start the first time
+    bool mHasLoopHistory;
+
+    s16 *mPCM;
+    volatile u32 mPCMHead;  // Written by the decoder thread
+    volatile u32 mPCMTail;  // Written by the mixer
+    u32 mPhase;
+
+    s32 mVolume;
+    s32 mVolumeTarget;
+    s32 mVolumeStep;
+    bool mIsHeld;  // Silenced for the pause menu or event music, PCM isn't consumed
+    volatile DecoderVoiceState mState;
+};
+
+static DecoderVoice sDecoderVoices[DECODER_VOICES];
+
+static u8 SMS_ALIGN(32) sDecoderThreadStack[0x2000];
+static OSThread sDecoderThread;
+static OSThreadQueue sDecoderThreadQueue;
+static volatile bool sIsDecoderPending = false;
+static bool sIsDecoderStarted          = false;
+
+static AIDCallback sPrevDMACallback = nullptr;
+
+// Q15 scale on songs while the game cross fades its sequenced music over them
+static volatile s32 sSongBlendGain = 0x8000;
+
+#pragma region DecoderThread
+
+static void wakeDecoder() {
+    sIsDecoderPending = true;
+    if (sIsDecoderStarted)
+        OSWakeupThread(&sDecoderThreadQueue);
+}
+
+static void cbForDecoderReadAsync_(u32 result, DVDFileInfo *finfo) {
+    for (auto &voice : sDecoderVoices) {
+        if (&voice.mFileInfo != finfo)
+            continue;
+
+        const u8 chunk = voice.mReadChunk;
+        if (static_cast<s32>(result) < 0) {
+            voice.mChunkState[chunk] = DecoderChunkState::EMPTY;
+            voice.mIsReadDone        = true;
+            break;
+        }
+
+        voice.mChunkBytes[chunk] = result;
+        voice.mChunkState[chunk] = DecoderChunkState::READY;
+        voice.mReadChunk         = (chunk + 1) % voice.mChunkCount;
+        break;
+    }
+
+    wakeDecoder();
+}
+
+static void issueVoiceRead(DecoderVoice &voice) {
+    if (voice.mIsReadDone)
+        return;
+
+    const u8 chunk = voice.mReadChunk;
+    for (u8 i = 0; i < voice.mChunkCount; ++i) {
+        if (voice.mChunkState[i] == DecoderChunkState::READING)
+            return;
+    }
+
+    if (voice.mChunkState[chunk] != DecoderChunkState::EMPTY)
+        return;
+
+    if (voice.mFileOffset >= voice.mLoopEnd) {
+        if (!voice.mIsLooping) {
+            voice.mIsReadDone = true;
+            return;
+        }
+        voice.mFileOffset = voice.mLoopStart;
+    }
+
+    u32 length = voice.mLoopEnd - voice.mFileOffset;
+    if (length > voice.mChunkSize)
+        length = voice.mChunkSize;
+
+    voice.mChunkOffset[chunk] = voice.mFileOffset;
+    voice.mChunkState[chunk]  = DecoderChunkState::READING;
+    if (!DVDReadAsync(&voice.mFileInfo, voice.mChunks + (chunk * voice.mChunkSize), length,
+                      voice.mFileOffset, cbForDecoderReadAsync_)) {
+        voice.mChunkState[chunk] = DecoderChunkState::EMPTY;
+        voice.mIsReadDone        = true;
+        return;
+    }
+
+    voice.mFileOffset += length;
+}
+
+static void decodeVoice(DecoderVoice &voice) {
+    s16 frame[AudioFrameSamples * 2];
+    const u32 mask = DECODER_PCM_FRAMES - 1;
+
+    if (voice.mIsDecodeDone)
+        return;
+
+    while (DECODER_PCM_FRAMES - (voice.mPCMHead - voice.mPCMTail) >= AudioFrameSamples) {
+        const u8 chunk = voice.mDecodeChunk;
+        if (voice.mChunkState[chunk] != DecoderChunkState::READY) {
+            if (voice.mIsReadDone && voice.mChunkState[chunk] == DecoderChunkState::EMPTY)
+                voice.mIsDecodeDone = true;
+            return;
+        }
+
+        // The predictor runs on from the previous frame, so a loop back has to pick up the
+        // history the loop start was first decoded with rather than the loop end's
+        if (voice.mChunkOffset[chunk] + voice.mDecodeOffset == voice.mLoopStart) {
+            if (voice.mHasLoopHistory) {
+                voice.mHistory[0] = voice.mLoopHistory[0];
+                voice.mHistory[1] = voice.mLoopHistory[1];
+            } else {
+                voice.mLoopHistory[0] = voice.mHistory[0];
+                voice.mLoopHistory[1] = voice.mHistory[1];
+                voice.mHasLoopHistory = true;
+            }
+        }
+
+        const u8 *data = voice.mChunks + (chunk * voice.mChunkSize) + voice.mDecodeOffset;
+        decodeADPFrame(data, frame, voice.mHistory);
+
+        u32 head = voice.mPCMHead;
+        for (u32 i = 0; i < AudioFrameSamples; ++i, ++head) {
+            voice.mPCM[(head & mask) * 2]     = frame[i * 2];
+            voice.mPCM[(head & mask) * 2 + 1] = frame[i * 2 + 1];
+        }
+        voice.mPCMHead = head;
+
+        voice.mDecodeOffset += AudioFrameSize;
+        if (voice.mDecodeOffset + AudioFrameSize > voice.mChunkBytes[chunk]) {
+            voice.mDecodeOffset = 0;
+            voice.mDecodeChunk  = (chunk + 1) % voice.mChunkCount;
+
+            // A jingle keeps its only chunk and ends once it has been decoded through
+            if (voice.mIsResident) {
+                voice.mIsDecodeDone = true;
+                return;
+            }
+
+            voice.mChunkState[chunk] = DecoderChunkState::EMPTY;
+            issueVoiceRead(voice);
+        }
+    }
+}
+
+static void freeVoiceBuffers(DecoderVoice &voice) {
+    if (voice.mChunks)
+        JKRHeap::free(voice.mChunks, JKRHeap::sSystemHeap);
+    if (voice.mPCM)
+        JKRHeap::free(voice.mPCM, JKRHeap::sSystemHeap);
+    voice.mChunks = nullptr;
+    voice.mPCM    = nullptr;
+}
+
+static void releaseVoice(DecoderVoice &voice) {
+    DVDCancel(&voice.mFileInfo.mCmdBlock);
+    DVDClose(&voice.mFileInfo);
+    freeVoiceBuffers(voice);
+
+    voice.mState = DecoderVoiceState::IDLE;
+}
+
+static void *decoderThreadMain(void *param) {
+    while (true) {
+        {
+            TAtomicGuard guard;
+            while (!sIsDecoderPending) {
+                OSSleepThread(&sDecoderThreadQueue);
+            }
+            sIsDecoderPending = false;
+        }
+
+        for (auto &voice : sDecoderVoices) {
+            switch (voice.mState) {
+            case DecoderVoiceState::FINISHED:
+                releaseVoice(voice);
+                break;
+            case DecoderVoiceState::PLAYING:
+            case DecoderVoiceState::STOPPING:
+                issueVoiceRead(voice);
+                decodeVoice(voice);
+                break;
+            default:
+                break;
+            }
+        }
+    }
+
+    return nullptr;
+}
+
+#pragma endregion
+
+#pragma region Mixer
+
+// The AI DMA registers hold the physical address of the block queued to play next
+static s16 *getQueuedDMABlock() {
+    volatile u16 *regs = reinterpret_cast<volatile u16 *>(0xCC005030);
+    const u32 address  = (static_cast<u32>(regs[0] & 0x3FF) << 16) | (regs[1] & 0xFFE0);
+    return reinterpret_cast<s16 *>(OSPhysicalToCached(address));
+}
+
+static inline s16 saturate16(s32 value) {
+    if (value > 0x7FFF)
+        return 0x7FFF;
+    if (value < -0x8000)
+        return -0x8000;
+    return value;
+}
+
+static void mixVoice(DecoderVoice &voice, s16 *out, u32 frames, u32 step) {
+    const u32 mask = DECODER_PCM_FRAMES - 1;
+    const u32 head = voice.mPCMHead;
+
+    // A held voice keeps its place once it is silent, so it resumes where it stopped
+    if (voice.mIsHeld && voice.mState == DecoderVoiceState::PLAYING && voice.mVolume == 0 &&
+        voice.mVolumeTarget == 0)
+        return;
+
+    u32 tail            = voice.mPCMTail;
+    u32 phase           = voice.mPhase;
+    s32 volume          = voice.mVolume;
+    const s32 blendGain = voice.mIsSong ? sSongBlendGain : 0x8000;
+
+    for (u32 i = 0; i < frames; ++i) {
+        if (head - tail < 2)
+            break;
+
+        // Linear interpolation between neighbouring source frames, the fraction kept in Q15
+        const s16 *a    = &voice.mPCM[(tail & mask) * 2];
+        const s16 *b    = &voice.mPCM[((tail + 1) & mask) * 2];
+        const s32 frac  = (phase & 0xFFFF) >> 1;
+        const s32 left  = a[0] + (((b[0] - a[0]) * frac) >> 15);
+        const s32 right = a[1] + (((b[1] - a[1]) * frac) >> 15);
+        const s32 gain  = ((volume >> 8) * blendGain) >> 15;
+
+        out[i * 2]     = saturate16(out[i * 2] + ((left * gain) >> 15));
+        out[i * 2 + 1] = saturate16(out[i * 2 + 1] + ((right * gain) >> 15));
+
+        phase += step;
+        tail += phase >> 16;
+        phase &= 0xFFFF;
+
+        if (volume != voice.mVolumeTarget) {
+            volume += voice.mVolumeStep;
+            if ((voice.mVolumeStep > 0 && volume > voice.mVolumeTarget) ||
+                (voice.mVolumeStep < 0 && volume < voice.mVolumeTarget))
+                volume = voice.mVolumeTarget;
+        }
+    }
+
+    voice.mPCMTail = tail;
+    voice.mPhase   = phase;
+    voice.mVolume  = volume;
+
+    if ((voice.mState == DecoderVoiceState::STOPPING && volume == 0) ||
+        (voice.mIsDecodeDone && head - tail < 2))
+        voice.mState = DecoderVoiceState::FINISHED;
+}
+
+// Runs after the game's own DMA callback has queued its next block. The DSP wrote that block
+// straight to memory, so the cache is invalidated before it is read and flushed after mixing
+static void cbForDecoderDMA() {
+    if (sPrevDMACallback)
+        sPrevDMACallback();
+
+    s16 *block        = getQueuedDMABlock();
+    const u32 length  = AIGetDMALength();
+    const u32 outRate = AIGetDSPSampleRate() == AI_SAMPLE_32K ? 32000 : 48000;
+    const u32 step    = (DECODER_STREAM_RATE << 16) / outRate;
+    bool isBlockMixed = false;
+
+    for (auto &voice : sDecoderVoices) {
+        if (voice.mState != DecoderVoiceState::PLAYING &&
+            voice.mState != DecoderVoiceState::STOPPING)
+            continue;
+
+        if (!isBlockMixed) {
+            DCInvalidateRange(block, length);
+            isBlockMixed = true;
+        }
+
+        mixVoice(voice, block, length / 4, step);
+    }
+
+    if (isBlockMixed) {
+        DCFlushRange(block, length);
+        wakeDecoder();
+    }
+}
+
+#pragma endregion
+
+#pragma region Interface
+
+static void fadeOutVoice(DecoderVoice &voice, f32 seconds);
+
+static void setVoiceFade(DecoderVoice &voice, s32 target, f32 seconds) {
+    const u32 outRate = AIGetDSPSampleRate() == AI_SAMPLE_32K ? 32000 : 48000;
+    const s32 samples = static_cast<s32>(seconds * outRate);
+
+    TAtomicGuard guard;
+    voice.mVolumeTarget = target;
+    if (samples <= 0) {
+        voice.mVolume     = target;
+        voice.mVolumeStep = 0;
+    } else {
+        voice.mVolumeStep = (target - voice.mVolume) / samples;
+        if (voice.mVolumeStep == 0)
+            voice.mVolumeStep = target > voice.mVolume ? 1 : -1;
+    }
+}
+
+// The mixer may finish the voice on its own, so the state is only changed while it can't run
+static void fadeOutVoice(DecoderVoice &voice, f32 seconds) {
+    TAtomicGuard guard;
+
+    if (voice.mState != DecoderVoiceState::PLAYING)
+        return;
+
+    voice.mState = DecoderVoiceState::STOPPING;
+    setVoiceFade(voice, 0, seconds);
+}
+
+static void holdVoice(DecoderVoice &voice, bool isHeld) {
+    TAtomicGuard guard;
+
+    if (voice.mState != DecoderVoiceState::PLAYING || voice.mIsHeld == isHeld)
+        return;
+
+    voice.mIsHeld = isHeld;
+    setVoiceFade(voice, isHeld ? 0 : DECODER_VOLUME_FULL, DECODER_HOLD_FADE);
+}
+
+static DecoderVoice *startVoice(const char *name, bool isSong) {
+    if (!sIsDecoderStarted)
+        return nullptr;
+
+    const StreamIndexEntry *entry = findStreamEntry(name);
+    if (!entry) {
+        Console::report(Console::LogLevel::WARNING, "[AUDIO_DECODE] No stream named \"%s\"!\n",
+                        name);
+        return nullptr;
+    }
+
+    DecoderVoice *voice = nullptr;
+    for (auto &slot : sDecoderVoices) {
+        if (slot.mState == DecoderVoiceState::IDLE) {
+            voice = &slot;
+            break;
+        }
+    }
+
+    if (!voice) {
+        Console::report(Console::LogLevel::WARNING, "[AUDIO_DECODE] No free voice for \"%s\"!\n",
+                        name);
+        return nullptr;
+    }
+
+    if (!DVDFastOpen(entry->mEntryNum, &voice->mFileInfo))
+        return nullptr;
+
+    const u32 fileLength = voice->mFileInfo.mLen & ~(AudioFrameSize - 1);
+    voice->mLoopEnd      = fileLength;
+    voice->mLoopStart    = 0;
+    if (entry->mLoopEnd >= 0 && static_cast<u32>(entry->mLoopEnd) < fileLength)
+        voice->mLoopEnd = entry->mLoopEnd & ~(AudioFrameSize - 1);
+    if (entry->mLoopStart >= 0 && static_cast<u32>(entry->mLoopStart) < voice->mLoopEnd)
+        voice->mLoopStart = entry->mLoopStart & ~(AudioFrameSize - 1);
+
+    voice->mIsSong     = isSong;
+    voice->mIsLooping  = isSong;
+    voice->mIsResident = !isSong;
+
+    if (voice->mIsResident && fileLength > DECODER_JINGLE_MAX) {
+        Console::report(Console::LogLevel::WARNING,
+                        "[AUDIO_DECODE] \"%s\" is too large to play from RAM!\n", name);
+        DVDClose(&voice->mFileInfo);
+        return nullptr;
+    }
+
+    voice->mChunkCount = voice->mIsResident ? 1 : 2;
+    voice->mChunkSize  = voice->mIsResident ? OSRoundUp32B(fileLength) : DECODER_READ_SIZE;
+    voice->mChunks     = static_cast<u8 *>(JKRHeap::alloc(voice->mChunkSize * voice->mChunkCount,
+                                                          32, JKRHeap::sSystemHeap));
+    voice->mPCM        = static_cast<s16 *>(
+        JKRHeap::alloc(DECODER_PCM_FRAMES * 2 * sizeof(s16), 32, JKRHeap::sSystemHeap));
+
+    if (!voice->mChunks || !voice->mPCM) {
+        freeVoiceBuffers(*voice);
+        DVDClose(&voice->mFileInfo);
+        return nullptr;
+    }
+
+    for (u8 i = 0; i < 2; ++i) {
+        voice->mChunkState[i]  = DecoderChunkState::EMPTY;
+        voice->mChunkBytes[i]  = 0;
+        voice->mChunkOffset[i] = 0;
+    }
+    voice->mReadChunk      = 0;
+    voice->mDecodeChunk    = 0;
+    voice->mDecodeOffset   = 0;
+    voice->mFileOffset     = 0;
+    voice->mIsReadDone     = false;
+    voice->mIsDecodeDone   = false;
+    voice->mHistory[0]     = {0, 0};
+    voice->mHistory[1]     = {0, 0};
+    voice->mHasLoopHistory = false;
+    voice->mPCMHead        = 0;
+    voice->mPCMTail        = 0;
+    voice->mPhase          = 0;
+    voice->mVolume         = 0;
+    voice->mVolumeTarget   = 0;
+    voice->mVolumeStep     = 0;
+    voice->mIsHeld         = false;
+    voice->mState          = DecoderVoiceState::PLAYING;
+
+    wakeDecoder();
+    return voice;
+}
+
+BETTER_SMS_FOR_CALLBACK void initSoftwareMusic(TApplication *app) {
+    if (sIsDecoderStarted)
+        return;
+
+    OSInitThreadQueue(&sDecoderThreadQueue);
+    OSCreateThread(&sDecoderThread, decoderThreadMain, nullptr,
+                   sDecoderThreadStack + sizeof(sDecoderThreadStack),
+                   sizeof(sDecoderThreadStack), DECODER_THREAD_PRIO, OS_THREAD_ATTR_DETACH);
+    OSResumeThread(&sDecoderThread);
+
+    sPrevDMACallback  = AIRegisterDMACallback(cbForDecoderDMA);
+    sIsDecoderStarted = true;
+}
+
+void setDecodedSongBlend(f32 blend) {
+    blend          = blend < 0.0f ? 0.0f : blend > 1.0f ? 1.0f : blend;
+    sSongBlendGain = static_cast<s32>((1.0f - blend) * 0x8000);
+}
+
+// Mirrors what the drive stream does in AudioStreamer::update_: everything is held while the
+// pause menu is open, songs are also held while sequenced event music plays
+BETTER_SMS_FOR_CALLBACK void updateSoftwareMusic(TApplication *app) {
+    if (!sIsDecoderStarted)
+        return;
+
+    const bool isGamePaused =
+        gpMarDirector && gpMarDirector->mCurState == TMarDirector::STATE_PAUSE_MENU;
+    const bool isEventMusic = MSBgm::getHandle(0) || MSBgm::getHandle(1) || MSBgm::getHandle(2);
+
+    for (auto &voice : sDecoderVoices) {
+        holdVoice(voice, isGamePaused || (voice.mIsSong && isEventMusic));
+    }
+}
+
+BETTER_SMS_FOR_EXPORT bool Music::crossfadeSong(const char *name, f32 seconds) {
+    DecoderVoice *next = startVoice(name, true);
+    if (!next)
+        return false;
+
+    for (auto &voice : sDecoderVoices) {
+        if (&voice != next && voice.mIsSong)
+            fadeOutVoice(voice, seconds);
+    }
+
+    // The drive stream fades out alongside, so a hardware song can hand over to a decoded one
+    AudioStreamer *streamer = AudioStreamer::getInstance();
+    if (streamer->isPlaying())
+        streamer->stop(seconds);
+
+    setVoiceFade(*next, DECODER_VOLUME_FULL, seconds);
+    return true;
+}
+
+BETTER_SMS_FOR_EXPORT bool Music::playJingle(const char *name) {
+    DecoderVoice *voice = startVoice(name, false);
+    if (!voice)
+        return false;
+
+    setVoiceFade(*voice, DECODER_VOLUME_FULL, 0.0f);
+    return true;
+}
+
+BETTER_SMS_FOR_EXPORT void Music::stopDecodedSongs(f32 fadeTime) {
+    for (auto &voice : sDecoderVoices) {
+        fadeOutVoice(voice, fadeTime);
+    }
+}
+
+BETTER_SMS_FOR_EXPORT bool Music::isDecodedSongPlaying() {
+    for (auto &voice : sDecoderVoices) {
+        if (voice.mIsSong && voice.mState == DecoderVoiceState::PLAYING)
+            return true;
+    }
+    return false;
+}
+
+#pragma endregion
+
+#else
+
+// Built without the decoder, modules calling these just see nothing play
+
+void setDecodedSongBlend(f32 blend) {}
+
+BETTER_SMS_FOR_EXPORT bool BetterSMS::Music::crossfadeSong(const char *name, f32 seconds) {
+    return false;
+}
+
+BETTER_SMS_FOR_EXPORT bool BetterSMS::Music::playJingle(const char *name) { return false; }
+
+BETTER_SMS_FOR_EXPORT void BetterSMS::Music::stopDecodedSongs(f32 fadeTime) {}
+
+BETTER_SMS_FOR_EXPORT bool BetterSMS::Music::isDecodedSongPlaying() { return false; }
+
+#endif
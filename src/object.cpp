@@ -241,6 +241,7 @@ void objects_staticResetter() {}
 
 void TMapObjBase_initActorData_override(TMapObjBase *that) {
     if(that == nullptr) {
+        Console::flush();
         OSPanic(__FILE__, __LINE__, "Tried to init nullptr actor %X\n", (u32)that);
     }
 
@@ -261,6 +262,7 @@ void TMapObjBase_initActorData_override(TMapObjBase *that) {
     }
 
     if (idx == -1) {
+        Console::flush();
         OSPanic(__FILE__, __LINE__, "Could not find actor '%s' on initialize.\n", that->mRegisterName);
     }
 
@@ -0,0 +1,57 @@
+#pragma once
+
+#include <Dolphin/types.h>
+
+// ADP (the drive's streaming ADPCM) frame decoder, shared by the software music decoder and the
+// host tests. Kept free of SDK headers beyond the basic types so it builds on the host too.
+
+constexpr u32 ADPFrameSize    = 32;
+constexpr u32 ADPFrameSamples = 28;
+
+struct ADPHistory {
+    s32 mHist1;
+    s32 mHist2;
+};
+
+// Predictor coefficients selected by the upper nibble of each channel's frame header
+constexpr s16 ADPCoefficients[4][2] = {
+    {0x00, 0x00},
+    {0x3C, 0x00},
+    {0x73, -0x34},
+    {0x62, -0x37},
+};
+
+inline s16 decodeADPSample(s32 nibble, u8 header, ADPHistory &history) {
+    const s16 *coef = ADPCoefficients[(header >> 4) & 3];
+
+    s32 predicted = ((history.mHist1 * coef[0]) + (history.mHist2 * coef[1]) + 0x20) >> 6;
+    if (predicted > 0x1FFFFF)
+        predicted = 0x1FFFFF;
+    else if (predicted < -0x200000)
+        predicted = -0x200000;
+
+    const s32 sample = ((static_cast<s16>(nibble << 12) >> (header & 0xF)) << 6) + predicted;
+
+    history.mHist2 = history.mHist1;
+    history.mHist1 = sample;
+
+    const s32 out = sample >> 6;
+    if (out > 0x7FFF)
+        return 0x7FFF;
+    if (out < -0x8000)
+        return -0x8000;
+    return out;
+}
+
+// One 32 byte frame is a 4 byte header followed by 28 bytes holding a left sample in the low
+// nibble and a right sample in the high nibble. `out` receives interleaved stereo samples
+inline void decodeADPFrame(const u8 *frame, s16 *out, ADPHistory *history) {
+    const u8 headerL = frame[0];
+    const u8 headerR = frame[1];
+    const u8 *data   = frame + (ADPFrameSize - ADPFrameSamples);
+
+    for (u32 i = 0; i < ADPFrameSamples; ++i) {
+        out[i * 2]     = decodeADPSample(data[i] & 0xF, headerL, history[0]);
+        out[i * 2 + 1] = decodeADPSample(data[i] >> 4, headerR, history[1]);
+    }
+}
@@ -0,0 +1,12 @@
+#pragma once
+
+#include <Dolphin/types.h>
+
+#define LOG_HISTORY_LINES 16
+#define LOG_HISTORY_WIDTH 72
+
+// Starts the thread that prints queued messages, anything logged earlier is kept until then
+void initConsoleLog();
+
+// Writes the most recently printed lines into `dst`, oldest first
+size_t copyLogHistory(char *dst, size_t size);
@@ -0,0 +1,20 @@
+#pragma once
+
+#include <Dolphin/types.h>
+
+#define MAX_ALLOCATION_SITES 64
+
+struct AllocationSiteStat {
+    const void *mSite;
+    size_t mBytes;
+    u32 mBlocks;
+};
+
+struct StageLeakReport {
+    size_t mBytes;
+    u32 mBlocks;
+};
+
+void getTrackedTotals(size_t &bytesOut, u32 &blocksOut, u32 &untrackedOut);
+size_t getAllocationSiteStats(AllocationSiteStat *out, size_t maxCount);
+const StageLeakReport &getLastStageLeakReport();
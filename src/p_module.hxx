@@ -1,8 +1,62 @@
 #pragma once
 
+#include <Dolphin/OS.h>
+
 #include "libs/global_unordered_map.hxx"
 #include "libs/string.hxx"
 
 #include "module.hxx"
 
-extern BetterSMS::TGlobalVector<BetterSMS::ModuleInfo> gModuleInfos;
\ No newline at end of file
+extern BetterSMS::TGlobalVector<BetterSMS::ModuleInfo> gModuleInfos;
+
+#define MAX_COSTED_CALLBACKS 256
+#define MAX_COSTED_MODULES   32
+
+struct CallbackCostInfo {
+    const void *mCallback;
+    const char *mHook;
+    s16 mModule;
+
+    u32 mFrameTicks;
+    u32 mWindowSum;
+    u32 mWindowPeak;
+
+    u32 mLastTicks;
+    u32 mAvgTicks;
+    u32 mPeakTicks;
+};
+
+struct ModuleCostInfo {
+    const char *mName;
+
+    u32 mFrameTicks;
+    u32 mWindowSum;
+    u32 mWindowPeak;
+
+    BetterSMS::ModuleFrameCost mCost;
+};
+
+// Claims a cost slot charged to the current callback owner, -1 once the table is full
+s16 registerCallbackCost(const void *callback, const char *hook);
+void recordCallbackCost(s16 slot, u32 ticks);
+// Closes the current frame, called once per game loop
+void updateCallbackCosts();
+
+size_t getCallbackCosts(const CallbackCostInfo *&costsOut);
+size_t getModuleCosts(const ModuleCostInfo *&costsOut);
+
+// Registered callback that times itself against its cost slot on every call
+template <typename _C> struct TModuleCallback {
+    _C mCallback;
+    s16 mCostSlot;
+
+    template <typename... _Args> void operator()(_Args... args) const {
+        const OSTick start = OSGetTick();
+        mCallback(args...);
+        recordCallbackCost(mCostSlot, OSDiffTick(OSGetTick(), start));
+    }
+};
+
+template <typename _C> TModuleCallback<_C> makeModuleCallback(_C callback, const char *hook) {
+    return {callback, registerCallbackCost(reinterpret_cast<const void *>(callback), hook)};
+}
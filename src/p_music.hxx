@@ -0,0 +1,22 @@
+#pragma once
+
+#include <Dolphin/types.h>
+
+// Built once from the music directory, so a song resolves to its FST entry without walking
+// paths and its side-car loop points are only read from disc once
+struct StreamIndexEntry {
+    const char *mName;  // Points into the FST string table, not terminated at the extension
+    u16 mNameLength;
+    u16 mID;
+    s32 mEntryNum;
+    s32 mLoopStart;
+    s32 mLoopEnd;
+};
+
+// Both build the index on first use and return nullptr for songs the disc doesn't have
+const StreamIndexEntry *findStreamEntry(u32 id);
+const StreamIndexEntry *findStreamEntry(const char *name);
+
+// Scales decoded songs like the drive stream while MSBgmXFade blends event music in, a no-op
+// without the software decoder
+void setDecodedSongBlend(f32 blend);
@@ -0,0 +1,108 @@
+#pragma once
+
+#include <Dolphin/types.h>
+#include <SMS/Map/MapCollisionData.hxx>
+
+// Per triangle tests of the patched checkRoofList/checkGroundList in patches/collision/search.cpp.
+// Shared so searches that walk the cell lists themselves keep the exact same filters.
+
+// True and the plane's Y at x/z when `checkData` is a roof candidate for a search from y
+inline bool isRoofPlaneHit(const TBGCheckData *checkData, f32 x, f32 y, f32 z, u8 flags,
+                           bool isCollisionRepaired, f32 &exactY) {
+    const u16 type = checkData->mType;
+
+    if (isCollisionRepaired && (flags & 8)) {
+        if (!(type >= 0x100 && type < 0x106) && type != 0x4104)
+            return false;
+    }
+
+    if ((flags & 4)) {  // Pass through Check
+        if (type == 0x401 || type == 0x801 || type == 0x10A || type == 0x8400)
+            return false;
+        if (isCollisionRepaired && type == 0x800)
+            return false;
+    }
+
+    if (isCollisionRepaired && (flags & 1)) {  // Water Check
+        if ((type >= 0x100 && type < 0x106) || type == 0x4104)
+            return false;
+    }
+
+    const f32 ax = checkData->mVertices[0].x;
+    const f32 az = checkData->mVertices[0].z;
+    const f32 bz = checkData->mVertices[1].z;
+    const f32 bx = checkData->mVertices[1].x;
+
+    if (!((az - z) * (bx - ax) - (ax - x) * (bz - az) <= 1.0f))
+        return false;
+
+    const f32 cz = checkData->mVertices[2].z;
+    const f32 cx = checkData->mVertices[2].x;
+
+    if (!((bz - z) * (cx - bx) - (bx - x) * (cz - bz) <= 1.0f &&
+          (cz - z) * (ax - cx) - (cx - x) * (az - cz) <= 1.0f))
+        return false;
+
+    exactY =
+        -(checkData->mProjectionFactor + x * checkData->mNormal.x + z * checkData->mNormal.z) /
+        checkData->mNormal.y;
+
+    return !(y - (exactY + 78.0f) > 0.0f);
+}
+
+// True and the plane's Y at x/z when `checkData` is a ground candidate for a search from y
+inline bool isGroundPlaneHit(const TBGCheckData *checkData, f32 x, f32 y, f32 z, u8 flags,
+                             bool isCollisionRepaired, f32 &exactY) {
+    if (y < checkData->mMinHeight)
+        return false;
+
+    const u16 type = checkData->mType;
+
+    if ((flags & 0b100000) != 0) {  // Water Check
+        if ((type >= 0x100 && type < 0x104) || type == 0x4104)
+            return false;
+    }
+
+    if (isCollisionRepaired && (flags & 0b10000)) {
+        if (checkData->isMarioThrough())
+            return false;
+    }
+
+    if (isCollisionRepaired && (flags & 0b1000)) {
+        if (!(type >= 0x100 && type < 0x106) && type != 0x4104)
+            return false;
+    }
+
+    if ((flags & 0b100) != 0) {  // Pass through Check
+        if (type == 0x401 || type == 0x801 || type == 0x10A || type == 0x8400)
+            return false;
+        if (isCollisionRepaired && type == 0x800)
+            return false;
+    }
+
+    if ((flags & 0b1) != 0) {  // Water Check
+        if ((type >= 0x100 && type < 0x106) || type == 0x4104)
+            return false;
+    }
+
+    const f32 ax = checkData->mVertices[0].x;
+    const f32 az = checkData->mVertices[0].z;
+    const f32 bz = checkData->mVertices[1].z;
+    const f32 bx = checkData->mVertices[1].x;
+
+    if (!(-1.0f <= (az - z) * (bx - ax) - (ax - x) * (bz - az)))
+        return false;
+
+    const f32 cz = checkData->mVertices[2].z;
+    const f32 cx = checkData->mVertices[2].x;
+
+    if (!(-1.0f <= (bz - z) * (cx - bx) - (bx - x) * (cz - bz) &&
+          -1.0f <= (cz - z) * (ax - cx) - (cx - x) * (az - cz)))
+        return false;
+
+    exactY =
+        -(checkData->mProjectionFactor + x * checkData->mNormal.x + z * checkData->mNormal.z) /
+        checkData->mNormal.y;
+
+    return !(y - (exactY - 78.0f) < 0.0f);
+}
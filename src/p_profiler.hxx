@@ -0,0 +1,43 @@
+#pragma once
+
+#include <Dolphin/types.h>
+
+#define PROFILE_MAX_THREADS  4
+#define PROFILE_MAX_ZONES    64
+#define PROFILE_MAX_DEPTH    16
+#define PROFILE_TRACE_FRAMES 8
+
+struct ProfileZoneStats {
+    const char *mName;
+    s16 mParent;
+    u8 mDepth;
+    u8 mThread;
+
+    // Accumulated while the current frame is drained
+    u32 mFrameTicks;
+    u32 mFrameStart;
+    u32 mFrameCalls;
+
+    // Last complete frame, used for the flame bars
+    u32 mLastTicks;
+    u32 mLastStart;
+    u32 mLastCalls;
+
+    // Rolling window over the frames the zone ran in
+    u32 mWindowMin;
+    u32 mWindowMax;
+    u32 mWindowSum;
+    u32 mWindowFrames;
+
+    // Published at the end of each window
+    u32 mMinTicks;
+    u32 mAvgTicks;
+    u32 mMaxTicks;
+};
+
+// Drains every thread's ring and closes the current frame, called once per game loop
+void updateProfiler();
+
+size_t getProfileZones(const ProfileZoneStats *&zonesOut);
+u32 getLastProfileFrameTicks();
+u32 getProfileDroppedZones();
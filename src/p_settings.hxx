@@ -30,7 +30,6 @@ s32 OpenSavedSettings(Settings::SettingsGroup &group, CARDFileInfo &infoOut, boo
 s32 UpdateSavedSettings(Settings::SettingsGroup &group, CARDFileInfo *finfo);
 s32 ReadSavedSettings(Settings::SettingsGroup &group, CARDFileInfo *finfo);
 s32 CloseSavedSettings(const Settings::SettingsGroup &group, CARDFileInfo *finfo);
-s32 SaveAllSettings();
 
 const u8 SMS_ALIGN(32) gSaveBnr[] = {
     0x09, 0x00, 0x00, 0x60, 0x00, 0x20, 0x00, 0x00, 0x01, 0x02, 0x00, 0xd0, 0x00, 0x00, 0x0c, 0x20,
@@ -414,7 +413,8 @@ static const u8 *sLoadingIconTIMGs[] = {
     gShineSpriteIconFrame13, gShineSpriteIconFrame14, gShineSpriteIconFrame15,
     gShineSpriteIconFrame16};
 
-void getSettingsGroups(TGlobalVector<Settings::SettingsGroup *> &out);
+const TGlobalVector<Settings::SettingsGroup *> &getSettingsGroups();
+void invalidateSettingsGroups();
 
 struct SettingInfo {
     J2DTextBox *mSettingTextBox;
@@ -0,0 +1,111 @@
+#pragma once
+
+#include <Dolphin/math.h>
+#include <Dolphin/types.h>
+
+// Wall solver kernels shared by the collision patches and the host replay tests. Templated on
+// the vector type so they don't drag in JGeometry, anything with x/y/z float members works.
+
+constexpr f32 WallCornerThreshold = -0.9f;
+
+// Position independent terms of the wall solver, so each query only does the per-record math
+template <typename _V> struct TWallEdgeTerms {
+    _V mEdgeAB;  // v1 - v0
+    _V mEdgeAC;  // v2 - v0
+    _V mEdgeBC;  // v2 - v1
+    f32 mDotABAB;
+    f32 mDotABAC;
+    f32 mDotACAC;
+    f32 mInvDenom;
+    f32 mInvEdgeY[3];  // 1 / Y delta of AB, AC, BC, or 0 for a flat edge
+    f32 mBoundsXZ[4];  // minX, maxX, minZ, maxZ, kept together for paired loads
+};
+
+template <typename _V>
+inline void computeWallEdgeTerms(const _V &a, const _V &b, const _V &c, TWallEdgeTerms<_V> &out) {
+    out.mEdgeAB.x = b.x - a.x;
+    out.mEdgeAB.y = b.y - a.y;
+    out.mEdgeAB.z = b.z - a.z;
+    out.mEdgeAC.x = c.x - a.x;
+    out.mEdgeAC.y = c.y - a.y;
+    out.mEdgeAC.z = c.z - a.z;
+    out.mEdgeBC.x = c.x - b.x;
+    out.mEdgeBC.y = c.y - b.y;
+    out.mEdgeBC.z = c.z - b.z;
+
+    const _V &ab = out.mEdgeAB;
+    const _V &ac = out.mEdgeAC;
+
+    out.mDotABAB  = ab.x * ab.x + ab.y * ab.y + ab.z * ab.z;
+    out.mDotABAC  = ab.x * ac.x + ab.y * ac.y + ab.z * ac.z;
+    out.mDotACAC  = ac.x * ac.x + ac.y * ac.y + ac.z * ac.z;
+    out.mInvDenom = 1.0f / (out.mDotABAB * out.mDotACAC - out.mDotABAC * out.mDotABAC);
+
+    out.mInvEdgeY[0] = out.mEdgeAB.y != 0.0f ? 1.0f / out.mEdgeAB.y : 0.0f;
+    out.mInvEdgeY[1] = out.mEdgeAC.y != 0.0f ? 1.0f / out.mEdgeAC.y : 0.0f;
+    out.mInvEdgeY[2] = out.mEdgeBC.y != 0.0f ? 1.0f / out.mEdgeBC.y : 0.0f;
+
+    out.mBoundsXZ[0] = a.x < b.x ? (a.x < c.x ? a.x : c.x) : (b.x < c.x ? b.x : c.x);
+    out.mBoundsXZ[1] = a.x > b.x ? (a.x > c.x ? a.x : c.x) : (b.x > c.x ? b.x : c.x);
+    out.mBoundsXZ[2] = a.z < b.z ? (a.z < c.z ? a.z : c.z) : (b.z < c.z ? b.z : c.z);
+    out.mBoundsXZ[3] = a.z > b.z ? (a.z > c.z ? a.z : c.z) : (b.z > c.z ? b.z : c.z);
+}
+
+// True if `origin` projects inside the triangle face (barycentric test against vertex A)
+template <typename _V>
+inline bool isInsideWallFace(const TWallEdgeTerms<_V> &terms, const _V &vertexA, const _V &origin) {
+    const f32 px = origin.x - vertexA.x;
+    const f32 py = origin.y - vertexA.y;
+    const f32 pz = origin.z - vertexA.z;
+
+    const f32 dotPAB = px * terms.mEdgeAB.x + py * terms.mEdgeAB.y + pz * terms.mEdgeAB.z;
+    const f32 dotPAC = px * terms.mEdgeAC.x + py * terms.mEdgeAC.y + pz * terms.mEdgeAC.z;
+
+    const f32 v = (terms.mDotACAC * dotPAB - terms.mDotABAC * dotPAC) * terms.mInvDenom;
+    if (v < 0.0f || v > 1.0f)
+        return false;
+
+    const f32 w = (terms.mDotABAB * dotPAC - terms.mDotABAC * dotPAB) * terms.mInvDenom;
+    return !(w < 0.0f || w > 1.0f || v + w > 1.0f);
+}
+
+// Resolve the record against a wall edge, returns true if the record was pushed out
+template <typename _V>
+inline bool pushOutOfWallEdge(f32 normalX, f32 normalZ, const _V &edge, f32 invEdgeY,
+                              const _V &fromVertex, f32 *positions, const _V &origin,
+                              f32 &margin_radius, bool &isCorner) {
+    const f32 v = (origin.y - fromVertex.y) * invEdgeY;
+    if (v < 0.0f || v > 1.0f)
+        return false;
+
+    f32 dx         = edge.x * v - (origin.x - fromVertex.x);
+    f32 dz         = edge.z * v - (origin.z - fromVertex.z);
+    const f32 dist = sqrtf(dx * dx + dz * dz);
+    const f32 push = dist - margin_radius;
+    if (push > 0.0f)
+        return false;
+
+    const f32 scale = push / dist;
+    positions[0] += (dx *= scale);
+    positions[2] += (dz *= scale);
+    margin_radius += 0.01f;
+
+    isCorner = dx * normalX + dz * normalZ < WallCornerThreshold * push;
+    return true;
+}
+
+// Edge 1-2, then 1-3, then 2-3, returns true if any edge pushed the record out
+template <typename _V>
+inline bool pushOutOfWallEdges(const TWallEdgeTerms<_V> &terms, f32 normalX, f32 normalZ,
+                               const _V &vertexA, const _V &vertexB, f32 *positions,
+                               const _V &origin, f32 &margin_radius, bool &isCorner) {
+    return (terms.mEdgeAB.y != 0.0f &&
+            pushOutOfWallEdge(normalX, normalZ, terms.mEdgeAB, terms.mInvEdgeY[0], vertexA,
+                              positions, origin, margin_radius, isCorner)) ||
+           (terms.mEdgeAC.y != 0.0f &&
+            pushOutOfWallEdge(normalX, normalZ, terms.mEdgeAC, terms.mInvEdgeY[1], vertexA,
+                              positions, origin, margin_radius, isCorner)) ||
+           (terms.mEdgeBC.y != 0.0f &&
+            pushOutOfWallEdge(normalX, normalZ, terms.mEdgeBC, terms.mInvEdgeY[2], vertexB,
+                              positions, origin, margin_radius, isCorner));
+}
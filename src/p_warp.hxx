@@ -69,11 +69,18 @@ namespace BetterSMS {
 
         class TWarpCollisionList {
         public:
-            TWarpCollisionList(size_t size) : mUsedSize(0), mMaxSize(size) {
+            static constexpr u16 NullIndex = 0xFFFF;
+
+            TWarpCollisionList(size_t size)
+                : mUsedSize(0), mMaxSize(size), mCenters(nullptr), mHomeOrder(nullptr),
+                  mKdOrder(nullptr), mKdSize(0), mIsIndexDirty(true) {
                 mColList = reinterpret_cast<Collision::TCollisionLink *>(
                     JKRHeap::sCurrentHeap->alloc(sizeof(Collision::TCollisionLink) * size, 4));
             };
-            ~TWarpCollisionList() { delete mColList; }
+            ~TWarpCollisionList() {
+                releaseIndex();
+                delete mColList;
+            }
 
             void addLink(const TBGCheckData *a, const TBGCheckData *b);
             void addLink(TCollisionLink &link);
@@ -88,12 +95,28 @@ namespace BetterSMS {
             TCollisionLink *getLinks() const { return mColList; }
 
             const TBGCheckData *resolveCollisionWarp(const TBGCheckData *colTriangle);
-            const TBGCheckData *getNearestTarget(const TBGCheckData *colTriangle) const;
+            const TBGCheckData *getNearestTarget(const TBGCheckData *colTriangle);
+
+            // Rebuild the lookup index, done once on stage load and lazily after edits
+            void buildIndex();
 
         private:
+            void releaseIndex();
+            void buildKdTree(u16 *order, u16 count, u8 axis);
+            void searchKdTree(const u16 *order, u16 count, u8 axis, const TVec3f &point,
+                              const TBGCheckData *exclude, f32 minSqrDist, f32 &nearestSqrDist,
+                              u16 &nearestIndex) const;
+
             size_t mUsedSize;
             size_t mMaxSize;
             TCollisionLink *mColList;
+
+            TVec3f *mCenters;          // Triangle center per link
+            u16 *mHomeOrder;           // Link indices bucketed by home ID, list order kept
+            u16 mHomeStart[257];       // Bucket offsets into mHomeOrder per home ID
+            u16 *mKdOrder;             // Implicit k-d tree of valid destinations
+            u16 mKdSize;
+            bool mIsIndexDirty;
         };
     }  // namespace Collision
 }  // namespace BetterSMS
\ No newline at end of file
@@ -1,14 +1,19 @@
+#include <Dolphin/mem.h>
+#include <JSystem/JKernel/JKRHeap.hxx>
 #include <SMS/Map/Map.hxx>
 #include <SMS/Map/MapCollisionData.hxx>
 #include <SMS/Map/MapMakeList.hxx>
 #include <SMS/Player/Mario.hxx>
 #include <SMS/Strategic/Strategy.hxx>
+#include <SMS/System/Application.hxx>
 #include <SMS/macros.h>
 
 #include "memory.hxx"
 
 #include "module.hxx"
+#include "p_plane_check.hxx"
 #include "p_settings.hxx"
+#include "p_wall_edge.hxx"
 
 // Fix intersecting slopes
 static f32 getRoofNoWater(TMap *map, f32 x, f32 y, f32 z, const TBGCheckData **out) {
@@ -27,35 +32,143 @@ static f32 getRoofNoWater(TMap *map, f32 x, f32 y, f32 z, const TBGCheckData **o
 }
 SMS_PATCH_BL(SMS_PORT_REGION(0x802573C8, 0, 0, 0), getRoofNoWater);
 
-// -- ROUNDED CORNERS -- //
+// -- WALL EDGE CACHE -- //
+
+// Static walls also remember the last batched query that gathered them
+struct TWallEdgeData : TWallEdgeTerms<TVec3f> {
+    u32 mQueryStamp;
+};
+
+// Moving collision rewrites its vertices in place, so entries remember what they were built from
+struct TMoveWallEdgeEntry {
+    const TBGCheckData *mColTriangle;
+    TVec3f mVertices[3];
+    TWallEdgeData mEdgeData;
+};
+
+#define WALL_EDGE_INVALID_SLOT 0xFFFF
+#define MOVE_WALL_EDGE_CACHE_SIZE 64
+
+static const TMapCollisionData *sWallEdgeCollision = nullptr;
+static const TBGCheckData *sWallEdgeTris           = nullptr;
+static u32 sWallEdgeTrisCount                      = 0;
+static u16 *sWallEdgeSlots                         = nullptr;
+static TWallEdgeData *sWallEdgeTable               = nullptr;
+
+static TMoveWallEdgeEntry sMoveWallEdgeCache[MOVE_WALL_EDGE_CACHE_SIZE];
 
-constexpr float CornerThreshold = -0.9f;
+static void computeWallEdgeData(const TBGCheckData *checkData, TWallEdgeData &out) {
+    computeWallEdgeTerms<TVec3f>(checkData->mVertices[0], checkData->mVertices[1],
+                                 checkData->mVertices[2], out);
+    out.mQueryStamp = 0;
+}
+
+BETTER_SMS_FOR_CALLBACK void releaseWallEdgeTable(TApplication *app) {
+    if (sWallEdgeSlots)
+        JKRHeap::free(sWallEdgeSlots, JKRHeap::sSystemHeap);
+    if (sWallEdgeTable)
+        JKRHeap::free(sWallEdgeTable, JKRHeap::sSystemHeap);
+
+    sWallEdgeCollision = nullptr;
+    sWallEdgeTris      = nullptr;
+    sWallEdgeTrisCount = 0;
+    sWallEdgeSlots     = nullptr;
+    sWallEdgeTable     = nullptr;
+
+    memset(sMoveWallEdgeCache, 0, sizeof(sMoveWallEdgeCache));
+}
+
+// Static walls never move, build their edge data once per stage
+BETTER_SMS_FOR_CALLBACK void buildWallEdgeTable(TMarDirector *director) {
+    releaseWallEdgeTable(nullptr);
+
+    TMapCollisionData *collision = gpMapCollisionData;
+    if (!collision || !collision->mCollisionTris || collision->mCheckDataCount == 0)
+        return;
+
+    u32 wallCount = 0;
+    for (u32 i = 0; i < collision->mCheckDataCount; ++i) {
+        if (collision->mCollisionTris[i].getPlaneType() == TBGCheckListRoot::WALL)
+            wallCount += 1;
+    }
+
+    if (wallCount == 0 || wallCount >= WALL_EDGE_INVALID_SLOT)
+        return;
+
+    sWallEdgeSlots = reinterpret_cast<u16 *>(
+        JKRHeap::alloc(sizeof(u16) * collision->mCheckDataCount, 4, JKRHeap::sSystemHeap));
+    sWallEdgeTable = reinterpret_cast<TWallEdgeData *>(
+        JKRHeap::alloc(sizeof(TWallEdgeData) * wallCount, 4, JKRHeap::sSystemHeap));
+
+    if (!sWallEdgeSlots || !sWallEdgeTable) {
+        releaseWallEdgeTable(nullptr);
+        return;
+    }
+
+    u16 slot = 0;
+    for (u32 i = 0; i < collision->mCheckDataCount; ++i) {
+        TBGCheckData *checkData = &collision->mCollisionTris[i];
+        if (checkData->getPlaneType() != TBGCheckListRoot::WALL) {
+            sWallEdgeSlots[i] = WALL_EDGE_INVALID_SLOT;
+            continue;
+        }
+        computeWallEdgeData(checkData, sWallEdgeTable[slot]);
+        sWallEdgeSlots[i] = slot++;
+    }
+
+    sWallEdgeCollision = collision;
+    sWallEdgeTris      = collision->mCollisionTris;
+    sWallEdgeTrisCount = collision->mCheckDataCount;
+}
+
+static TWallEdgeData *getStaticWallEdgeData(const TBGCheckData *checkData) {
+    if (sWallEdgeTable && checkData >= sWallEdgeTris &&
+        checkData < sWallEdgeTris + sWallEdgeTrisCount) {
+        const u16 slot = sWallEdgeSlots[checkData - sWallEdgeTris];
+        if (slot != WALL_EDGE_INVALID_SLOT)
+            return &sWallEdgeTable[slot];
+    }
+    return nullptr;
+}
+
+static const TWallEdgeData *getWallEdgeData(const TBGCheckData *checkData) {
+    if (const TWallEdgeData *edgeData = getStaticWallEdgeData(checkData))
+        return edgeData;
+
+    // Moving (or unindexed) collision, rebuilt only when the triangle actually moved
+    const u32 hash = (reinterpret_cast<u32>(checkData) >> 4) % MOVE_WALL_EDGE_CACHE_SIZE;
+    TMoveWallEdgeEntry &entry = sMoveWallEdgeCache[hash];
+
+    if (entry.mColTriangle != checkData ||
+        memcmp(entry.mVertices, checkData->mVertices, sizeof(entry.mVertices)) != 0) {
+        entry.mColTriangle = checkData;
+        memcpy(entry.mVertices, checkData->mVertices, sizeof(entry.mVertices));
+        computeWallEdgeData(checkData, entry.mEdgeData);
+    }
+
+    return &entry.mEdgeData;
+}
+
+// -- ROUNDED CORNERS -- //
 
 // Credits to frameperfection
-static size_t checkWallListExotic(const TBGCheckList *list, TBGWallCheckRecord *record) {
+static size_t checkWallListExotic(TBGCheckData *const *candidates, size_t candidateCount,
+                                  TBGWallCheckRecord *record) {
     TBGCheckData *checkData;
     f32 offset;
     f32 radius = record->mRadius;
     f32 positions[3];
-    Mtx33 VMatrix;
     s32 numCols = 0;
-    s32 i;
-    f32 DOOD[5];
-    f32 invDenom;
-    f32 v, w;
     f32 margin_radius = radius - 1.0f;
     positions[0]      = record->mPosition.x;
     positions[1]      = record->mPosition.y;
     positions[2]      = record->mPosition.z;
 
-    // Stay in this loop until out of walls.
-    while (list) {
-        checkData = list->mColTriangle;
-        list = list->mNextTriangle;
-        // Exclude a large number of walls immediately to optimize.
-        if (positions[1] < checkData->mMinHeight || positions[1] > checkData->mMaxHeight) {
-            continue;
-        }
+    const TVec3f &origin = record->mPosition;
+
+    // Height band was already checked when the candidates were gathered
+    for (size_t i = 0; i < candidateCount; ++i) {
+        checkData = candidates[i];
 
         if ((record->mIgnoreFlags & 8)) {
             const u16 type = checkData->mType;
@@ -89,118 +202,43 @@ static size_t checkWallListExotic(const TBGCheckList *list, TBGWallCheckRecord *
             continue;
         }
 
-        VMatrix[0][0] = (checkData->mVertices[1].x - checkData->mVertices[0].x);
-        VMatrix[1][0] = (checkData->mVertices[2].x - checkData->mVertices[0].x);
-        VMatrix[2][0] = record->mPosition.x - checkData->mVertices[0].x;
-
-        VMatrix[0][1] = (checkData->mVertices[1].y - checkData->mVertices[0].y);
-        VMatrix[1][1] = (checkData->mVertices[2].y - checkData->mVertices[0].y);
-        VMatrix[2][1] = record->mPosition.y - checkData->mVertices[0].y;
-
-        VMatrix[0][2] = (checkData->mVertices[1].z - checkData->mVertices[0].z);
-        VMatrix[1][2] = (checkData->mVertices[2].z - checkData->mVertices[0].z);
-        VMatrix[2][2] = record->mPosition.z - checkData->mVertices[0].z;
-
-        DOOD[0]  = PSVECDotProduct(reinterpret_cast<Vec *>(VMatrix[0]),
-                                   reinterpret_cast<Vec *>(VMatrix[0]));
-        DOOD[1]  = PSVECDotProduct(reinterpret_cast<Vec *>(VMatrix[0]),
-                                   reinterpret_cast<Vec *>(VMatrix[1]));
-        DOOD[2]  = PSVECDotProduct(reinterpret_cast<Vec *>(VMatrix[1]),
-                                   reinterpret_cast<Vec *>(VMatrix[1]));
-        DOOD[3]  = PSVECDotProduct(reinterpret_cast<Vec *>(VMatrix[2]),
-                                   reinterpret_cast<Vec *>(VMatrix[0]));
-        DOOD[4]  = PSVECDotProduct(reinterpret_cast<Vec *>(VMatrix[2]),
-                                   reinterpret_cast<Vec *>(VMatrix[1]));
-        invDenom = 1.0f / (DOOD[0] * DOOD[2] - DOOD[1] * DOOD[1]);
-        v        = (DOOD[2] * DOOD[3] - DOOD[1] * DOOD[4]) * invDenom;
-        if (v < 0.0f || v > 1.0f)
-            goto edge_1_2;
-
-        w = (DOOD[0] * DOOD[4] - DOOD[1] * DOOD[3]) * invDenom;
-        if (w < 0.0f || w > 1.0f || v + w > 1.0f)
-            goto edge_1_2;
+        const TWallEdgeData *edgeData = getWallEdgeData(checkData);
+        const TVec3f &vertexA         = checkData->mVertices[0];
+        const TVec3f &vertexB         = checkData->mVertices[1];
+
+        // Any contact is within reach of the origin on XZ, grown by how far we were pushed so far
+        {
+            const f32 reach = Max(radius, margin_radius) + fabsf(positions[0] - origin.x) +
+                              fabsf(positions[2] - origin.z);
+            const f32 *bounds = edgeData->mBoundsXZ;
+            if (origin.x + reach < bounds[0] || origin.x - reach > bounds[1] ||
+                origin.z + reach < bounds[2] || origin.z - reach > bounds[3])
+                continue;
+        }
+
+        if (!isInsideWallFace<TVec3f>(*edgeData, vertexA, origin))
+            goto edges;
 
         positions[0] += checkData->mNormal.x * (radius - offset);
         positions[2] += checkData->mNormal.z * (radius - offset);
         goto hasCollision;
 
-    edge_1_2:
+    edges:
         if (offset < 0)
             continue;
-        // Edge 1-2
-        if (VMatrix[0][1] != 0.0f) {
-            v = (VMatrix[2][1] / VMatrix[0][1]);
-            if (v < 0.0f || v > 1.0f)
-                goto edge_1_3;
-            DOOD[0]  = VMatrix[0][0] * v - VMatrix[2][0];
-            DOOD[1]  = VMatrix[0][2] * v - VMatrix[2][2];
-            invDenom = sqrtf(DOOD[0] * DOOD[0] + DOOD[1] * DOOD[1]);
-            offset   = invDenom - margin_radius;
-            if (offset > 0.0f)
-                goto edge_1_3;
-            invDenom = offset / invDenom;
-            positions[0] += (DOOD[0] *= invDenom);
-            positions[2] += (DOOD[1] *= invDenom);
-            margin_radius += 0.01f;
-
-            if (DOOD[0] * checkData->mNormal.x + DOOD[1] * checkData->mNormal.z < CornerThreshold * offset)
-                continue;
-            else
-                goto hasCollision;
-        }
 
-    edge_1_3:
-        // Edge 1-3
-        if (VMatrix[1][1] != 0.0f) {
-            v = (VMatrix[2][1] / VMatrix[1][1]);
-            if (v < 0.0f || v > 1.0f)
-                goto edge_2_3;
-            DOOD[0]  = VMatrix[1][0] * v - VMatrix[2][0];
-            DOOD[1]  = VMatrix[1][2] * v - VMatrix[2][2];
-            invDenom = sqrtf(DOOD[0] * DOOD[0] + DOOD[1] * DOOD[1]);
-            offset   = invDenom - margin_radius;
-            if (offset > 0.0f)
-                goto edge_2_3;
-            invDenom = offset / invDenom;
-            positions[0] += (DOOD[0] *= invDenom);
-            positions[2] += (DOOD[1] *= invDenom);
-            margin_radius += 0.01f;
-
-            if (DOOD[0] * checkData->mNormal.x + DOOD[1] * checkData->mNormal.z < CornerThreshold * offset)
-                continue;
-            else
-                goto hasCollision;
-        }
+        {
+            bool isCorner = false;
 
-    edge_2_3:
-        // Edge 2-3
-        VMatrix[1][0] = (checkData->mVertices[2].x - checkData->mVertices[1].x);
-        VMatrix[2][0] = record->mPosition.x - checkData->mVertices[1].x;
-        VMatrix[1][1] = (checkData->mVertices[2].y - checkData->mVertices[1].y);
-        VMatrix[2][1] = record->mPosition.y - checkData->mVertices[1].y;
-        VMatrix[1][2] = (checkData->mVertices[2].z - checkData->mVertices[1].z);
-        VMatrix[2][2] = record->mPosition.z - checkData->mVertices[1].z;
-
-        if (VMatrix[1][1] != 0.0f) {
-            v = (VMatrix[2][1] / VMatrix[1][1]);
-            if (v < 0.0f || v > 1.0f)
-                continue;
-            DOOD[0]  = VMatrix[1][0] * v - VMatrix[2][0];
-            DOOD[1]  = VMatrix[1][2] * v - VMatrix[2][2];
-            invDenom = sqrtf(DOOD[0] * DOOD[0] + DOOD[1] * DOOD[1]);
-            offset   = invDenom - margin_radius;
-            if (offset > 0.0f)
-                continue;
-            invDenom = offset / invDenom;
-            positions[0] += (DOOD[0] *= invDenom);
-            positions[2] += (DOOD[1] *= invDenom);
-            margin_radius += 0.01f;
-            if (DOOD[0] * checkData->mNormal.x + DOOD[1] * checkData->mNormal.z < CornerThreshold * offset)
-                continue;
-            else
+            if (pushOutOfWallEdges<TVec3f>(*edgeData, checkData->mNormal.x, checkData->mNormal.z,
+                                           vertexA, vertexB, positions, origin, margin_radius,
+                                           isCorner)) {
+                if (isCorner)
+                    continue;
                 goto hasCollision;
-        } else
+            }
             continue;
+        }
 
     hasCollision:
         //! (Unreferenced Walls) Since this only returns the first four walls,
@@ -218,6 +256,97 @@ static size_t checkWallListExotic(const TBGCheckList *list, TBGWallCheckRecord *
     return numCols;
 }
 
+#define WALL_QUERY_BATCH_SIZE 256
+#define MOVE_WALL_STAMP_SIZE  128  // Must be a power of two
+
+// Moving walls have no fixed slot, so their stamps live in a small open addressed set where an
+// entry left by an older query counts as free
+struct TMoveWallStamp {
+    const TBGCheckData *mColTriangle;
+    u32 mQueryStamp;
+};
+
+static TBGCheckData *sWallQueryBatch[WALL_QUERY_BATCH_SIZE];
+static TMoveWallStamp sMoveWallStamps[MOVE_WALL_STAMP_SIZE];
+static u32 sWallQueryStamp = 0;
+
+static u32 nextWallQueryStamp() {
+    sWallQueryStamp += 1;
+    if (sWallQueryStamp == 0) {
+        // Wrapped around, stale stamps could now alias so clear them all
+        for (size_t i = 0; sWallEdgeTable && i < sWallEdgeTrisCount; ++i) {
+            if (sWallEdgeSlots[i] != WALL_EDGE_INVALID_SLOT)
+                sWallEdgeTable[sWallEdgeSlots[i]].mQueryStamp = 0;
+        }
+        memset(sMoveWallStamps, 0, sizeof(sMoveWallStamps));
+        sWallQueryStamp = 1;
+    }
+    return sWallQueryStamp;
+}
+
+// Returns false if this query already stamped the wall
+static bool stampWallQuery(const TBGCheckData *checkData, u32 stamp) {
+    if (TWallEdgeData *edgeData = getStaticWallEdgeData(checkData)) {
+        if (edgeData->mQueryStamp == stamp)
+            return false;
+        edgeData->mQueryStamp = stamp;
+        return true;
+    }
+
+    // A query only ever claims free entries, so a wall it stamped sits before the first free
+    // entry of its probe run
+    u32 slot = (reinterpret_cast<u32>(checkData) >> 4) & (MOVE_WALL_STAMP_SIZE - 1);
+    for (size_t i = 0; i < MOVE_WALL_STAMP_SIZE; ++i) {
+        TMoveWallStamp &entry = sMoveWallStamps[slot];
+        if (entry.mQueryStamp != stamp) {
+            entry.mColTriangle = checkData;
+            entry.mQueryStamp  = stamp;
+            return true;
+        }
+        if (entry.mColTriangle == checkData)
+            return false;
+        slot = (slot + 1) & (MOVE_WALL_STAMP_SIZE - 1);
+    }
+
+    // Every entry is taken by this query, solving the wall twice beats dropping it
+    return true;
+}
+
+// Fill the batch with the walls of `list` in the height band of `y` this query hasn't seen.
+// Returns where to continue once the batch is full, or nullptr once the list is done
+static const TBGCheckList *gatherWallCandidates(const TBGCheckList *list, f32 y, u32 stamp,
+                                                size_t &count) {
+    count = 0;
+    for (; list; list = list->mNextTriangle) {
+        if (count >= WALL_QUERY_BATCH_SIZE)
+            return list;
+
+        TBGCheckData *checkData = list->mColTriangle;
+        if (y < checkData->mMinHeight || y > checkData->mMaxHeight)
+            continue;
+
+        if (!stampWallQuery(checkData, stamp))
+            continue;
+
+        sWallQueryBatch[count++] = checkData;
+    }
+    return nullptr;
+}
+
+// Solve one cell list against the walls it adds to this query. Each list still starts from the
+// position the previous lists pushed the record to, like the unbatched solver did, and a list
+// with more walls than the batch holds is solved a batch at a time
+static size_t checkWallListBatched(const TBGCheckList *list, TBGWallCheckRecord *record,
+                                   u32 stamp) {
+    size_t wallsFound = 0;
+    do {
+        size_t count;
+        list = gatherWallCandidates(list, record->mPosition.y, stamp, count);
+        wallsFound += checkWallListExotic(sWallQueryBatch, count, record);
+    } while (list);
+    return wallsFound;
+}
+
 static size_t checkWallsExotic_(TMapCollisionData *collision, TBGWallCheckRecord *record,
                                 bool isExotic) {
     record->mNumWalls = 0;
@@ -275,22 +404,25 @@ static size_t checkWallsExotic_(TMapCollisionData *collision, TBGWallCheckRecord
             }
         }
     } else {
+        // Batched query, a wall spanning several cells is only solved once
+        const u32 stamp = nextWallQueryStamp();
+
         for (int cellX = cellMinX; cellX <= cellMaxX; ++cellX) {
             for (int cellZ = cellMinZ; cellZ <= cellMaxZ; ++cellZ) {
-                wallsFound += checkWallListExotic(
+                wallsFound += checkWallListBatched(
                     collision->mMoveCollisionRoot[cellX + (cellZ * collision->mBlockXCount)]
                         .mCheckList[TBGCheckListRoot::WALL]
                         .mNextTriangle,
-                    record);
+                    record, stamp);
 
                 if (wallsFound >= record->mCollideMax)
                     return wallsFound;
 
-                wallsFound += checkWallListExotic(
+                wallsFound += checkWallListBatched(
                     collision->mStaticCollisionRoot[cellX + (cellZ * collision->mBlockXCount)]
                         .mCheckList[TBGCheckListRoot::WALL]
                         .mNextTriangle,
-                    record);
+                    record, stamp);
 
                 if (wallsFound >= record->mCollideMax)
                     return wallsFound;
@@ -360,86 +492,16 @@ SMS_PATCH_B(SMS_PORT_REGION(0x802555FC, 0, 0, 0), checkWallPlaneEnhanced);
 
 static f32 patchedCheckGroundList(f32 x, f32 y, f32 z, u8 flags, const TBGCheckList *list,
                                   const TBGCheckData **out) {
-
-    TBGCheckData *checkData;
-    TBGCheckList *bgCheckNode;
-
     *out       = &TMapCollisionData::mIllegalCheckData;
     f32 exactY = -32767.0f;
 
     bool isCollisionRepaired = BetterSMS::isCollisionRepaired();
 
-    while (true) {
-        do {
-            if (!list)
-                return exactY;
-
-            checkData   = list->mColTriangle;
-            bgCheckNode = list->mNextTriangle;
-            list        = bgCheckNode;
-        } while (y < checkData->mMinHeight);
+    for (; list; list = list->mNextTriangle) {
+        const TBGCheckData *checkData = list->mColTriangle;
 
-        if ((flags & 0b100000) != 0) {  // Water Check
-            const u16 type = checkData->mType;
-            if ((type >= 0x100 && type < 0x104) || type == 0x4104) {
-                continue;
-            }
-        }
-
-        if (isCollisionRepaired && (flags & 0b10000)) {
-            if (checkData->isMarioThrough()) {
-                continue;
-            }
-        }
-
-        if (isCollisionRepaired && (flags & 0b1000)) {
-            const u16 type = checkData->mType;
-            if (!(type >= 0x100 && type < 0x106) && type != 0x4104) {
-                continue;
-            }
-        }
-
-        if ((flags & 0b100) != 0) {  // Pass through Check
-            const u16 type = checkData->mType;
-            if (type == 0x401 || type == 0x801 || type == 0x10A || type == 0x8400) {
-                continue;
-            }
-            if (isCollisionRepaired) {
-                if (type == 0x800)
-                    continue;
-            }
-        }
-
-        if ((flags & 0b1) != 0) {  // Water Check
-            const u16 type = checkData->mType;
-            if ((type >= 0x100 && type < 0x106) || type == 0x4104) {
-                continue;
-            }
-        }
-
-        const f32 ax = checkData->mVertices[0].x;
-        const f32 az = checkData->mVertices[0].z;
-        const f32 bz = checkData->mVertices[1].z;
-        const f32 bx = checkData->mVertices[1].x;
-
-        const bool abxCheck = -1.0f <= (az - z) * (bx - ax) - (ax - x) * (bz - az);
-
-        if (!abxCheck)
-            continue;
-
-        const f32 cz = checkData->mVertices[2].z;
-        const f32 cx = checkData->mVertices[2].x;
-
-        const bool bcxCheck = -1.0f <= (bz - z) * (cx - bx) - (bx - x) * (cz - bz);
-        const bool caxCheck = -1.0f <= (cz - z) * (ax - cx) - (cx - x) * (az - cz);
-
-        if (!(bcxCheck && caxCheck))
-            continue;
-
-        const f32 sampleExactY =
-            -(checkData->mProjectionFactor + x * checkData->mNormal.x + z * checkData->mNormal.z) /
-            checkData->mNormal.y;
-        if (y - (sampleExactY - 78.0f) < 0.0f)
+        f32 sampleExactY;
+        if (!isGroundPlaneHit(checkData, x, y, z, flags, isCollisionRepaired, sampleExactY))
             continue;
 
         if (sampleExactY > exactY) {
@@ -450,81 +512,27 @@ static f32 patchedCheckGroundList(f32 x, f32 y, f32 z, u8 flags, const TBGCheckL
         if (!isCollisionRepaired)
             return exactY;  // Return on first sample (default behavior)
     }
+
+    return exactY;
 }
 SMS_PATCH_B(SMS_PORT_REGION(0x8018C334, 0, 0, 0), patchedCheckGroundList);
 
 static f32 patchedCheckRoofList(f32 x, f32 y, f32 z, u8 flags, const TBGCheckList *list,
                                 const TBGCheckData **out) {
-
-    TBGCheckData *checkData;
-    TBGCheckList *bgCheckNode;
-
     bool isCollisionRepaired = BetterSMS::isCollisionRepaired();
 
-    while (true) {
-        if (!list) {
-            *out = &TMapCollisionData::mIllegalCheckData;
-            return 10000000.0f;
-        }
-
-        checkData   = list->mColTriangle;
-        bgCheckNode = list->mNextTriangle;
-        list        = bgCheckNode;
-
-        if (isCollisionRepaired && (flags & 8)) {
-            const u16 type = checkData->mType;
-            if (!(type >= 0x100 && type < 0x106) && type != 0x4104) {
-                continue;
-            }
-        }
-
-        if ((flags & 4)) {  // Pass through Check
-            const u16 type = checkData->mType;
-            if (type == 0x401 || type == 0x801 || type == 0x10A || type == 0x8400) {
-                continue;
-            }
-            if (isCollisionRepaired) {
-                if (type == 0x800)
-                    continue;
-            }
-        }
+    for (; list; list = list->mNextTriangle) {
+        const TBGCheckData *checkData = list->mColTriangle;
 
-        if (isCollisionRepaired && (flags & 1)) {  // Water Check
-            const u16 type = checkData->mType;
-            if ((type >= 0x100 && type < 0x106) || type == 0x4104) {
-                continue;
-            }
+        f32 exactY;
+        if (isRoofPlaneHit(checkData, x, y, z, flags, isCollisionRepaired, exactY)) {
+            *out = checkData;
+            return exactY;
         }
-
-        const f32 ax = checkData->mVertices[0].x;
-        const f32 az = checkData->mVertices[0].z;
-        const f32 bz = checkData->mVertices[1].z;
-        const f32 bx = checkData->mVertices[1].x;
-
-        const bool abxCheck = (az - z) * (bx - ax) - (ax - x) * (bz - az) <= 1.0f;
-
-        if (!abxCheck)
-            continue;
-
-        const f32 cz = checkData->mVertices[2].z;
-        const f32 cx = checkData->mVertices[2].x;
-
-        const bool bcxCheck = (bz - z) * (cx - bx) - (bx - x) * (cz - bz) <= 1.0f;
-        const bool caxCheck = (cz - z) * (ax - cx) - (cx - x) * (az - cz) <= 1.0f;
-
-        if (!(bcxCheck && caxCheck))
-            continue;
-
-        f32 exactY =
-            -(checkData->mProjectionFactor + x * checkData->mNormal.x + z * checkData->mNormal.z) /
-            checkData->mNormal.y;
-
-        if (y - (exactY + 78.0f) > 0.0f)
-            continue;
-
-        *out = checkData;
-        return exactY;
     }
+
+    *out = &TMapCollisionData::mIllegalCheckData;
+    return 10000000.0f;
 }
 SMS_PATCH_B(SMS_PORT_REGION(0x8018C628, 0, 0, 0), patchedCheckRoofList);
 
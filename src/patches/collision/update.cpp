@@ -266,11 +266,12 @@ static void filterMoveUpdates(TLiveActor *target) {
 // SMS_WRITE_32(SMS_PORT_REGION(0x801AFC00, 0, 0, 0), 0x60000000);
 // SMS_WRITE_32(SMS_PORT_REGION(0x801AFC04, 0, 0, 0), 0x60000000);
 
-static TProfiler profiler("MoveReset");
+extern void invalidateCollisionMemo();
+
+// Moving collision is rebuilt here every frame, so the water probe memo starts over as well
 static void profileMoveReset(TMapCollisionData *data) {
-    profiler.start();
+    BETTERSMS_PROFILE_ZONE("MoveReset");
     data->initMoveCollision();
-    profiler.stop();
-    profiler.report();
+    invalidateCollisionMemo();
 }
-// SMS_PATCH_BL(0x80189758, profileMoveReset);
\ No newline at end of file
+SMS_PATCH_BL(SMS_PORT_REGION(0x80189758, 0, 0, 0), profileMoveReset);
\ No newline at end of file
@@ -19,6 +19,7 @@
 
 #include "libs/geometry.hxx"
 #include "module.hxx"
+#include "p_plane_check.hxx"
 #include "p_settings.hxx"
 #include "player.hxx"
 
@@ -113,156 +114,332 @@ SMS_PATCH_BL(SMS_PORT_REGION(0x8024FB54, 0x802478E4, 0, 0), canDiePlane);
 SMS_WRITE_32(SMS_PORT_REGION(0x8024FB58, 0x802478E8, 0, 0), 0x2C030000);
 SMS_WRITE_32(SMS_PORT_REGION(0x8024FB5C, 0x802478EC, 0, 0), 0x41820084);
 
-static f32 findAnyRoofLikePlaneAbove(const TVec3f &position, TMapCollisionData &data,
-                                     u8 ignoreFlags, const TBGCheckData **out) {
+// One plane search direction of a fused column query
+struct TPlaneSearch {
+    f32 mY;
+    u8 mIgnoreFlags;
+};
+
+// Nearest roof-like plane above and ground-like plane below a column, found in one cell lookup
+struct TPlaneSearchResult {
+    f32 mRoofY;
+    const TBGCheckData *mRoof;
+    f32 mGroundY;
+    const TBGCheckData *mGround;
+};
+
+// The roof and ground lists go through checkRoofList/checkGroundList, and the wall lists use the
+// same per triangle tests, so the ignore flags, first hit and repaired collision rules all stay
+// those of patches/collision/search.cpp. Only the merge of the per-list results happens here.
+static void mergeRoofLikeHit(const TBGCheckData *potential, f32 potentialY,
+                             const TPlaneSearch &search, TPlaneSearchResult &result) {
+    if (potentialY < result.mRoofY && potentialY > search.mY) {
+        result.mRoof  = potential;
+        result.mRoofY = potentialY;
+    }
+}
+
+static void mergeGroundLikeHit(const TBGCheckData *potential, f32 potentialY,
+                               const TPlaneSearch &search, TPlaneSearchResult &result) {
+    if (potentialY > result.mGroundY && potentialY <= search.mY) {
+        result.mGround  = potential;
+        result.mGroundY = potentialY;
+    }
+}
+
+// Walls can be both roof-like and ground-like, so each wall list is walked once for both
+// searches. Each side keeps the hit its list check would have returned for the list alone
+static void mergeWallList(const TBGCheckList *list, f32 x, f32 z, const TPlaneSearch *roof,
+                          const TPlaneSearch *ground, TPlaneSearchResult &result) {
+    const bool isCollisionRepaired = BetterSMS::isCollisionRepaired();
+
+    const TBGCheckData *roofHit   = &TMapCollisionData::mIllegalCheckData;
+    const TBGCheckData *groundHit = &TMapCollisionData::mIllegalCheckData;
+    f32 roofY                     = 10000000.0f;
+    f32 groundY                   = -32767.0f;
+
+    bool isRoofOpen   = roof != nullptr;
+    bool isGroundOpen = ground != nullptr;
+
+    for (; list && (isRoofOpen || isGroundOpen); list = list->mNextTriangle) {
+        const TBGCheckData *checkData = list->mColTriangle;
+        f32 exactY;
+
+        if (isRoofOpen && isRoofPlaneHit(checkData, x, roof->mY, z, roof->mIgnoreFlags,
+                                         isCollisionRepaired, exactY)) {
+            roofHit    = checkData;
+            roofY      = exactY;
+            isRoofOpen = false;
+        }
+
+        if (isGroundOpen && isGroundPlaneHit(checkData, x, ground->mY, z, ground->mIgnoreFlags,
+                                             isCollisionRepaired, exactY)) {
+            if (exactY > groundY) {
+                groundHit = checkData;
+                groundY   = exactY;
+            }
+            isGroundOpen = isCollisionRepaired;  // Vanilla keeps the first hit
+        }
+    }
+
+    if (roof)
+        mergeRoofLikeHit(roofHit, roofY, *roof, result);
+
+    if (ground)
+        mergeGroundLikeHit(groundHit, groundY, *ground, result);
+}
+
+// Either search may be null. The static roof/ground list seeds the result as is, then the
+// moving list and both wall lists only replace it when they are closer on the right side
+static void findNearestPlanesInColumn_(f32 x, f32 z, TMapCollisionData &data,
+                                       const TPlaneSearch *roof, const TPlaneSearch *ground,
+                                       TPlaneSearchResult &result) {
     const f32 gridFraction = 1.0f / 1024.0f;
 
     const f32 boundsX = data.mAreaSizeX;
     const f32 boundsZ = data.mAreaSizeZ;
 
-    *out = &TMapCollisionData::mIllegalCheckData;
+    result.mRoof    = &TMapCollisionData::mIllegalCheckData;
+    result.mGround  = &TMapCollisionData::mIllegalCheckData;
+    result.mRoofY   = 0;
+    result.mGroundY = 0;
 
-    if (position.x < -boundsX || position.x >= boundsX)
-        return 0;
+    if (x < -boundsX || x >= boundsX)
+        return;
 
-    if (position.z < -boundsZ || position.z >= boundsZ)
-        return 0;
+    if (z < -boundsZ || z >= boundsZ)
+        return;
 
-    const int cellX = gridFraction * (position.x + boundsX);
-    const int cellZ = gridFraction * (position.z + boundsZ);
+    const int cellX = gridFraction * (x + boundsX);
+    const int cellZ = gridFraction * (z + boundsZ);
 
-    // Static roofs
-    f32 aboveY = data.checkRoofList(position.x, position.y, position.z, ignoreFlags,
-                                    data.mStaticCollisionRoot[cellX + (cellZ * data.mBlockXCount)]
-                                        .mCheckList[TBGCheckListRoot::ROOF]
-                                        .mNextTriangle,
-                                    out);
+    const s32 cell = cellX + (cellZ * data.mBlockXCount);
 
-    // Dynamic roofs
-    {
-        const TBGCheckData *potential;
-        f32 potentialY =
-            data.checkRoofList(position.x, position.y, position.z, ignoreFlags,
-                               data.mMoveCollisionRoot[cellX + (cellZ * data.mBlockXCount)]
-                                   .mCheckList[TBGCheckListRoot::ROOF]
-                                   .mNextTriangle,
-                               &potential);
+    TBGCheckListRoot &staticRoot = data.mStaticCollisionRoot[cell];
+    TBGCheckListRoot &moveRoot   = data.mMoveCollisionRoot[cell];
 
-        if (potentialY < aboveY && potentialY > position.y) {
-            *out   = potential;
-            aboveY = potentialY;
-        }
-    }
+    const TBGCheckData *potential;
+    f32 potentialY;
 
-    // Static walls
-    {
-        const TBGCheckData *potential;
-        f32 potentialY =
-            data.checkRoofList(position.x, position.y, position.z, ignoreFlags,
-                               data.mStaticCollisionRoot[cellX + (cellZ * data.mBlockXCount)]
-                                   .mCheckList[TBGCheckListRoot::WALL]
-                                   .mNextTriangle,
+    if (roof) {
+        result.mRoofY =
+            data.checkRoofList(x, roof->mY, z, roof->mIgnoreFlags,
+                               staticRoot.mCheckList[TBGCheckListRoot::ROOF].mNextTriangle,
+                               &result.mRoof);
+        potentialY =
+            data.checkRoofList(x, roof->mY, z, roof->mIgnoreFlags,
+                               moveRoot.mCheckList[TBGCheckListRoot::ROOF].mNextTriangle,
                                &potential);
+        mergeRoofLikeHit(potential, potentialY, *roof, result);
+    }
 
-        if (potentialY < aboveY && potentialY > position.y) {
-            *out   = potential;
-            aboveY = potentialY;
-        }
+    if (ground) {
+        result.mGroundY = data.checkGroundList(
+            x, ground->mY, z, ground->mIgnoreFlags,
+            staticRoot.mCheckList[TBGCheckListRoot::GROUND].mNextTriangle, &result.mGround);
+        potentialY = data.checkGroundList(
+            x, ground->mY, z, ground->mIgnoreFlags,
+            moveRoot.mCheckList[TBGCheckListRoot::GROUND].mNextTriangle, &potential);
+        mergeGroundLikeHit(potential, potentialY, *ground, result);
     }
 
-    // Dynamic walls
-    {
-        const TBGCheckData *potential;
-        f32 potentialY =
-            data.checkRoofList(position.x, position.y, position.z, ignoreFlags,
-                               data.mMoveCollisionRoot[cellX + (cellZ * data.mBlockXCount)]
-                                   .mCheckList[TBGCheckListRoot::WALL]
-                                   .mNextTriangle,
-                               &potential);
+    mergeWallList(staticRoot.mCheckList[TBGCheckListRoot::WALL].mNextTriangle, x, z, roof, ground,
+                  result);
+    mergeWallList(moveRoot.mCheckList[TBGCheckListRoot::WALL].mNextTriangle, x, z, roof, ground,
+                  result);
+}
 
-        if (potentialY < aboveY && potentialY > position.y) {
-            *out   = potential;
-            aboveY = potentialY;
-        }
-    }
+// -- PER FRAME PROBE MEMO -- //
+
+// The same columns are probed several times a frame by the player, camera and objects.
+// Slots are picked from a quantized position, but hits still require the exact same query
+#define COLLISION_MEMO_SIZE 32
+
+struct TColumnProbeMemo {
+    u32 mFrame;
+    const TMapCollisionData *mData;
+    f32 mX;
+    f32 mZ;
+    TPlaneSearch mRoof;
+    TPlaneSearch mGround;
+    u8 mSearchMask;
+    TPlaneSearchResult mResult;
+};
+
+struct TGroundProbeMemo {
+    u32 mFrame;
+    const TMapCollisionData *mData;
+    f32 mX;
+    f32 mY;
+    f32 mZ;
+    u8 mIgnoreFlags;
+    f32 mGroundY;
+    const TBGCheckData *mGround;
+};
+
+static TColumnProbeMemo sColumnProbeMemo[COLLISION_MEMO_SIZE];
+static TGroundProbeMemo sGroundProbeMemo[COLLISION_MEMO_SIZE];
+static u32 sCollisionMemoFrame = 1;
+
+u32 gCollisionMemoHits   = 0;
+u32 gCollisionMemoMisses = 0;
+
+// Called from the per frame move collision reset in patches/collision/update.cpp
+void invalidateCollisionMemo() {
+    sCollisionMemoFrame += 1;
+    if (sCollisionMemoFrame == 0)
+        sCollisionMemoFrame = 1;
+}
 
-    return aboveY;
+static u32 getCollisionMemoSlot(f32 x, f32 y, f32 z, u32 salt) {
+    const u32 qx = static_cast<u32>(static_cast<s32>(x * (1.0f / 16.0f)));
+    const u32 qy = static_cast<u32>(static_cast<s32>(y * (1.0f / 16.0f)));
+    const u32 qz = static_cast<u32>(static_cast<s32>(z * (1.0f / 16.0f)));
+    return ((qx * 73856093) ^ (qy * 19349663) ^ (qz * 83492791) ^ salt) % COLLISION_MEMO_SIZE;
 }
 
-static f32 findAnyGroundLikePlaneBelow(const TVec3f &position, TMapCollisionData &data,
-                                       u8 ignoreFlags, const TBGCheckData **out) {
-    const f32 gridFraction = 1.0f / 1024.0f;
+// Moving collision keeps registering into cells during the frame, after a probe could have been
+// memoized. Only columns without any of it in the searched lists are memoized, and a hit is only
+// served while that still holds, so a late registration always forces a fresh search.
+static bool isColumnFreeOfMoveCollision(const TMapCollisionData &data, f32 x, f32 z, bool roof,
+                                        bool ground, bool walls) {
+    if (x < -data.mAreaSizeX || x >= data.mAreaSizeX)
+        return true;
 
-    const f32 boundsX = data.mAreaSizeX;
-    const f32 boundsZ = data.mAreaSizeZ;
+    if (z < -data.mAreaSizeZ || z >= data.mAreaSizeZ)
+        return true;
 
-    *out = &TMapCollisionData::mIllegalCheckData;
-
-    if (position.x < -boundsX || position.x >= boundsX)
-        return 0;
-
-    if (position.z < -boundsZ || position.z >= boundsZ)
-        return 0;
-
-    const int cellX = gridFraction * (position.x + boundsX);
-    const int cellZ = gridFraction * (position.z + boundsZ);
-
-    // Static ground
-    f32 aboveY = data.checkGroundList(position.x, position.y, position.z, ignoreFlags,
-                                      data.mStaticCollisionRoot[cellX + (cellZ * data.mBlockXCount)]
-                                          .mCheckList[TBGCheckListRoot::GROUND]
-                                          .mNextTriangle,
-                                      out);
-
-    // Dynamic ground
-    {
-        const TBGCheckData *potential;
-        f32 potentialY =
-            data.checkGroundList(position.x, position.y, position.z, ignoreFlags,
-                                 data.mMoveCollisionRoot[cellX + (cellZ * data.mBlockXCount)]
-                                     .mCheckList[TBGCheckListRoot::GROUND]
-                                     .mNextTriangle,
-                                 &potential);
-
-        if (potentialY > aboveY && potentialY <= position.y) {
-            *out   = potential;
-            aboveY = potentialY;
-        }
-    }
+    const int cellX = (1.0f / 1024.0f) * (x + data.mAreaSizeX);
+    const int cellZ = (1.0f / 1024.0f) * (z + data.mAreaSizeZ);
 
-    // Static walls
-    {
-        const TBGCheckData *potential;
-        f32 potentialY =
-            data.checkGroundList(position.x, position.y, position.z, ignoreFlags,
-                                 data.mStaticCollisionRoot[cellX + (cellZ * data.mBlockXCount)]
-                                     .mCheckList[TBGCheckListRoot::WALL]
-                                     .mNextTriangle,
-                                 &potential);
+    const TBGCheckListRoot &moveRoot = data.mMoveCollisionRoot[cellX + (cellZ * data.mBlockXCount)];
 
-        if (potentialY > aboveY && potentialY <= position.y) {
-            *out   = potential;
-            aboveY = potentialY;
-        }
+    if (roof && moveRoot.mCheckList[TBGCheckListRoot::ROOF].mNextTriangle)
+        return false;
+
+    if (ground && moveRoot.mCheckList[TBGCheckListRoot::GROUND].mNextTriangle)
+        return false;
+
+    if (walls && moveRoot.mCheckList[TBGCheckListRoot::WALL].mNextTriangle)
+        return false;
+
+    return true;
+}
+
+static inline bool isSameSearch(const TPlaneSearch &a, const TPlaneSearch &b) {
+    return a.mY == b.mY && a.mIgnoreFlags == b.mIgnoreFlags;
+}
+
+static void findNearestPlanesInColumn(f32 x, f32 z, TMapCollisionData &data,
+                                      const TPlaneSearch *roof, const TPlaneSearch *ground,
+                                      TPlaneSearchResult &result) {
+    const u8 searchMask = (roof ? 1 : 0) | (ground ? 2 : 0);
+    const f32 keyY      = roof ? roof->mY : ground->mY;
+
+    const u32 salt = searchMask | ((roof ? roof->mIgnoreFlags : 0) << 2) |
+                     ((ground ? ground->mIgnoreFlags : 0) << 10);
+
+    if (!isColumnFreeOfMoveCollision(data, x, z, roof != nullptr, ground != nullptr, true)) {
+        gCollisionMemoMisses += 1;
+        findNearestPlanesInColumn_(x, z, data, roof, ground, result);
+        return;
     }
 
-    // Dynamic walls
-    {
-        const TBGCheckData *potential;
-        f32 potentialY =
-            data.checkGroundList(position.x, position.y, position.z, ignoreFlags,
-                                 data.mMoveCollisionRoot[cellX + (cellZ * data.mBlockXCount)]
-                                     .mCheckList[TBGCheckListRoot::WALL]
-                                     .mNextTriangle,
-                                 &potential);
+    TColumnProbeMemo &memo = sColumnProbeMemo[getCollisionMemoSlot(x, keyY, z, salt)];
+    if (memo.mFrame == sCollisionMemoFrame && memo.mData == &data && memo.mX == x &&
+        memo.mZ == z && memo.mSearchMask == searchMask &&
+        (!roof || isSameSearch(memo.mRoof, *roof)) &&
+        (!ground || isSameSearch(memo.mGround, *ground))) {
+        gCollisionMemoHits += 1;
+        result = memo.mResult;
+        return;
+    }
 
-        if (potentialY > aboveY && potentialY <= position.y) {
-            *out   = potential;
-            aboveY = potentialY;
-        }
+    gCollisionMemoMisses += 1;
+    findNearestPlanesInColumn_(x, z, data, roof, ground, result);
+
+    memo.mFrame      = sCollisionMemoFrame;
+    memo.mData       = &data;
+    memo.mX          = x;
+    memo.mZ          = z;
+    memo.mSearchMask = searchMask;
+    memo.mRoof       = roof ? *roof : TPlaneSearch{0.0f, 0};
+    memo.mGround     = ground ? *ground : TPlaneSearch{0.0f, 0};
+    memo.mResult     = result;
+}
+
+static f32 checkGroundMemoized(TMapCollisionData *data, f32 x, f32 y, f32 z, u8 ignoreFlags,
+                               const TBGCheckData **out) {
+    if (!isColumnFreeOfMoveCollision(*data, x, z, false, true, false)) {
+        gCollisionMemoMisses += 1;
+        return data->checkGround(x, y, z, ignoreFlags, out);
+    }
+
+    TGroundProbeMemo &memo = sGroundProbeMemo[getCollisionMemoSlot(x, y, z, ignoreFlags)];
+    if (memo.mFrame == sCollisionMemoFrame && memo.mData == data && memo.mX == x &&
+        memo.mY == y && memo.mZ == z && memo.mIgnoreFlags == ignoreFlags) {
+        gCollisionMemoHits += 1;
+        *out = memo.mGround;
+        return memo.mGroundY;
+    }
+
+    gCollisionMemoMisses += 1;
+    const f32 groundY = data->checkGround(x, y, z, ignoreFlags, out);
+
+    memo.mFrame       = sCollisionMemoFrame;
+    memo.mData        = data;
+    memo.mX           = x;
+    memo.mY           = y;
+    memo.mZ           = z;
+    memo.mIgnoreFlags = ignoreFlags;
+    memo.mGroundY     = groundY;
+    memo.mGround      = *out;
+    return groundY;
+}
+
+static f32 findAnyRoofLikePlaneAbove(const TVec3f &position, TMapCollisionData &data,
+                                     u8 ignoreFlags, const TBGCheckData **out) {
+    const TPlaneSearch roof = {position.y, ignoreFlags};
+
+    TPlaneSearchResult result;
+    findNearestPlanesInColumn(position.x, position.z, data, &roof, nullptr, result);
+
+    *out = result.mRoof;
+    return result.mRoofY;
+}
+
+static f32 findAnyGroundLikePlaneBelow(const TVec3f &position, TMapCollisionData &data,
+                                       u8 ignoreFlags, const TBGCheckData **out) {
+    const TPlaneSearch ground = {position.y, ignoreFlags};
+
+    TPlaneSearchResult result;
+    findNearestPlanesInColumn(position.x, position.z, data, nullptr, &ground, result);
+
+    *out = result.mGround;
+    return result.mGroundY;
+}
+
+// Roof above the sample and the topmost water of the column, shared by the water checks below.
+// The water under the roof is derived from the topmost water when it already lies below the roof,
+// which only holds while repaired ground searches keep the highest hit instead of the first
+static void findWaterColumnPlanes(const TVec3f &samplePosition, TMapCollisionData &data,
+                                  TPlaneSearchResult &column, f32 &waterBelowRoofY,
+                                  const TBGCheckData **waterBelowRoof) {
+    const TPlaneSearch roof   = {samplePosition.y, 0};
+    const TPlaneSearch ground = {10000000.0f, 8};
+
+    findNearestPlanesInColumn(samplePosition.x, samplePosition.z, data, &roof, &ground, column);
+
+    if (BetterSMS::isCollisionRepaired() &&
+        (column.mGround == &TMapCollisionData::mIllegalCheckData ||
+         column.mGroundY <= column.mRoofY - 1.0f)) {
+        *waterBelowRoof = column.mGround;
+        waterBelowRoofY = column.mGroundY;
+        return;
     }
 
-    return aboveY;
+    waterBelowRoofY = findAnyGroundLikePlaneBelow(
+        {samplePosition.x, column.mRoofY - 1.0f, samplePosition.z}, data, 8, waterBelowRoof);
 }
 
 // IMPORTANT: Does not always set the water pointer due to the nature of the function.
@@ -274,10 +451,11 @@ SMS_NO_INLINE static f32 enhanceWaterCheckPlayer_(TMario *player, f32 x, f32 y,
     const TBGCheckData *potential;
     f32 roofY, potentialY;
 
-    const TBGCheckData *roofPlane;
-    roofY      = findAnyRoofLikePlaneAbove(samplePosition, *map->mCollisionData, 0, &roofPlane);
-    potentialY = findAnyGroundLikePlaneBelow({samplePosition.x, roofY - 1.0f, samplePosition.z},
-                                             *map->mCollisionData, 8, &potential);
+    TPlaneSearchResult column;
+    findWaterColumnPlanes(samplePosition, *map->mCollisionData, column, potentialY, &potential);
+
+    const TBGCheckData *roofPlane = column.mRoof;
+    roofY                         = column.mRoofY;
 
     if (isColTypeWater(roofPlane->mType)) {
         // If it is ocean water let's just assume the player is in water
@@ -311,8 +489,8 @@ SMS_NO_INLINE static f32 enhanceWaterCheckPlayer_(TMario *player, f32 x, f32 y,
     } else if (considerCave) {
         // If there is no water beneath the roof, check if there is water above the player
         // (cave setting)
-        potentialY =
-            findAnyGroundLikePlaneBelow({x, 10000000.0f, z}, *map->mCollisionData, 8, &potential);
+        potentialY = column.mGroundY;
+        potential  = column.mGround;
         if (potential == &TMapCollisionData::mIllegalCheckData) {
             if (roofPlane == &TMapCollisionData::mIllegalCheckData) {
                 player->mWaterHeight = player->mFloorBelow;
@@ -325,8 +503,8 @@ SMS_NO_INLINE static f32 enhanceWaterCheckPlayer_(TMario *player, f32 x, f32 y,
         *water = potential;
         return Min(roofY + 100.0f, potentialY);
     } else {
-        potentialY =
-            findAnyGroundLikePlaneBelow({x, 10000000.0f, z}, *map->mCollisionData, 8, &potential);
+        potentialY = column.mGroundY;
+        potential  = column.mGround;
         roofY = findAnyRoofLikePlaneAbove(samplePosition, *map->mCollisionData, 1, &roofPlane);
         if (roofY > potentialY && potential != &TMapCollisionData::mIllegalCheckData) {
             *water = potential;
@@ -347,10 +525,11 @@ SMS_NO_INLINE f32 enhanceWaterCheckGeneric_(f32 x, f32 y, f32 z, bool considerCa
     const TBGCheckData *potential;
     f32 roofY, potentialY;
 
-    const TBGCheckData *roofPlane;
-    roofY      = findAnyRoofLikePlaneAbove(samplePosition, *map->mCollisionData, 0, &roofPlane);
-    potentialY = findAnyGroundLikePlaneBelow({samplePosition.x, roofY - 1.0f, samplePosition.z},
-                                             *map->mCollisionData, 8, &potential);
+    TPlaneSearchResult column;
+    findWaterColumnPlanes(samplePosition, *map->mCollisionData, column, potentialY, &potential);
+
+    const TBGCheckData *roofPlane = column.mRoof;
+    roofY                         = column.mRoofY;
 
     bool isRoofWater = roofPlane && isColTypeWater(roofPlane->mType);
     if (isRoofWater) {
@@ -380,8 +559,8 @@ SMS_NO_INLINE f32 enhanceWaterCheckGeneric_(f32 x, f32 y, f32 z, bool considerCa
     } else if (considerCave) {
         // If there is no water beneath the roof, check if there is water above the player
         // (cave setting)
-        potentialY =
-            findAnyGroundLikePlaneBelow({x, 10000000.0f, z}, *map->mCollisionData, 8, &potential);
+        potentialY = column.mGroundY;
+        potential  = column.mGround;
         if (potential == &TMapCollisionData::mIllegalCheckData) {
             // Prevent potential crash
             if (*water == &TMapCollisionData::mIllegalCheckData) {
@@ -393,8 +572,8 @@ SMS_NO_INLINE f32 enhanceWaterCheckGeneric_(f32 x, f32 y, f32 z, bool considerCa
         *water = potential;
         return Min(roofY, potentialY);
     } else {
-        potentialY =
-            findAnyGroundLikePlaneBelow({x, 10000000.0f, z}, *map->mCollisionData, 8, &potential);
+        potentialY = column.mGroundY;
+        potential  = column.mGround;
         roofY = findAnyRoofLikePlaneAbove(samplePosition, *map->mCollisionData, 1, &roofPlane);
         if (roofY > potentialY) {
             *water = potential;
@@ -443,8 +622,8 @@ static f32 enhanceWaterSurfaceRiding(f32 adjust, f32 groundHeight) {
     if (player->mFloorTriangle == player->mFloorTriangleWater) {
         const TBGCheckData *floor;
 
-        f32 height = gpMapCollisionData->checkGround(player->mTranslation.x, player->mTranslation.y,
-                                                     player->mTranslation.z, 1, &floor);
+        f32 height = checkGroundMemoized(gpMapCollisionData, player->mTranslation.x,
+                                         player->mTranslation.y, player->mTranslation.z, 1, &floor);
 
         if (floor != &gpMapCollisionData->mIllegalCheckData) {
             groundHeight = height;
@@ -464,7 +643,7 @@ static f32 enhanceCheckGroundPlaneForWater(TMap *map, f32 x, f32 y, f32 z,
     if (!BetterSMS::isCollisionRepaired()) {
         return map->checkGround(x, y, z, out);
     }
-    return map->mCollisionData->checkGround(x, y, z, 32, out);
+    return checkGroundMemoized(map->mCollisionData, x, y, z, 32, out);
 }
 SMS_PATCH_BL(SMS_PORT_REGION(0x802510E8, 0, 0, 0), enhanceCheckGroundPlaneForWater);
 SMS_PATCH_BL(SMS_PORT_REGION(0x80251168, 0, 0, 0), enhanceCheckGroundPlaneForWater);
@@ -473,7 +652,7 @@ static f32 enhanceMarioGroundPlaneCheck(TMap *map, f32 x, f32 y, f32 z, const TB
     if (!BetterSMS::isCollisionRepaired()) {
         return map->checkGround(x, y, z, out);
     }
-    return map->mCollisionData->checkGround(x, y, z, 16, out);
+    return checkGroundMemoized(map->mCollisionData, x, y, z, 16, out);
 }
 SMS_PATCH_BL(SMS_PORT_REGION(0x80250B54, 0, 0, 0), enhanceMarioGroundPlaneCheck);
 
@@ -725,6 +904,7 @@ SMS_PATCH_BL(SMS_PORT_REGION(0x801EA8F4, 0, 0, 0), fixWaterFilterHeightCalc);
 
 BETTER_SMS_FOR_CALLBACK void initializeMapObjWave(TMarDirector* director) {
     gpMapObjWave = nullptr;  // lol
+    invalidateCollisionMemo();
 }
 
 #endif
\ No newline at end of file
@@ -23,6 +23,7 @@
 
 #include "libs/constmath.hxx"
 #include "libs/global_unordered_map.hxx"
+#include "libs/object_pool.hxx"
 #include "libs/profiler.hxx"
 #include "libs/string.hxx"
 #include "libs/triangle.hxx"
@@ -30,6 +31,7 @@
 #include "libs/geometry.hxx"
 #include "logging.hxx"
 #include "module.hxx"
+#include "p_module.hxx"
 #include "p_settings.hxx"
 #include "player.hxx"
 #include "stage.hxx"
@@ -37,14 +39,21 @@
 using namespace BetterSMS;
 
 // Wrapper to fix void * problems with map.
-struct MarioData {
+#define MAX_PLAYER_DATA_KEYS 32
+
+// Bytes shared by the copies of interned key strings
+#define PLAYER_DATA_KEY_STORAGE_SIZE 1024
+
+// Interned module data key; handles index directly into MarioDataPair::mData
+struct MarioDataKey {
+    u32 mHash;
     const char *mKey;
-    void *mPtr;
 };
 
 struct MarioDataPair {
     TMario *mPlayer;
-    TGlobalVector<MarioData> mData;
+    Player::TPlayerData *mBetterSMSData;  // Direct slot so getData(player) never searches keys
+    void *mData[MAX_PLAYER_DATA_KEYS];
 };
 
 template <typename _I, typename _C> struct PhysicsMetaInfo {
@@ -56,14 +65,108 @@ template <typename _I, typename _C> struct PhysicsMetaInfo {
 
 static MarioDataPair sPlayerDatas[8];
 
-static Player::InitCallback sPlayerInitializers[128];
-static size_t sPlayerInitializersSize = 0;
+// The engine's own player data is rebuilt every stage load, so it comes from a pool whose
+// chunks stay on the system heap instead of a fresh stage heap block per player each time
+static TChunkedObjectPool<Player::TPlayerData, 2> sPlayerDataPool("Player Data");
+static Player::TPlayerData *sPooledPlayerDatas[8];
+static size_t sPooledPlayerDatasSize = 0;
+
+static MarioDataKey sPlayerDataKeys[MAX_PLAYER_DATA_KEYS] = {
+    {0x410CE547, "__better_sms"}  // FNV-1a of the key, see hashPlayerDataKey
+};
+static size_t sPlayerDataKeysSize = 1;
+
+// Callers may pass keys from temporary buffers, so the table only points into its own copies
+static char sPlayerDataKeyStorage[PLAYER_DATA_KEY_STORAGE_SIZE];
+static size_t sPlayerDataKeyStorageSize = 0;
+
+// Densely packed callback list, ordered by descending priority (ties keep registration order)
+template <typename _C, size_t _N> class TPlayerCallbackList {
+public:
+    struct CallbackInfo {
+        _C mCallback;
+        s32 mPriority;
+        bool mIsEnabled;
+        Player::CallbackCost mCost;
+        s16 mCostSlot;
+    };
+
+    TPlayerCallbackList(const char *hook) : mHook(hook), mSize(0) {}
+
+    size_t size() const { return mSize; }
+
+    bool add(_C callback, s32 priority) {
+        if (mSize >= _N || callback == nullptr)
+            return false;
+
+        size_t index = mSize;
+        while (index > 0 && mInfos[index - 1].mPriority < priority) {
+            mInfos[index] = mInfos[index - 1];
+            index -= 1;
+        }
+        mInfos[index] = {callback, priority, true, {0, 0, 0},
+                         registerCallbackCost(reinterpret_cast<const void *>(callback), mHook)};
+        mSize += 1;
+        return true;
+    }
+
+    bool setEnabled(_C callback, bool enabled) {
+        CallbackInfo *info = find(callback);
+        if (!info)
+            return false;
+        info->mIsEnabled = enabled;
+        return true;
+    }
+
+    const Player::CallbackCost *getCost(_C callback) const {
+        const CallbackInfo *info = find(callback);
+        return info ? &info->mCost : nullptr;
+    }
+
+    template <typename... _Args> void dispatch(_Args... args) {
+        for (size_t i = 0; i < mSize; ++i) {
+            CallbackInfo &info = mInfos[i];
+            if (!info.mIsEnabled)
+                continue;
 
-static Player::LoadAfterCallback sPlayerLoadAfterCBs[128];
-static size_t sPlayerLoadAfterCBsSize = 0;
+            const OSTick start = OSGetTick();
+            info.mCallback(args...);
+            const u32 ticks = OSDiffTick(OSGetTick(), start);
 
-static Player::UpdateCallback sPlayerUpdaters[128];
-static size_t sPlayerUpdatersSize = 0;
+            info.mCost.mLastTicks = ticks;
+            info.mCost.mPeakTicks = Max(info.mCost.mPeakTicks, ticks);
+            info.mCost.mCallCount += 1;
+
+            recordCallbackCost(info.mCostSlot, ticks);
+        }
+    }
+
+private:
+    CallbackInfo *find(_C callback) {
+        for (size_t i = 0; i < mSize; ++i) {
+            if (mInfos[i].mCallback == callback)
+                return &mInfos[i];
+        }
+        return nullptr;
+    }
+
+    const CallbackInfo *find(_C callback) const {
+        for (size_t i = 0; i < mSize; ++i) {
+            if (mInfos[i].mCallback == callback)
+                return &mInfos[i];
+        }
+        return nullptr;
+    }
+
+    const char *mHook;
+    CallbackInfo mInfos[_N];
+    size_t mSize;
+};
+
+static TPlayerCallbackList<Player::InitCallback, MAX_CALLBACKS> sPlayerInitializers("Player::Init");
+static TPlayerCallbackList<Player::LoadAfterCallback, MAX_CALLBACKS>
+    sPlayerLoadAfterCBs("Player::LoadAfter");
+static TPlayerCallbackList<Player::UpdateCallback, MAX_CALLBACKS> sPlayerUpdaters("Player::Update");
 
 static PhysicsMetaInfo<u32, Player::ReceiveMessageCallback> sPlayerMessageCBs[128];
 static size_t sPlayerMessageCBsSize = 0;
@@ -74,46 +177,86 @@ static size_t sPlayerStateMachinesSize = 0;
 static PhysicsMetaInfo<u16, Player::CollisionCallback> sPlayerCollisionHandlers[128];
 static size_t sPlayerCollisionHandlersSize = 0;
 
-BETTER_SMS_FOR_EXPORT Player::TPlayerData *BetterSMS::Player::getData(TMario *player) {
-    TPlayerData *data = nullptr;
+// FNV-1a, only evaluated when a key is resolved to a handle
+static u32 hashPlayerDataKey(const char *key) {
+    u32 hash = 0x811C9DC5;
+    while (*key) {
+        hash ^= static_cast<u8>(*key++);
+        hash *= 0x01000193;
+    }
+    return hash;
+}
 
+static Player::DataHandle findPlayerDataHandle(const char *key, u32 hash) {
+    for (size_t i = 0; i < sPlayerDataKeysSize; ++i) {
+        if (sPlayerDataKeys[i].mHash == hash && strcmp(sPlayerDataKeys[i].mKey, key) == 0)
+            return i;
+    }
+    return Player::InvalidDataHandle;
+}
+
+static MarioDataPair *findPlayerDataPair(TMario *player) {
     for (size_t i = 0; i < 8; ++i) {
-        if (sPlayerDatas[i].mPlayer != player) {
-            continue;
-        }
-        for (const MarioData &item : sPlayerDatas[i].mData) {
-            if (strcmp(item.mKey, "__better_sms") == 0) {
-                data = reinterpret_cast<Player::TPlayerData *>(item.mPtr);
-                goto AfterSearch;
-            }
-        }
+        if (sPlayerDatas[i].mPlayer == player)
+            return &sPlayerDatas[i];
     }
+    return nullptr;
+}
 
-AfterSearch:
-    if (!data) {
+BETTER_SMS_FOR_EXPORT Player::DataHandle BetterSMS::Player::getDataHandle(const char *key) {
+    const u32 hash = hashPlayerDataKey(key);
+
+    DataHandle handle = findPlayerDataHandle(key, hash);
+    if (handle != InvalidDataHandle)
+        return handle;
+
+    if (sPlayerDataKeysSize >= MAX_PLAYER_DATA_KEYS) {
+        Console::debugLog("Player data key table is full! (%s)\n", key);
+        return InvalidDataHandle;
+    }
+
+    const size_t keySize = strlen(key) + 1;
+    if (sPlayerDataKeyStorageSize + keySize > PLAYER_DATA_KEY_STORAGE_SIZE) {
+        Console::debugLog("Player data key storage is full! (%s)\n", key);
+        return InvalidDataHandle;
+    }
+
+    char *keyCopy = sPlayerDataKeyStorage + sPlayerDataKeyStorageSize;
+    memcpy(keyCopy, key, keySize);
+    sPlayerDataKeyStorageSize += keySize;
+
+    handle                        = sPlayerDataKeysSize++;
+    sPlayerDataKeys[handle].mHash = hash;
+    sPlayerDataKeys[handle].mKey  = keyCopy;
+    return handle;
+}
+
+BETTER_SMS_FOR_EXPORT Player::TPlayerData *BetterSMS::Player::getData(TMario *player) {
+    MarioDataPair *pair = findPlayerDataPair(player);
+    if (!pair || !pair->mBetterSMSData) {
         Console::debugLog(
             "Trying to access BetterSMS player data that is not registered! (No Data)\n");
+        return nullptr;
     }
 
-    return data;
+    return pair->mBetterSMSData;
+}
+
+BETTER_SMS_FOR_EXPORT void *BetterSMS::Player::getData(TMario *player, DataHandle handle) {
+    if (handle >= sPlayerDataKeysSize)
+        return nullptr;
+
+    MarioDataPair *pair = findPlayerDataPair(player);
+    return pair ? pair->mData[handle] : nullptr;
 }
 
 BETTER_SMS_FOR_EXPORT void *BetterSMS::Player::getRegisteredData(TMario *player, const char *key) {
-    TPlayerData *data = nullptr;
+    void *data = nullptr;
 
-    for (size_t i = 0; i < 8; ++i) {
-        if (sPlayerDatas[i].mPlayer != player) {
-            continue;
-        }
-        for (const MarioData &item : sPlayerDatas[i].mData) {
-            if (strcmp(item.mKey, key) == 0) {
-                data = reinterpret_cast<Player::TPlayerData *>(item.mPtr);
-                goto AfterSearch;
-            }
-        }
-    }
+    DataHandle handle = findPlayerDataHandle(key, hashPlayerDataKey(key));
+    if (handle != InvalidDataHandle)
+        data = getData(player, handle);
 
-AfterSearch:
     if (!data) {
         Console::debugLog("Trying to access player data (%s) that is not registered!\n", key);
     }
@@ -124,39 +267,44 @@ AfterSearch:
 // Register arbitrary module data for a player
 BETTER_SMS_FOR_EXPORT bool BetterSMS::Player::registerData(TMario *player, const char *key,
                                                            void *data) {
-    for (size_t i = 0; i < 8; ++i) {
-        if (sPlayerDatas[i].mPlayer == player) {
-            for (const MarioData &item : sPlayerDatas[i].mData) {
-                if (strcmp(item.mKey, key) == 0) {
-                    Console::debugLog("Player data (%s) already exists!\n", key);
-                    return false;
-                }
-            }
-            sPlayerDatas[i].mData.push_back({key, data});
-        }
-        if (sPlayerDatas[i].mPlayer == nullptr) {
-            sPlayerDatas[i].mPlayer = player;
-            sPlayerDatas[i].mData   = {};
-            sPlayerDatas[i].mData.push_back({key, data});
-            return true;
-        }
+    DataHandle handle = getDataHandle(key);
+    if (handle == InvalidDataHandle)
+        return false;
+
+    MarioDataPair *pair = findPlayerDataPair(player);
+    if (!pair) {
+        pair = findPlayerDataPair(nullptr);
+        if (!pair)
+            return false;
+        pair->mPlayer        = player;
+        pair->mBetterSMSData = nullptr;
+        memset(pair->mData, 0, sizeof(pair->mData));
     }
-    return false;
+
+    if (pair->mData[handle]) {
+        Console::debugLog("Player data (%s) already exists!\n", key);
+        return false;
+    }
+
+    pair->mData[handle] = data;
+    if (handle == BetterSMSDataHandle)
+        pair->mBetterSMSData = reinterpret_cast<TPlayerData *>(data);
+
+    return true;
 }
 
 BETTER_SMS_FOR_EXPORT void BetterSMS::Player::deregisterData(TMario *player, const char *key) {
-    for (size_t i = 0; i < 8; ++i) {
-        if (sPlayerDatas[i].mPlayer != player) {
-            continue;
-        }
+    DataHandle handle = findPlayerDataHandle(key, hashPlayerDataKey(key));
+    if (handle == InvalidDataHandle)
+        return;
 
-        for (auto it = sPlayerDatas[i].mData.begin(); it != sPlayerDatas[i].mData.end(); ++it) {
-            if (strcmp(it->mKey, key) == 0) {
-                sPlayerDatas[i].mData.erase(it);
-                return;
-            }
-        }
-    }
+    MarioDataPair *pair = findPlayerDataPair(player);
+    if (!pair)
+        return;
+
+    pair->mData[handle] = nullptr;
+    if (handle == BetterSMSDataHandle)
+        pair->mBetterSMSData = nullptr;
 }
 
 constexpr size_t MarioAnimeDataSize = 336;
@@ -290,18 +438,60 @@ BETTER_SMS_FOR_EXPORT bool BetterSMS::Player::addAnimationDataEx(u16 anm_idx, co
 }
 
 BETTER_SMS_FOR_EXPORT bool BetterSMS::Player::addInitCallback(InitCallback process) {
-    sPlayerInitializers[sPlayerInitializersSize++] = process;
-    return true;
+    return sPlayerInitializers.add(process, 0);
+}
+
+BETTER_SMS_FOR_EXPORT bool BetterSMS::Player::addInitCallback(InitCallback process,
+                                                              s32 priority) {
+    return sPlayerInitializers.add(process, priority);
 }
 
 BETTER_SMS_FOR_EXPORT bool BetterSMS::Player::addLoadAfterCallback(LoadAfterCallback process) {
-    sPlayerLoadAfterCBs[sPlayerLoadAfterCBsSize++] = process;
-    return true;
+    return sPlayerLoadAfterCBs.add(process, 0);
+}
+
+BETTER_SMS_FOR_EXPORT bool BetterSMS::Player::addLoadAfterCallback(LoadAfterCallback process,
+                                                                   s32 priority) {
+    return sPlayerLoadAfterCBs.add(process, priority);
 }
 
 BETTER_SMS_FOR_EXPORT bool BetterSMS::Player::addUpdateCallback(UpdateCallback process) {
-    sPlayerUpdaters[sPlayerUpdatersSize++] = process;
-    return true;
+    return sPlayerUpdaters.add(process, 0);
+}
+
+BETTER_SMS_FOR_EXPORT bool BetterSMS::Player::addUpdateCallback(UpdateCallback process,
+                                                                s32 priority) {
+    return sPlayerUpdaters.add(process, priority);
+}
+
+BETTER_SMS_FOR_EXPORT bool BetterSMS::Player::setInitCallbackEnabled(InitCallback process,
+                                                                     bool enabled) {
+    return sPlayerInitializers.setEnabled(process, enabled);
+}
+
+BETTER_SMS_FOR_EXPORT bool
+BetterSMS::Player::setLoadAfterCallbackEnabled(LoadAfterCallback process, bool enabled) {
+    return sPlayerLoadAfterCBs.setEnabled(process, enabled);
+}
+
+BETTER_SMS_FOR_EXPORT bool BetterSMS::Player::setUpdateCallbackEnabled(UpdateCallback process,
+                                                                       bool enabled) {
+    return sPlayerUpdaters.setEnabled(process, enabled);
+}
+
+BETTER_SMS_FOR_EXPORT const Player::CallbackCost *
+BetterSMS::Player::getInitCallbackCost(InitCallback process) {
+    return sPlayerInitializers.getCost(process);
+}
+
+BETTER_SMS_FOR_EXPORT const Player::CallbackCost *
+BetterSMS::Player::getLoadAfterCallbackCost(LoadAfterCallback process) {
+    return sPlayerLoadAfterCBs.getCost(process);
+}
+
+BETTER_SMS_FOR_EXPORT const Player::CallbackCost *
+BetterSMS::Player::getUpdateCallbackCost(UpdateCallback process) {
+    return sPlayerUpdaters.getCost(process);
 }
 
 BETTER_SMS_FOR_EXPORT bool BetterSMS::Player::addMessageCallback(u32 message, ReceiveMessageCallback process) {
@@ -309,37 +499,74 @@ BETTER_SMS_FOR_EXPORT bool BetterSMS::Player::addMessageCallback(u32 message, Re
     return true;
 }
 
+// Insert into a table kept sorted by ID, after any existing entries of the same ID so
+// handlers sharing a key dispatch in registration order
+template <typename _I, typename _C>
+static bool insertSortedMetaInfo(PhysicsMetaInfo<_I, _C> *table, size_t &size, _I id,
+                                 _C callback) {
+    if (size >= MAX_CALLBACKS)
+        return false;
+
+    size_t index = size;
+    while (index > 0 && table[index - 1].mID > id) {
+        table[index] = table[index - 1];
+        index -= 1;
+    }
+    table[index] = {id, callback};
+    size += 1;
+    return true;
+}
+
+// Binary search for the first entry of `id`, returns `size` if there is none
+template <typename _I, typename _C>
+static size_t findSortedMetaInfo(const PhysicsMetaInfo<_I, _C> *table, size_t size, _I id) {
+    size_t lo = 0;
+    size_t hi = size;
+    while (lo < hi) {
+        const size_t mid = (lo + hi) / 2;
+        if (table[mid].mID < id)
+            lo = mid + 1;
+        else
+            hi = mid;
+    }
+    return (lo < size && table[lo].mID == id) ? lo : size;
+}
+
 BETTER_SMS_FOR_EXPORT bool BetterSMS::Player::registerStateMachine(u32 state,
                                                                    MachineCallback process) {
+    if (!process) {
+        Console::log("[WARNING] State machine 0x%X was registered without a callback!\n", state);
+        return false;
+    }
     if ((state & 0x1C0) != 0x1C0) {
         Console::log("[WARNING] State machine 0x%X isn't ORd with 0x1C0 (Prevents "
                      "engine collisions)!\n",
                      state);
     }
-    for (auto &item : sPlayerStateMachines) {
-        if (item.mID == state) {
-            Console::log("[WARNING] State machine 0x%X already exists!\n", state);
-            return false;
-        }
+    if (!insertSortedMetaInfo(sPlayerStateMachines, sPlayerStateMachinesSize, state, process)) {
+        Console::log("[WARNING] State machine 0x%X exceeds the handler capacity!\n", state);
+        return false;
     }
-    sPlayerStateMachines[sPlayerStateMachinesSize++] = {state, process};
     return true;
 }
 
 BETTER_SMS_FOR_EXPORT bool BetterSMS::Player::registerCollisionHandler(u16 colType,
                                                                        CollisionCallback process) {
+    if (!process) {
+        Console::log("[WARNING] Collision type 0x%X was registered without a callback!\n",
+                     colType);
+        return false;
+    }
     if ((colType & 0xC000) != 0) {
         Console::log("[WARNING] Collision type 0x%X has camera clip and shadow flags set "
                      "(0x4000 || 0x8000)! This may cause unwanted behaviour!\n",
                      colType);
     }
-    for (auto &item : sPlayerCollisionHandlers) {
-        if (item.mID == colType) {
-            Console::log("[WARNING] Collision type 0x%X already exists!\n", colType);
-            return false;
-        }
+    if (!insertSortedMetaInfo(sPlayerCollisionHandlers, sPlayerCollisionHandlersSize, colType,
+                              process)) {
+        Console::log("[WARNING] Collision type 0x%X exceeds the handler capacity!\n", colType);
+        return false;
     }
-    sPlayerCollisionHandlers[sPlayerCollisionHandlersSize++] = {colType, process};
     return true;
 }
 
@@ -757,7 +984,18 @@ MActor *createMActorForModel(MActorAnmData *anmData, J3DModel *model, f32 config
 BETTER_SMS_FOR_CALLBACK void initMario(TMario *player, bool isMario) {
     Stage::TStageParams *config = Stage::getStageConfiguration();
 
-    Player::TPlayerData *params = new Player::TPlayerData(player, nullptr, isMario);
+    if (sPooledPlayerDatasSize >= 8) {
+        Console::debugLog("Player data pool is full! Skipping player init.\n");
+        return;
+    }
+
+    Player::TPlayerData *params = sPlayerDataPool.construct(player, nullptr, isMario);
+    if (!params) {
+        Console::debugLog("Failed to allocate player data! Skipping player init.\n");
+        return;
+    }
+    sPooledPlayerDatas[sPooledPlayerDatasSize++] = params;
+
     Player::registerData(player, "__better_sms", params);
 
     for (int i = 0; i < 10; ++i) {
@@ -854,9 +1092,15 @@ BETTER_SMS_FOR_CALLBACK void initMario(TMario *player, bool isMario) {
 }
 
 BETTER_SMS_FOR_CALLBACK void resetPlayerDatas(TMarDirector *application) {
+    for (size_t i = 0; i < sPooledPlayerDatasSize; ++i) {
+        sPlayerDataPool.destroy(sPooledPlayerDatas[i]);
+    }
+    sPooledPlayerDatasSize = 0;
+
     for (size_t i = 0; i < 8; ++i) {
-        sPlayerDatas[i].mPlayer = nullptr;
-        sPlayerDatas[i].mData.clear();
+        sPlayerDatas[i].mPlayer        = nullptr;
+        sPlayerDatas[i].mBetterSMSData = nullptr;
+        memset(sPlayerDatas[i].mData, 0, sizeof(sPlayerDatas[i].mData));
     }
 }
 
@@ -864,12 +1108,9 @@ static TMario *playerInitHandler(TMario *player) {
     player->initValues();
 
     initMario(player, true);
-
-    for (auto &item : sPlayerInitializers) {
-        if (item == nullptr) {
-            continue;
-        }
-        item(player, true);
+    {
+        BETTERSMS_PROFILE_ZONE("Player::Init");
+        sPlayerInitializers.dispatch(player, true);
     }
 
     return player;
@@ -883,12 +1124,9 @@ static bool shadowMarioInitHandler() {
     SMS_ASM_BLOCK("lwz %0, 0x150 (31)" : "=r"(player));
 
     initMario(player, false);
-
-    for (auto &item : sPlayerInitializers) {
-        if (item == nullptr) {
-            continue;
-        }
-        item(player, false);
+    {
+        BETTERSMS_PROFILE_ZONE("Player::Init");
+        sPlayerInitializers.dispatch(player, false);
     }
 
     return SMS_isMultiPlayerMap__Fv();
@@ -898,21 +1136,15 @@ SMS_PATCH_BL(SMS_PORT_REGION(0x800397DC, 0x80039894, 0, 0), shadowMarioInitHandl
 static void playerLoadAfterHandler(TMario *player) {
     player->initMirrorModel();
 
-    for (auto &item : sPlayerLoadAfterCBs) {
-        if (item == nullptr) {
-            continue;
-        }
-        item(player);
-    }
+    BETTERSMS_PROFILE_ZONE("Player::LoadAfter");
+    sPlayerLoadAfterCBs.dispatch(player);
 }
 SMS_PATCH_BL(SMS_PORT_REGION(0x80276BB8, 0, 0, 0), playerLoadAfterHandler);
 
 static void playerUpdateHandler(TMario *player, JDrama::TGraphics *graphics) {
-    for (auto &item : sPlayerUpdaters) {
-        if (item == nullptr) {
-            continue;
-        }
-        item(player, true);
+    {
+        BETTERSMS_PROFILE_ZONE("Player::Update");
+        sPlayerUpdaters.dispatch(player, true);
     }
 
     auto *params = Player::getData(player);
@@ -933,6 +1165,7 @@ bool playerReceiveMessage(TMario *player, THitActor *sender, u32 flags) {
 
     u32 objId = sender->mObjectID;
 
+    BETTERSMS_PROFILE_ZONE("Player::ReceiveMessage");
     for (auto &item : sPlayerMessageCBs) {
         if (item.mID != objId) {
             continue;
@@ -981,11 +1214,9 @@ SMS_WRITE_32(SMS_PORT_REGION(0x802423b4, 0, 0, 0), 0x3c801130);  // diver_helm
 SMS_WRITE_32(SMS_PORT_REGION(0x802423f0, 0, 0, 0), 0x3c801130);  // ma_glass1
 
 static void shadowMarioUpdateHandler(TMario *player, JDrama::TGraphics *graphics) {
-    for (auto &item : sPlayerUpdaters) {
-        if (item == nullptr) {
-            continue;
-        }
-        item(player, false);
+    {
+        BETTERSMS_PROFILE_ZONE("Player::Update");
+        sPlayerUpdaters.dispatch(player, false);
     }
 
     player->playerControl(graphics);
@@ -993,20 +1224,32 @@ static void shadowMarioUpdateHandler(TMario *player, JDrama::TGraphics *graphics
 SMS_PATCH_BL(SMS_PORT_REGION(0x8003F8E8, 0x8003F740, 0, 0), shadowMarioUpdateHandler);  // EMario
 
 static bool stateMachineHandler(TMario *player) {
-    auto currentState = player->mState;
+    const u32 currentState = player->mState;
 
+    BETTERSMS_PROFILE_ZONE("Player::Machine");
     bool shouldProgressState = true;
-    for (auto &item : sPlayerStateMachines) {
-        if (item.mID == currentState && item.mCallback != nullptr) {
-            shouldProgressState = item.mCallback(player);
+    for (size_t i = findSortedMetaInfo(sPlayerStateMachines, sPlayerStateMachinesSize,
+                                       currentState);
+         i < sPlayerStateMachinesSize && sPlayerStateMachines[i].mID == currentState; ++i) {
+        shouldProgressState = sPlayerStateMachines[i].mCallback(player);
+        if (!shouldProgressState)
             break;
-        }
     }
 
     return shouldProgressState;
 }
 SMS_PATCH_BL(SMS_PORT_REGION(0x802500B8, 0, 0, 0), stateMachineHandler);
 
+static void dispatchCollisionHandlers(u16 colType, TMario *player, const TBGCheckData *data,
+                                      u32 flags) {
+    BETTERSMS_PROFILE_ZONE("Player::Collision");
+    for (size_t i = findSortedMetaInfo(sPlayerCollisionHandlers, sPlayerCollisionHandlersSize,
+                                       colType);
+         i < sPlayerCollisionHandlersSize && sPlayerCollisionHandlers[i].mID == colType; ++i) {
+        sPlayerCollisionHandlers[i].mCallback(player, data, flags);
+    }
+}
+
 static u32 collisionHandler(TMario *player) {
     auto *playerData = Player::getData(player);
 
@@ -1031,27 +1274,17 @@ static u32 collisionHandler(TMario *player) {
     }
 
     if (colType != prevColType) {
-        // Here we keep the loops apart as to force exit callbacks before enter callbacks
-        for (auto &item : sPlayerCollisionHandlers) {
-            if (item.mID == prevColType && item.mCallback != nullptr)
-                item.mCallback(player, const_cast<TBGCheckData *>(playerData->mPrevCollisionFloor),
-                               marioFlags | Player::InteractionFlags::ON_EXIT);
-        }
-        for (auto &item : sPlayerCollisionHandlers) {
-            if (item.mID == colType && item.mCallback != nullptr)
-                item.mCallback(player, const_cast<TBGCheckData *>(player->mFloorTriangle),
-                               marioFlags | Player::InteractionFlags::ON_ENTER);
-        }
+        // Exit callbacks are forced to run before enter callbacks
+        dispatchCollisionHandlers(prevColType, player, playerData->mPrevCollisionFloor,
+                                  marioFlags | Player::InteractionFlags::ON_EXIT);
+        dispatchCollisionHandlers(colType, player, player->mFloorTriangle,
+                                  marioFlags | Player::InteractionFlags::ON_ENTER);
         playerData->mPrevCollisionFloorType     = colType;
         playerData->mPrevCollisionFloor         = player->mFloorTriangle;
         playerData->mCollisionFlags.mIsFaceUsed = false;
         playerData->mCollisionTimer             = 0;
     } else if (colType >= 3000) {  // Custom collision is routinely updated
-        for (auto &item : sPlayerCollisionHandlers) {
-            if (item.mID == colType && item.mCallback != nullptr)
-                item.mCallback(player, const_cast<TBGCheckData *>(player->mFloorTriangle),
-                               marioFlags);
-        }
+        dispatchCollisionHandlers(colType, player, player->mFloorTriangle, marioFlags);
     }
 
     /*TSMSFader *fader = gpApplication.mFader;
@@ -0,0 +1,356 @@
+#include <Dolphin/OS.h>
+#include <Dolphin/string.h>
+#include <Dolphin/types.h>
+#include <JSystem/JKernel/JKRHeap.hxx>
+#include <SMS/System/Application.hxx>
+#include <SMS/macros.h>
+
+#include "libs/lock.hxx"
+#include "libs/profiler.hxx"
+#include "module.hxx"
+
+#include "p_profiler.hxx"
+
+using namespace BetterSMS;
+
+// Each thread writes begin/end ticks into its own single producer ring, which the game loop
+// drains once per frame. Producers never take a lock; only claiming a ring for a thread that
+// hasn't profiled anything yet is done with interrupts disabled.
+
+#define PROFILE_RING_SIZE    512  // Must be a power of two
+#define PROFILE_HISTORY_SIZE 1024
+#define PROFILE_STAT_WINDOW  60
+
+// A null name closes the innermost zone
+struct ProfileEvent {
+    const char *mName;
+    u32 mTick;
+};
+
+struct ProfileTraceEvent {
+    const char *mName;
+    u32 mTick;
+    u8 mThread;
+};
+
+struct ProfileOpenZone {
+    s16 mZone;
+    u32 mStart;
+};
+
+struct ProfileRing {
+    OSThread *mThread;
+    ProfileEvent *mEvents;
+
+    // Producer side
+    volatile u32 mHead;
+    u32 mOpenDepth;
+    u32 mSkipDepth;
+    u32 mDropped;
+
+    // Consumer side
+    volatile u32 mTail;
+    ProfileOpenZone mStack[PROFILE_MAX_DEPTH];
+    u32 mStackDepth;
+};
+
+static ProfileRing sProfileRings[PROFILE_MAX_THREADS];
+static ProfileEvent *sProfileEvents = nullptr;
+
+static ProfileZoneStats sProfileZones[PROFILE_MAX_ZONES];
+static size_t sProfileZoneCount = 0;
+
+static ProfileTraceEvent *sTraceEvents = nullptr;
+static u32 sTraceHead                  = 0;
+static u32 sTraceFrameTicks[PROFILE_TRACE_FRAMES];
+static u32 sTraceFrameIndex = 0;
+
+static u32 sFrameStartTick = 0;
+static u32 sLastFrameTicks = 0;
+static u32 sWindowFrames   = 0;
+
+static ProfileRing *getThreadRing() {
+    if (!sProfileEvents)
+        return nullptr;
+
+    OSThread *thread = OSGetCurrentThread();
+    for (size_t i = 0; i < PROFILE_MAX_THREADS; ++i) {
+        if (sProfileRings[i].mThread == thread)
+            return &sProfileRings[i];
+    }
+
+    TAtomicGuard guard;
+
+    for (size_t i = 0; i < PROFILE_MAX_THREADS; ++i) {
+        if (!sProfileRings[i].mThread) {
+            sProfileRings[i].mThread = thread;
+            return &sProfileRings[i];
+        }
+    }
+
+    return nullptr;
+}
+
+static void pushProfileEvent(ProfileRing &ring, const char *name) {
+    const u32 head = ring.mHead;
+
+    if (name) {
+        // Keep room for the end of every zone already open, so that a begin which made it
+        // into the ring can always be closed. Zones that don't fit are skipped as a whole.
+        const u32 freeEvents = PROFILE_RING_SIZE - (head - ring.mTail);
+        if (ring.mSkipDepth > 0 || freeEvents < ring.mOpenDepth + 2) {
+            ring.mSkipDepth += 1;
+            ring.mDropped += 1;
+            return;
+        }
+        ring.mOpenDepth += 1;
+    } else {
+        if (ring.mSkipDepth > 0) {
+            ring.mSkipDepth -= 1;
+            return;
+        }
+        if (ring.mOpenDepth == 0)
+            return;
+        ring.mOpenDepth -= 1;
+    }
+
+    ProfileEvent &event = ring.mEvents[head & (PROFILE_RING_SIZE - 1)];
+    event.mName         = name;
+    event.mTick         = OSGetTick();
+
+    // The consumer runs on the same core, so only the compiler needs to keep the order
+    __asm__ __volatile__("" : : : "memory");
+    ring.mHead = head + 1;
+}
+
+BETTER_SMS_FOR_EXPORT void BetterSMS::Profiler::beginZone(const char *name) {
+    ProfileRing *ring = getThreadRing();
+    if (ring && name)
+        pushProfileEvent(*ring, name);
+}
+
+BETTER_SMS_FOR_EXPORT void BetterSMS::Profiler::endZone() {
+    ProfileRing *ring = getThreadRing();
+    if (ring)
+        pushProfileEvent(*ring, nullptr);
+}
+
+static s16 findProfileZone(const char *name, s16 parent, u8 depth, u8 thread) {
+    for (size_t i = 0; i < sProfileZoneCount; ++i) {
+        const ProfileZoneStats &zone = sProfileZones[i];
+        if (zone.mName == name && zone.mParent == parent && zone.mThread == thread)
+            return i;
+    }
+
+    if (sProfileZoneCount >= PROFILE_MAX_ZONES)
+        return -1;
+
+    ProfileZoneStats &zone = sProfileZones[sProfileZoneCount];
+    memset(&zone, 0, sizeof(zone));
+    zone.mName      = name;
+    zone.mParent    = parent;
+    zone.mDepth     = depth;
+    zone.mThread    = thread;
+    zone.mWindowMin = 0xFFFFFFFF;
+    return sProfileZoneCount++;
+}
+
+static void recordTraceEvent(const ProfileEvent &event, u8 thread) {
+    ProfileTraceEvent &trace = sTraceEvents[sTraceHead % PROFILE_HISTORY_SIZE];
+    trace.mName              = event.mName;
+    trace.mTick              = event.mTick;
+    trace.mThread            = thread;
+    sTraceHead += 1;
+}
+
+static void drainProfileRing(ProfileRing &ring, u8 thread) {
+    const u32 head = ring.mHead;
+
+    for (u32 tail = ring.mTail; tail != head; ++tail) {
+        const ProfileEvent &event = ring.mEvents[tail & (PROFILE_RING_SIZE - 1)];
+        recordTraceEvent(event, thread);
+
+        if (event.mName) {
+            if (ring.mStackDepth >= PROFILE_MAX_DEPTH) {
+                ring.mStackDepth += 1;
+                continue;
+            }
+
+            // Children of a zone that didn't fit in the table aren't recorded either
+            s16 zone = -1;
+            if (ring.mStackDepth == 0) {
+                zone = findProfileZone(event.mName, -1, 0, thread);
+            } else if (ring.mStack[ring.mStackDepth - 1].mZone >= 0) {
+                zone = findProfileZone(event.mName, ring.mStack[ring.mStackDepth - 1].mZone,
+                                       ring.mStackDepth, thread);
+            }
+
+            ProfileOpenZone &open = ring.mStack[ring.mStackDepth++];
+            open.mZone            = zone;
+            open.mStart           = event.mTick;
+            continue;
+        }
+
+        if (ring.mStackDepth == 0)
+            continue;
+
+        ring.mStackDepth -= 1;
+        if (ring.mStackDepth >= PROFILE_MAX_DEPTH)
+            continue;
+
+        const ProfileOpenZone &open = ring.mStack[ring.mStackDepth];
+        if (open.mZone < 0)
+            continue;
+
+        ProfileZoneStats &zone = sProfileZones[open.mZone];
+        if (zone.mFrameCalls == 0) {
+            // Zones left open across the frame boundary start at the boundary
+            const s32 offset = static_cast<s32>(open.mStart - sFrameStartTick);
+            zone.mFrameStart = offset > 0 ? offset : 0;
+        }
+        zone.mFrameTicks += OSDiffTick(event.mTick, open.mStart);
+        zone.mFrameCalls += 1;
+    }
+
+    __asm__ __volatile__("" : : : "memory");
+    ring.mTail = head;
+}
+
+static void closeProfileFrame() {
+    const bool isWindowDone = ++sWindowFrames >= PROFILE_STAT_WINDOW;
+
+    for (size_t i = 0; i < sProfileZoneCount; ++i) {
+        ProfileZoneStats &zone = sProfileZones[i];
+
+        zone.mLastTicks = zone.mFrameTicks;
+        zone.mLastStart = zone.mFrameStart;
+        zone.mLastCalls = zone.mFrameCalls;
+
+        if (zone.mFrameCalls > 0) {
+            zone.mWindowMin = Min(zone.mWindowMin, zone.mFrameTicks);
+            zone.mWindowMax = Max(zone.mWindowMax, zone.mFrameTicks);
+            zone.mWindowSum += zone.mFrameTicks;
+            zone.mWindowFrames += 1;
+        }
+
+        zone.mFrameTicks = 0;
+        zone.mFrameStart = 0;
+        zone.mFrameCalls = 0;
+
+        if (!isWindowDone)
+            continue;
+
+        if (zone.mWindowFrames > 0) {
+            zone.mMinTicks = zone.mWindowMin;
+            zone.mAvgTicks = zone.mWindowSum / zone.mWindowFrames;
+            zone.mMaxTicks = zone.mWindowMax;
+        } else {
+            zone.mMinTicks = 0;
+            zone.mAvgTicks = 0;
+            zone.mMaxTicks = 0;
+        }
+
+        zone.mWindowMin    = 0xFFFFFFFF;
+        zone.mWindowMax    = 0;
+        zone.mWindowSum    = 0;
+        zone.mWindowFrames = 0;
+    }
+
+    if (isWindowDone)
+        sWindowFrames = 0;
+}
+
+void updateProfiler() {
+    if (!sProfileEvents)
+        return;
+
+    for (size_t i = 0; i < PROFILE_MAX_THREADS; ++i) {
+        if (sProfileRings[i].mThread)
+            drainProfileRing(sProfileRings[i], i);
+    }
+
+    closeProfileFrame();
+
+    const u32 now   = OSGetTick();
+    sLastFrameTicks = OSDiffTick(now, sFrameStartTick);
+    sFrameStartTick = now;
+
+    sTraceFrameIndex += 1;
+    sTraceFrameTicks[sTraceFrameIndex % PROFILE_TRACE_FRAMES] = now;
+}
+
+size_t getProfileZones(const ProfileZoneStats *&zonesOut) {
+    zonesOut = sProfileZones;
+    return sProfileZoneCount;
+}
+
+u32 getLastProfileFrameTicks() { return sLastFrameTicks; }
+
+u32 getProfileDroppedZones() {
+    u32 dropped = 0;
+    for (size_t i = 0; i < PROFILE_MAX_THREADS; ++i) {
+        dropped += sProfileRings[i].mDropped;
+    }
+    return dropped;
+}
+
+BETTER_SMS_FOR_EXPORT void BetterSMS::Profiler::dumpChromeTrace(u32 frames) {
+    if (!sTraceEvents || sTraceFrameIndex == 0)
+        return;
+
+    // The oldest boundary slot is overwritten by the newest one
+    frames = Min(frames, static_cast<u32>(PROFILE_TRACE_FRAMES - 1));
+    frames = Min(frames, sTraceFrameIndex);
+    if (frames == 0)
+        return;
+
+    const u32 since = sTraceFrameTicks[(sTraceFrameIndex - frames) % PROFILE_TRACE_FRAMES];
+    const u32 count = sTraceHead < PROFILE_HISTORY_SIZE ? sTraceHead : PROFILE_HISTORY_SIZE;
+
+    OSReport("{\"traceEvents\":[\n");
+
+    bool isFirst = true;
+    for (u32 i = sTraceHead - count; i != sTraceHead; ++i) {
+        const ProfileTraceEvent &trace = sTraceEvents[i % PROFILE_HISTORY_SIZE];
+        if (static_cast<s32>(trace.mTick - since) < 0)
+            continue;
+
+        const u32 timestamp = OSTicksToMicroseconds(static_cast<u64>(trace.mTick - since));
+        if (trace.mName) {
+            OSReport("%s{\"name\":\"%s\",\"ph\":\"B\",\"ts\":%lu,\"pid\":0,\"tid\":%u}\n",
+                     isFirst ? "" : ",", trace.mName, timestamp, trace.mThread);
+        } else {
+            OSReport("%s{\"ph\":\"E\",\"ts\":%lu,\"pid\":0,\"tid\":%u}\n", isFirst ? "" : ",",
+                     timestamp, trace.mThread);
+        }
+        isFirst = false;
+    }
+
+    OSReport("]}\n");
+}
+
+BETTER_SMS_FOR_CALLBACK void initProfiler(TApplication *app) {
+    if (sProfileEvents)
+        return;
+
+    sTraceEvents = new ProfileTraceEvent[PROFILE_HISTORY_SIZE];
+    if (!sTraceEvents)
+        return;
+
+    ProfileEvent *events = new ProfileEvent[PROFILE_RING_SIZE * PROFILE_MAX_THREADS];
+    if (!events) {
+        delete[] sTraceEvents;
+        sTraceEvents = nullptr;
+        return;
+    }
+
+    for (size_t i = 0; i < PROFILE_MAX_THREADS; ++i) {
+        sProfileRings[i].mEvents = events + (i * PROFILE_RING_SIZE);
+    }
+
+    // The debug init runs on the game thread, which keeps the first ring for the flame page
+    sProfileRings[0].mThread = OSGetCurrentThread();
+    sFrameStartTick          = OSGetTick();
+
+    sProfileEvents = events;
+}
@@ -32,7 +32,10 @@
 #include "libs/constmath.hxx"
 #include "libs/container.hxx"
 #include "libs/global_vector.hxx"
+#include "libs/lock.hxx"
+#include "libs/object_pool.hxx"
 #include "libs/string.hxx"
+#include "logging.hxx"
 #include "module.hxx"
 #include "settings.hxx"
 
@@ -41,12 +44,40 @@
 #include "p_settings.hxx"
 #include <libs/scoped_ptr.hxx>
 
-struct SettingMetaInfo {
-    const char *mID;
+// Sorted once and rebuilt only when a module registers
+static TGlobalVector<Settings::SettingsGroup *> sSettingsGroups;
+static bool sIsSettingsGroupsValid = false;
+
+// Last seen accessibility of every grouped setting, in sorted group order and then each
+// group's registration order. Rebuilt whenever that order can change
+struct SettingUnlockInfo {
+    Settings::SingleSetting *mSetting;
+    Settings::SettingsGroup *mGroup;
     bool mIsUnlocked;
 };
 
-static TGlobalVector<SettingMetaInfo> sNewUnlockMap;
+static TGlobalVector<SettingUnlockInfo> sUnlockInfos;
+static bool sIsUnlockInfosValid     = false;
+static bool sIsUnlockCheckRequested = false;
+static u32 sUnlockPollTimer         = 0;
+
+// Most settings never raise an unlock event, so everything is still looked over this often
+#define UNLOCK_POLL_INTERVAL 30
+
+static bool isSettingAccessible(const Settings::SingleSetting &setting) {
+    return setting.isUnlocked() && setting.isUserEditable();
+}
+
+// Takes the current accessibility of `group`'s settings as already known
+static void syncUnlockInfos(const Settings::SettingsGroup &group) {
+    if (!sIsUnlockInfosValid)
+        return;
+
+    for (auto &info : sUnlockInfos) {
+        if (info.mGroup == &group)
+            info.mIsUnlocked = isSettingAccessible(*info.mSetting);
+    }
+}
 
 #define CARD_MAX_BLOCKS 8
 
@@ -56,7 +87,592 @@ static SMS_ALIGN(32) char sCardBuffer[CARD_BLOCKS_TO_BYTES(CARD_MAX_BLOCKS)];
 static bool sIsMounted = false;
 static s32 sChannel    = 0;
 
-static void detachCallback_(s32 channel, s32 res) { sIsMounted = false; }
+// What was last committed to (or read from) the card per group, so saves only write changes
+struct SettingsCommitInfo {
+    const Settings::SettingsGroup *mGroup;
+    u32 mPayloadHash;
+    u32 mBlockHashes[CARD_MAX_BLOCKS];
+    bool mIsValid;
+};
+
+#define MAX_COMMIT_INFOS 32
+
+static SettingsCommitInfo sCommitInfos[MAX_COMMIT_INFOS];
+static size_t sCommitInfosSize = 0;
+
+// Last tagged payload seen in the engine's save, packed groups load from this without going
+// back to the card, and sections of groups that aren't registered are carried over from it
+static u8 sSharedPayload[CARD_BLOCKS_TO_BYTES(1)];
+static size_t sSharedPayloadSize  = 0;
+static bool sIsSharedPayloadValid = false;
+
+// Art-less groups whose section didn't fit the engine's save, these keep a file of their own.
+// Rebuilt every time the engine's payload is written
+#define MAX_SPILLED_GROUPS 32
+
+static const Settings::SettingsGroup *sSpilledGroups[MAX_SPILLED_GROUPS];
+static size_t sSpilledGroupsSize = 0;
+
+static OSThreadQueue sCardAsyncQueue;
+static volatile s32 sCardAsyncResult = CARD_ERROR_READY;
+static volatile bool sIsCardAsyncBusy = false;
+
+static void invalidateCommitInfos() {
+    for (size_t i = 0; i < sCommitInfosSize; ++i) {
+        sCommitInfos[i].mIsValid = false;
+    }
+}
+
+// The card may have been swapped, nothing we know about its contents holds anymore
+static void detachCallback_(s32 channel, s32 res) {
+    sIsMounted            = false;
+    sIsSharedPayloadValid = false;
+    invalidateCommitInfos();
+}
+
+static SettingsCommitInfo *getCommitInfo(const Settings::SettingsGroup &group) {
+    for (size_t i = 0; i < sCommitInfosSize; ++i) {
+        if (sCommitInfos[i].mGroup == &group)
+            return &sCommitInfos[i];
+    }
+
+    if (sCommitInfosSize >= MAX_COMMIT_INFOS)
+        return nullptr;
+
+    SettingsCommitInfo &info = sCommitInfos[sCommitInfosSize++];
+    info.mGroup              = &group;
+    info.mIsValid            = false;
+    return &info;
+}
+
+static u32 hashCardBytes(const void *data, size_t size) {
+    const u8 *bytes = reinterpret_cast<const u8 *>(data);
+
+    u32 hash = 0x811C9DC5;
+    for (size_t i = 0; i < size; ++i) {
+        hash ^= bytes[i];
+        hash *= 0x01000193;
+    }
+    return hash;
+}
+
+static size_t getSettingsPayloadOffset(const Settings::SettingsSaveInfo &info) {
+    size_t offset = CARD_DIRENTRY_SIZE;
+    if (info.mBannerImage)
+        offset += 0xE00;
+    if (info.mIconTable)
+        offset += 0x500 * info.mIconCount;
+    return offset;
+}
+
+// -- TAGGED SAVE FORMAT -- //
+//
+// payload := magic:u32 format:u8 sectionCount:u8 section*
+// section := groupHash:u32 major:u8 minor:u8 size:u16 record*
+// record  := nameHash:u32 tag:u8 value
+//
+// Records are matched by name on load, so settings can be added, removed or reordered
+// without disturbing the rest of the group. Saves without the magic are the old positional
+// format, they are still read and get rewritten as tagged on the next save.
+
+#define SETTINGS_FORMAT_MAGIC   'BSTG'
+#define SETTINGS_FORMAT_VERSION 1
+
+#define MAX_SETTING_VALUE_SIZE 0x100
+
+enum SettingRecordTag {
+    RECORD_TAG_VARINT = 0,  // Zigzag varint, byte width of the value in the high nibble
+    RECORD_TAG_BYTES  = 1,  // Varint length followed by the raw bytes
+};
+
+struct SettingsWriter {
+    SettingsWriter(u8 *begin, u8 *end) : mCursor(begin), mEnd(end), mIsOverflowed(false) {}
+
+    void writeBytes(const void *src, size_t size) {
+        if (mIsOverflowed || size > static_cast<size_t>(mEnd - mCursor)) {
+            mIsOverflowed = true;
+            return;
+        }
+        memcpy(mCursor, src, size);
+        mCursor += size;
+    }
+
+    void writeU8(u8 x) { writeBytes(&x, 1); }
+    void writeU16(u16 x) { writeBytes(&x, 2); }
+    void writeU32(u32 x) { writeBytes(&x, 4); }
+
+    void writeVarint(u32 x) {
+        while (x >= 0x80) {
+            writeU8((x & 0x7F) | 0x80);
+            x >>= 7;
+        }
+        writeU8(x);
+    }
+
+    u8 *mCursor;
+    u8 *mEnd;
+    bool mIsOverflowed;
+};
+
+struct SettingsReader {
+    SettingsReader(const u8 *begin, const u8 *end) : mCursor(begin), mEnd(end), mIsBroken(false) {}
+
+    bool readBytes(void *dst, size_t size) {
+        if (mIsBroken || size > static_cast<size_t>(mEnd - mCursor)) {
+            mIsBroken = true;
+            return false;
+        }
+        memcpy(dst, mCursor, size);
+        mCursor += size;
+        return true;
+    }
+
+    bool skip(size_t size) {
+        if (mIsBroken || size > static_cast<size_t>(mEnd - mCursor)) {
+            mIsBroken = true;
+            return false;
+        }
+        mCursor += size;
+        return true;
+    }
+
+    u8 readU8() {
+        u8 x = 0;
+        readBytes(&x, 1);
+        return x;
+    }
+
+    u16 readU16() {
+        u16 x = 0;
+        readBytes(&x, 2);
+        return x;
+    }
+
+    u32 readU32() {
+        u32 x = 0;
+        readBytes(&x, 4);
+        return x;
+    }
+
+    u32 readVarint() {
+        u32 x = 0;
+        for (u32 shift = 0; shift < 35; shift += 7) {
+            const u8 b = readU8();
+            x |= static_cast<u32>(b & 0x7F) << shift;
+            if (!(b & 0x80))
+                return x;
+        }
+        mIsBroken = true;
+        return 0;
+    }
+
+    bool isAtEnd() const { return mCursor >= mEnd; }
+
+    const u8 *mCursor;
+    const u8 *mEnd;
+    bool mIsBroken;
+};
+
+static u32 hashSettingsName(const char *name) { return hashCardBytes(name, strlen(name)); }
+
+static Settings::SettingsGroup *getSharedSettingsHost() {
+    for (auto &item : gModuleInfos) {
+        if (strcmp(item.mName, "Better Sunshine Engine") == 0)
+            return item.mSettings;
+    }
+    return nullptr;
+}
+
+static bool isSpilledGroup(const Settings::SettingsGroup &group) {
+    for (size_t i = 0; i < sSpilledGroupsSize; ++i) {
+        if (sSpilledGroups[i] == &group)
+            return true;
+    }
+    return false;
+}
+
+// Groups without art of their own are candidates for the engine's save
+static bool isPackableGroup(const Settings::SettingsGroup &group) {
+    const Settings::SettingsSaveInfo &info = group.getSaveInfo();
+    return !info.mBannerImage && !info.mSaveGlobal && &group != getSharedSettingsHost();
+}
+
+static bool isPackedGroup(const Settings::SettingsGroup &group) {
+    return isPackableGroup(group) && !isSpilledGroup(group);
+}
+
+// The group whose save file holds `group`'s settings
+static Settings::SettingsGroup &getSettingsFileOwner(Settings::SettingsGroup &group) {
+    if (!isPackedGroup(group))
+        return group;
+
+    Settings::SettingsGroup *host = getSharedSettingsHost();
+    return host ? *host : group;
+}
+
+static Settings::SettingsGroup *findSettingsGroup(u32 groupHash) {
+    for (auto &item : gModuleInfos) {
+        Settings::SettingsGroup *group = item.mSettings;
+        if (group && hashSettingsName(Settings::getGroupName(*group)) == groupHash)
+            return group;
+    }
+    return nullptr;
+}
+
+static bool isTaggedPayload(const u8 *payload, size_t size) {
+    SettingsReader reader(payload, payload + size);
+    return reader.readU32() == SETTINGS_FORMAT_MAGIC &&
+           reader.readU8() == SETTINGS_FORMAT_VERSION && !reader.mIsBroken;
+}
+
+static void writeSettingRecord(SettingsWriter &writer, Settings::SingleSetting &setting) {
+    u8 value[MAX_SETTING_VALUE_SIZE];
+
+    JSUMemoryOutputStream out(value, sizeof(value));
+    setting.save(out);
+    const size_t size = out.getPosition();
+
+    writer.writeU32(hashSettingsName(setting.getName()));
+
+    const bool isIntegral = setting.getKind() != Settings::SingleSetting::ValueKind::FLOAT &&
+                            (size == 1 || size == 2 || size == 4);
+    if (!isIntegral) {
+        writer.writeU8(RECORD_TAG_BYTES);
+        writer.writeVarint(size);
+        writer.writeBytes(value, size);
+        return;
+    }
+
+    // Sign extend from the stored width so small negatives stay short once zigzagged
+    u32 bits = 0;
+    for (size_t i = 0; i < size; ++i) {
+        bits = (bits << 8) | value[i];
+    }
+    const u32 shift = 32 - (size * 8);
+    const s32 x     = static_cast<s32>(bits << shift) >> shift;
+
+    writer.writeU8(RECORD_TAG_VARINT | (size << 4));
+    writer.writeVarint((static_cast<u32>(x) << 1) ^ static_cast<u32>(x >> 31));
+}
+
+// Decodes a record back into the bytes its setting originally saved, zero padded
+static bool readSettingRecord(SettingsReader &reader, u32 &nameHashOut,
+                              u8 (&value)[MAX_SETTING_VALUE_SIZE]) {
+    memset(value, 0, sizeof(value));
+
+    nameHashOut  = reader.readU32();
+    const u8 tag = reader.readU8();
+
+    switch (tag & 0xF) {
+    case RECORD_TAG_VARINT: {
+        const size_t width = tag >> 4;
+        if (width != 1 && width != 2 && width != 4)
+            return false;
+
+        const u32 z = reader.readVarint();
+        const u32 x = (z >> 1) ^ (0 - (z & 1));
+        for (size_t i = 0; i < width; ++i) {
+            value[i] = (x >> ((width - 1 - i) * 8)) & 0xFF;
+        }
+        break;
+    }
+    case RECORD_TAG_BYTES: {
+        const size_t size = reader.readVarint();
+        if (size > sizeof(value))
+            return false;
+        reader.readBytes(value, size);
+        break;
+    }
+    default:
+        return false;
+    }
+
+    return !reader.mIsBroken;
+}
+
+static void writeSettingsSection(SettingsWriter &writer, Settings::SettingsGroup &group) {
+    writer.writeU32(hashSettingsName(Settings::getGroupName(group)));
+    writer.writeU8(group.getMajorVersion());
+    writer.writeU8(group.getMinorVersion());
+
+    u8 *sizeSlot = writer.mCursor;
+    writer.writeU16(0);
+
+    for (auto &setting : group.getSettings()) {
+        writeSettingRecord(writer, *setting);
+    }
+
+    if (!writer.mIsOverflowed) {
+        const u16 size = writer.mCursor - (sizeSlot + 2);
+        memcpy(sizeSlot, &size, 2);
+    }
+}
+
+// Carries over sections of groups that aren't registered this session
+static u8 writeOrphanedSections(SettingsWriter &writer) {
+    if (!sIsSharedPayloadValid || sSharedPayloadSize == 0)
+        return 0;
+
+    SettingsReader reader(sSharedPayload, sSharedPayload + sSharedPayloadSize);
+    reader.skip(5);
+
+    u8 orphanCount        = 0;
+    const u8 sectionCount = reader.readU8();
+    for (u8 i = 0; i < sectionCount; ++i) {
+        const u8 *section = reader.mCursor;
+
+        const u32 groupHash = reader.readU32();
+        reader.skip(2);
+        reader.skip(reader.readU16());
+        if (reader.mIsBroken)
+            break;
+
+        if (findSettingsGroup(groupHash))
+            continue;
+
+        writer.writeBytes(section, reader.mCursor - section);
+        orphanCount += 1;
+    }
+
+    return orphanCount;
+}
+
+// Loads `group`'s section out of a tagged payload, NOFILE if the group has never been saved
+static s32 loadSettingsSection(Settings::SettingsGroup &group, const u8 *payload, size_t size) {
+    SettingsReader reader(payload, payload + size);
+    reader.skip(5);
+
+    const u32 groupHash   = hashSettingsName(Settings::getGroupName(group));
+    const u8 sectionCount = reader.readU8();
+    for (u8 i = 0; i < sectionCount; ++i) {
+        const u32 sectionHash = reader.readU32();
+        const u8 major        = reader.readU8();
+        reader.skip(1);
+        const u16 sectionSize = reader.readU16();
+        if (reader.mIsBroken)
+            return CARD_ERROR_BROKEN;
+
+        if (sectionHash != groupHash) {
+            reader.skip(sectionSize);
+            continue;
+        }
+
+        if (major != group.getMajorVersion())
+            return CARD_ERROR_BROKEN;
+
+        if (sectionSize > static_cast<size_t>(reader.mEnd - reader.mCursor))
+            return CARD_ERROR_BROKEN;
+
+        SettingsReader records(reader.mCursor, reader.mCursor + sectionSize);
+        while (!records.isAtEnd()) {
+            u32 nameHash;
+            u8 value[MAX_SETTING_VALUE_SIZE];
+            if (!readSettingRecord(records, nameHash, value))
+                return CARD_ERROR_BROKEN;
+
+            for (auto &setting : group.getSettings()) {
+                if (hashSettingsName(setting->getName()) != nameHash)
+                    continue;
+
+                JSUMemoryInputStream in(value, sizeof(value));
+                setting->load(in);
+                break;
+            }
+        }
+
+        return CARD_ERROR_READY;
+    }
+
+    return CARD_ERROR_NOFILE;
+}
+
+static void cacheSharedPayload(const u8 *payload, size_t size) {
+    if (!isTaggedPayload(payload, size)) {
+        // Positional engine save, nothing is packed into it yet
+        sSharedPayloadSize    = 0;
+        sIsSharedPayloadValid = true;
+        return;
+    }
+
+    if (size > sizeof(sSharedPayload)) {
+        sIsSharedPayloadValid = false;
+        return;
+    }
+
+    memcpy(sSharedPayload, payload, size);
+    sSharedPayloadSize    = size;
+    sIsSharedPayloadValid = true;
+}
+
+// Serializes the settings stored in `owner`'s save into the payload area of the card buffer
+static s32 writeSettingsPayload(Settings::SettingsGroup &owner, u32 &hashOut) {
+    const Settings::SettingsSaveInfo &info = owner.getSaveInfo();
+
+    const size_t saveDataSize  = CARD_BLOCKS_TO_BYTES(info.mBlocks);
+    const size_t payloadOffset = getSettingsPayloadOffset(info);
+    u8 *payload                = reinterpret_cast<u8 *>(sCardBuffer) + payloadOffset;
+
+    memset(payload, 0, saveDataSize - payloadOffset);
+
+    SettingsWriter writer(payload, payload + (saveDataSize - payloadOffset));
+    writer.writeU32(SETTINGS_FORMAT_MAGIC);
+    writer.writeU8(SETTINGS_FORMAT_VERSION);
+
+    u8 *countSlot = writer.mCursor;
+    writer.writeU8(0);
+
+    u8 sectionCount = 1;
+    writeSettingsSection(writer, owner);
+
+    if (&owner == getSharedSettingsHost()) {
+        // Orphaned sections are only known from the card, writing without them would drop them
+        if (!sIsSharedPayloadValid) {
+            OSReport("Failed to save settings for module \"%s\"! (UNREAD SAVE)\n",
+                     Settings::getGroupName(owner));
+            return CARD_ERROR_CANCELED;
+        }
+
+        // They go first as well, unlike registered groups they have nowhere else to live
+        sectionCount += writeOrphanedSections(writer);
+
+        sSpilledGroupsSize = 0;
+        for (auto &item : gModuleInfos) {
+            Settings::SettingsGroup *group = item.mSettings;
+            if (writer.mIsOverflowed)
+                break;
+            if (!group || !group->isIOValid() || !isPackableGroup(*group))
+                continue;
+
+            u8 *section = writer.mCursor;
+            writeSettingsSection(writer, *group);
+
+            // Past the engine's block budget, this group is saved to a file of its own instead
+            if (writer.mIsOverflowed && sSpilledGroupsSize < MAX_SPILLED_GROUPS) {
+                memset(section, 0, writer.mCursor - section);
+                writer.mCursor       = section;
+                writer.mIsOverflowed = false;
+
+                sSpilledGroups[sSpilledGroupsSize++] = group;
+                continue;
+            }
+
+            sectionCount += 1;
+        }
+    }
+
+    if (writer.mIsOverflowed) {
+        OSReport("Failed to save settings for module \"%s\"! (OUT OF SPACE)\n",
+                 Settings::getGroupName(owner));
+        return CARD_ERROR_CANCELED;
+    }
+
+    *countSlot = sectionCount;
+    hashOut    = hashCardBytes(payload, saveDataSize - payloadOffset);
+    return CARD_ERROR_READY;
+}
+
+static void cardAsyncCallback_(s32 channel, s32 result) {
+    sCardAsyncResult = result;
+    sIsCardAsyncBusy = false;
+    OSWakeupThread(&sCardAsyncQueue);
+}
+
+// Sleep until the card callback fires instead of spinning on CARDCheck
+static s32 waitForCardAsync(s32 result) {
+    if (result < CARD_ERROR_READY) {
+        sIsCardAsyncBusy = false;
+        return result;
+    }
+
+    {
+        TAtomicGuard guard;
+        while (sIsCardAsyncBusy) {
+            OSSleepThread(&sCardAsyncQueue);
+        }
+    }
+
+    return sCardAsyncResult;
+}
+
+static s32 waitForCardReady(s32 channel, s32 result) {
+    while (result == CARD_ERROR_BUSY) {
+        OSYieldThread();
+        result = CARDCheck(channel);
+    }
+    return result;
+}
+
+// A transfer can be refused with CARD_ERROR_BUSY while the card finishes other work, so wait
+// for it to settle and issue the block again instead of failing the whole read or write
+static s32 readCardBlock(CARDFileInfo *finfo, size_t offset) {
+    while (true) {
+        sIsCardAsyncBusy = true;
+        s32 result       = waitForCardAsync(CARDReadAsync(
+            finfo, sCardBuffer + offset, CARD_BLOCKS_TO_BYTES(1), offset, cardAsyncCallback_));
+        if (result != CARD_ERROR_BUSY)
+            return result;
+
+        result = waitForCardReady(finfo->mChannel, result);
+        if (result < CARD_ERROR_READY)
+            return result;
+    }
+}
+
+static s32 writeCardBlock(CARDFileInfo *finfo, size_t offset) {
+    while (true) {
+        s32 result = writeCardBlock(finfo, offset);
+        if (result != CARD_ERROR_BUSY)
+            return result;
+
+        result = waitForCardReady(finfo->mChannel, result);
+        if (result < CARD_ERROR_READY)
+            return result;
+    }
+}
+
+// Reads `owner`'s whole save file into the card buffer
+static s32 readSettingsImage(Settings::SettingsGroup &owner, CARDFileInfo *finfo) {
+    auto &info = owner.getSaveInfo();
+    if (info.mBlocks > CARD_MAX_BLOCKS) {
+        OSReport("Failed to load settings for module \"%s\"! (TOO MANY BLOCKS: > " SMS_STRINGIZE(
+                     CARD_MAX_BLOCKS) ")\n",
+                 Settings::getGroupName(owner));
+        return CARD_ERROR_CANCELED;
+    }
+
+    const size_t saveDataSize = CARD_BLOCKS_TO_BYTES(info.mBlocks);
+
+    // Reset data
+    memset(sCardBuffer, 0, saveDataSize);
+
+    for (size_t i = 0; i < saveDataSize; i += CARD_BLOCKS_TO_BYTES(1)) {
+        s32 result = readCardBlock(finfo, i);
+        // OSReport("Result (READ): %d\n", result);
+        if (result < CARD_ERROR_READY) {
+            return result;
+        }
+    }
+
+    const size_t payloadOffset = getSettingsPayloadOffset(info);
+
+    // What is on the card now is the last committed image
+    if (SettingsCommitInfo *commit = getCommitInfo(owner)) {
+        for (size_t i = 0; i < info.mBlocks; ++i) {
+            commit->mBlockHashes[i] =
+                hashCardBytes(sCardBuffer + CARD_BLOCKS_TO_BYTES(i), CARD_BLOCKS_TO_BYTES(1));
+        }
+        commit->mPayloadHash =
+            hashCardBytes(sCardBuffer + payloadOffset, saveDataSize - payloadOffset);
+        commit->mIsValid     = true;
+    }
+
+    if (&owner == getSharedSettingsHost()) {
+        cacheSharedPayload(reinterpret_cast<const u8 *>(sCardBuffer) + payloadOffset,
+                           saveDataSize - payloadOffset);
+    }
+
+    return CARD_ERROR_READY;
+}
 
 BETTER_SMS_FOR_EXPORT const char *Settings::getGroupName(const Settings::SettingsGroup &group) {
     if (!group.mModule)
@@ -107,6 +723,25 @@ BETTER_SMS_FOR_EXPORT s32 Settings::saveSettingsGroup(Settings::SettingsGroup &g
         return CARD_ERROR_READY;
     }
 
+    // Packed groups are committed as part of the engine's save, unless it had no room left
+    Settings::SettingsGroup &owner = getSettingsFileOwner(group);
+    if (&owner != &group) {
+        const s32 ret = saveSettingsGroup(owner);
+        if (ret < CARD_ERROR_READY || !isSpilledGroup(group))
+            return ret;
+    }
+
+    // Nothing changed since the last commit, don't touch the card at all
+    if (group.getSaveInfo().mBlocks <= CARD_MAX_BLOCKS) {
+        SettingsCommitInfo *commit = getCommitInfo(group);
+        u32 payloadHash;
+        if (commit && commit->mIsValid &&
+            writeSettingsPayload(group, payloadHash) == CARD_ERROR_READY &&
+            payloadHash == commit->mPayloadHash) {
+            return CARD_ERROR_READY;
+        }
+    }
+
     CARDFileInfo finfo;
     s32 ret = OpenSavedSettings(group, finfo, true);
     if (ret < CARD_ERROR_READY) {
@@ -114,6 +749,10 @@ BETTER_SMS_FOR_EXPORT s32 Settings::saveSettingsGroup(Settings::SettingsGroup &g
         return ret;
     }
 
+    // Pick up sections of other groups on this card before they get rewritten
+    if (&group == getSharedSettingsHost() && !sIsSharedPayloadValid)
+        readSettingsImage(group, &finfo);
+
     ret = UpdateSavedSettings(group, &finfo);
 
     if (ret == CARD_ERROR_READY)
@@ -131,36 +770,34 @@ BETTER_SMS_FOR_EXPORT s32 Settings::loadSettingsGroup(Settings::SettingsGroup &g
         return CARD_ERROR_READY;
     }
 
+    Settings::SettingsGroup &owner = getSettingsFileOwner(group);
     CARDFileInfo finfo;
 
-    int ret = OpenSavedSettings(group, finfo, false);
+    int ret = OpenSavedSettings(owner, finfo, false);
     if (ret >= CARD_ERROR_READY) {
         // If this returns BROKEN, the save file is desynced by version and should be reset
         if (ReadSavedSettings(group, &finfo) == CARD_ERROR_BROKEN) {
+            BetterSMS::Console::flush();
             OSPanic(__FILE__, __LINE__,
                     "Failed to load settings for module \"%s\"! (VERSION MISMATCH)\n\n"
                     "Automatically resetting to defaults...",
                     Settings::getGroupName(group));
-            ret = UpdateSavedSettings(group, &finfo);
+            ret = UpdateSavedSettings(owner, &finfo);
         }
 
-        CloseSavedSettings(group, &finfo);
+        CloseSavedSettings(owner, &finfo);
     }
 
     for (auto &setting : group.getSettings()) {
         setting->emit();
-        sNewUnlockMap.push_back(
-            {setting->getName(), setting->isUnlocked() && setting->isUserEditable()});
     }
+    syncUnlockInfos(group);
 
-    return CloseSavedSettings(group, &finfo);
+    return CloseSavedSettings(owner, &finfo);
 }
 
 BETTER_SMS_FOR_EXPORT bool Settings::saveAllSettings() {
-    TGlobalVector<Settings::SettingsGroup *> groups;
-    getSettingsGroups(groups);
-
-    for (auto &group : groups) {
+    for (auto &group : getSettingsGroups()) {
         if (saveSettingsGroup(*group) < CARD_ERROR_READY)
             return false;
     }
@@ -169,10 +806,7 @@ BETTER_SMS_FOR_EXPORT bool Settings::saveAllSettings() {
 }
 
 BETTER_SMS_FOR_EXPORT bool Settings::loadAllSettings() {
-    TGlobalVector<Settings::SettingsGroup *> groups;
-    getSettingsGroups(groups);
-
-    for (auto &group : groups) {
+    for (auto &group : getSettingsGroups()) {
         if (loadSettingsGroup(*group) < CARD_ERROR_READY)
             return false;
     }
@@ -191,13 +825,16 @@ static SubtitleSetting sSubtitleSetting("Movie Subtitles");
 
 // PRIVATE
 
-void getSettingsGroups(TGlobalVector<Settings::SettingsGroup *> &out) {
+static void sortSettingsGroups(TGlobalVector<Settings::SettingsGroup *> &out) {
     TGlobalVector<Settings::SettingsGroup *> tempCore;
     TGlobalVector<Settings::SettingsGroup *> tempGame;
     TGlobalVector<Settings::SettingsGroup *> tempMode;
 
     for (auto &item : gModuleInfos) {
         Settings::SettingsGroup *group = item.mSettings;
+        if (!group)  // No settings registered
+            continue;
+
         if (strcmp(item.mName, "Better Sunshine Engine") == 0) {
             tempCore.insert(tempCore.begin(), group);
             continue;
@@ -229,6 +866,20 @@ void getSettingsGroups(TGlobalVector<Settings::SettingsGroup *> &out) {
     }
 }
 
+const TGlobalVector<Settings::SettingsGroup *> &getSettingsGroups() {
+    if (!sIsSettingsGroupsValid) {
+        sSettingsGroups.clear();
+        sortSettingsGroups(sSettingsGroups);
+        sIsSettingsGroupsValid = true;
+    }
+    return sSettingsGroups;
+}
+
+void invalidateSettingsGroups() {
+    sIsSettingsGroupsValid = false;
+    sIsUnlockInfosValid    = false;
+}
+
 BETTER_SMS_FOR_CALLBACK void initAllSettings(TApplication *app) {
     sSunshineSettingsGroup.addSetting(&sRumbleSetting);
     sSunshineSettingsGroup.addSetting(&sSoundSetting);
@@ -249,7 +900,10 @@ BETTER_SMS_FOR_CALLBACK void initAllSettings(TApplication *app) {
     Settings::unmountCard();
 }
 
-void InitCard() { CARDInit(); }
+void InitCard() {
+    CARDInit();
+    OSInitThreadQueue(&sCardAsyncQueue);
+}
 
 s32 OpenSavedSettings(Settings::SettingsGroup &group, CARDFileInfo &infoOut, bool canCreate) {
     auto &info = group.getSaveInfo();
@@ -266,10 +920,7 @@ s32 OpenSavedSettings(Settings::SettingsGroup &group, CARDFileInfo &infoOut, boo
     if (info.mSaveGlobal)
         __CARDSetDiskID(&info.mGameCode);
 
-    s32 ret = CARDOpen(sChannel, normalizedPath, &infoOut);
-    while (ret == CARD_ERROR_BUSY) {
-        ret = CARDCheck(sChannel);
-    }
+    s32 ret = waitForCardReady(sChannel, CARDOpen(sChannel, normalizedPath, &infoOut));
 
     if (ret == CARD_ERROR_NOFILE && canCreate) {
         s32 cret =
@@ -280,6 +931,17 @@ s32 OpenSavedSettings(Settings::SettingsGroup &group, CARDFileInfo &infoOut, boo
                 __CARDSetDiskID(DISK_GAME_ID);
             return cret;
         }
+
+        // Fresh file, every block has to be written
+        if (SettingsCommitInfo *commit = getCommitInfo(group))
+            commit->mIsValid = false;
+
+        // and it can't hold sections of other groups yet
+        if (&group == getSharedSettingsHost()) {
+            sSharedPayloadSize    = 0;
+            sIsSharedPayloadValid = true;
+        }
+
         UpdateSavedSettings(group, &infoOut);
     } else if (ret < CARD_ERROR_READY) {
         if (info.mSaveGlobal)
@@ -300,33 +962,14 @@ s32 UpdateSavedSettings(Settings::SettingsGroup &group, CARDFileInfo *finfo) {
         return CARD_ERROR_CANCELED;
     }
 
-    {
-        CARDStat fstatus;
-
-        // Work out status
-        int statusRet = CARDGetStatus(finfo->mChannel, finfo->mFileNo, &fstatus);
-        if (statusRet < CARD_ERROR_READY)
-            return statusRet;
-
-        fstatus.mGameCode = info.mGameCode;
-        fstatus.mCompany  = info.mCompany;
-        CARDSetBannerFmt(&fstatus, info.mBannerFmt);
-        CARDSetIconAddr(&fstatus, CARD_DIRENTRY_SIZE);
-        CARDSetCommentAddr(&fstatus, 4);
-        for (s32 i = 0; i < info.mIconCount; ++i) {
-            CARDSetIconFmt(&fstatus, i, info.mIconFmt);
-            CARDSetIconSpeed(&fstatus, i, info.mIconSpeed);
-        }
-        fstatus.mLastModified = OSTicksToSeconds(OSGetTime());
-
-        CARDSetStatus(finfo->mChannel, finfo->mFileNo, &fstatus);
-    }
+    // Build the full image, then only write the blocks that differ from the last commit
+    u32 payloadHash;
+    if (s32 result = writeSettingsPayload(group, payloadHash))
+        return result;
 
-    const size_t saveDataSize = CARD_BLOCKS_TO_BYTES(info.mBlocks);
     {
-
-        // Reset data
-        memset(sCardBuffer, 0, saveDataSize);
+        // Reset header
+        memset(sCardBuffer, 0, getSettingsPayloadOffset(info));
 
         // Write version info
         sCardBuffer[0] = group.getMajorVersion();
@@ -343,158 +986,160 @@ s32 UpdateSavedSettings(Settings::SettingsGroup &group, CARDFileInfo *finfo) {
                      calendar.mday, calendar.year);
         }
 
-        memcpy(sCardBuffer + CARD_DIRENTRY_SIZE,
-               reinterpret_cast<const u8 *>(info.mBannerImage) + info.mBannerImage->mTextureOffset,
-               0xE00);
-        memcpy(sCardBuffer + CARD_DIRENTRY_SIZE + 0xE00,
-               reinterpret_cast<const u8 *>(info.mIconTable) + info.mIconTable->mTextureOffset,
-               0x500 * info.mIconCount);
-
-        size_t dataPosOut = CARD_DIRENTRY_SIZE + 0xE00 + (0x500 * info.mIconCount);
-
-        // Write contents to save file
-        JSUMemoryOutputStream out(sCardBuffer + dataPosOut, saveDataSize - dataPosOut);
-        for (auto &setting : group.getSettings()) {
-            setting->save(out);
+        size_t artOffset = CARD_DIRENTRY_SIZE;
+        if (info.mBannerImage) {
+            memcpy(sCardBuffer + artOffset,
+                   reinterpret_cast<const u8 *>(info.mBannerImage) +
+                       info.mBannerImage->mTextureOffset,
+                   0xE00);
+            artOffset += 0xE00;
         }
-
-        for (size_t i = 0; i < saveDataSize; i += CARD_BLOCKS_TO_BYTES(1)) {
-            s32 result = CARDWrite(finfo, sCardBuffer, CARD_BLOCKS_TO_BYTES(1), i);
-            while (result == CARD_ERROR_BUSY) {
-                result = CARDCheck(finfo->mChannel);
-            }
-            // OSReport("Result (WRITE): %d\n", result);
-            if (result < CARD_ERROR_READY) {
-                return result;
-            }
+        if (info.mIconTable) {
+            memcpy(sCardBuffer + artOffset,
+                   reinterpret_cast<const u8 *>(info.mIconTable) + info.mIconTable->mTextureOffset,
+                   0x500 * info.mIconCount);
         }
     }
 
-    return CARD_ERROR_READY;
-}
+    SettingsCommitInfo *commit = getCommitInfo(group);
 
-s32 ReadSavedSettings(Settings::SettingsGroup &group, CARDFileInfo *finfo) {
-    auto &info = group.getSaveInfo();
-    if (info.mBlocks > CARD_MAX_BLOCKS) {
-        OSReport("Failed to load settings for module \"%s\"! (TOO MANY BLOCKS: > " SMS_STRINGIZE(
-                     CARD_MAX_BLOCKS) ")\n",
-                 Settings::getGroupName(group));
-        return CARD_ERROR_CANCELED;
+    u32 blockHashes[CARD_MAX_BLOCKS];
+    bool isBlockDirty[CARD_MAX_BLOCKS];
+    bool isAnyBlockDirty = false;
+
+    for (size_t i = 0; i < info.mBlocks; ++i) {
+        blockHashes[i] =
+            hashCardBytes(sCardBuffer + CARD_BLOCKS_TO_BYTES(i), CARD_BLOCKS_TO_BYTES(1));
+        isBlockDirty[i] = !commit || !commit->mIsValid || commit->mBlockHashes[i] != blockHashes[i];
+        isAnyBlockDirty |= isBlockDirty[i];
     }
 
-    const size_t saveDataSize = CARD_BLOCKS_TO_BYTES(info.mBlocks);
-    {
-        // Reset data
-        memset(sCardBuffer, 0, saveDataSize);
+    if (isAnyBlockDirty) {
+        CARDStat fstatus;
 
-        for (size_t i = 0; i < saveDataSize; i += CARD_BLOCKS_TO_BYTES(1)) {
-            s32 result = CARDRead(finfo, sCardBuffer, CARD_BLOCKS_TO_BYTES(1), i);
-            while (result == CARD_ERROR_BUSY) {
-                result = CARDCheck(finfo->mChannel);
-            }
-            // OSReport("Result (READ): %d\n", result);
-            if (result < CARD_ERROR_READY) {
-                return result;
-            }
-        }
+        // Work out status
+        int statusRet = CARDGetStatus(finfo->mChannel, finfo->mFileNo, &fstatus);
+        if (statusRet < CARD_ERROR_READY)
+            return statusRet;
 
-        if (sCardBuffer[0] != group.getMajorVersion()) {
-            return CARD_ERROR_BROKEN;
+        fstatus.mGameCode = info.mGameCode;
+        fstatus.mCompany  = info.mCompany;
+        CARDSetBannerFmt(&fstatus, info.mBannerImage ? info.mBannerFmt : 0);  // 0 is no banner
+        CARDSetIconAddr(&fstatus, CARD_DIRENTRY_SIZE);
+        CARDSetCommentAddr(&fstatus, 4);
+        for (s32 i = 0; info.mIconTable && i < info.mIconCount; ++i) {
+            CARDSetIconFmt(&fstatus, i, info.mIconFmt);
+            CARDSetIconSpeed(&fstatus, i, info.mIconSpeed);
         }
+        fstatus.mLastModified = OSTicksToSeconds(OSGetTime());
+
+        CARDSetStatus(finfo->mChannel, finfo->mFileNo, &fstatus);
+    }
 
-        size_t dataPosOut = CARD_DIRENTRY_SIZE + 0xE00 + (0x500 * info.mIconCount);
+    for (size_t i = 0; i < info.mBlocks; ++i) {
+        if (!isBlockDirty[i])
+            continue;
+
+        const size_t offset = CARD_BLOCKS_TO_BYTES(i);
 
-        // Write contents to save file
-        JSUMemoryInputStream in(sCardBuffer + dataPosOut, saveDataSize - dataPosOut);
-        for (auto &setting : group.getSettings()) {
-            setting->load(in);
+        s32 result = writeCardBlock(finfo, offset);
+        // OSReport("Result (WRITE): %d\n", result);
+        if (result < CARD_ERROR_READY) {
+            if (commit)
+                commit->mIsValid = false;
+            return result;
         }
     }
 
+    if (commit) {
+        memcpy(commit->mBlockHashes, blockHashes, sizeof(u32) * info.mBlocks);
+        commit->mPayloadHash = payloadHash;
+        commit->mIsValid     = true;
+    }
+
+    if (&group == getSharedSettingsHost()) {
+        const size_t payloadOffset = getSettingsPayloadOffset(info);
+        cacheSharedPayload(reinterpret_cast<const u8 *>(sCardBuffer) + payloadOffset,
+                           CARD_BLOCKS_TO_BYTES(info.mBlocks) - payloadOffset);
+    }
+
     return CARD_ERROR_READY;
 }
 
-s32 CloseSavedSettings(const Settings::SettingsGroup &group, CARDFileInfo *finfo) {
-    auto &info = group.getSaveInfo();
-    if (info.mSaveGlobal)
-        __CARDSetDiskID(&info.mGameCode);
-    s32 ret = CARDClose(finfo);
-    if (info.mSaveGlobal)
-        __CARDSetDiskID(DISK_GAME_ID);
-    return ret;
+static s32 readSavedSettings_(Settings::SettingsGroup &group, Settings::SettingsGroup &owner,
+                              CARDFileInfo *finfo);
+
+// A packed group missing from the engine's save may have been spilled to a file of its own
+static s32 readSpilledSettings(Settings::SettingsGroup &group) {
+    CARDFileInfo finfo;
+    if (OpenSavedSettings(group, finfo, false) < CARD_ERROR_READY)
+        return CARD_ERROR_NOFILE;
+
+    const s32 result = readSavedSettings_(group, group, &finfo);
+    CloseSavedSettings(group, &finfo);
+    return result;
 }
 
-static TCardBookmarkInfo sBookMarkInfo;
+s32 ReadSavedSettings(Settings::SettingsGroup &group, CARDFileInfo *finfo) {
+    return readSavedSettings_(group, getSettingsFileOwner(group), finfo);
+}
 
-s32 SaveAllSettings() {
-    {
-        gpCardManager->getBookmarkInfos(&sBookMarkInfo);
-        while (gpCardManager->mCommand == TCardManager::GETBOOKMARKS) {
-            // Wait for save to finish
-            OSYieldThread();
-        }
+static s32 readSavedSettings_(Settings::SettingsGroup &group, Settings::SettingsGroup &owner,
+                              CARDFileInfo *finfo) {
+    const u8 *payload;
+    size_t payloadSize;
 
-        if (s32 status = gpCardManager->getLastStatus()) {
-            OSPanic(__FILE__, __LINE__,
-                    "Failed to get bookmark info for autosave! (Status: %d)\nMake sure your memory "
-                    "card is okay "
-                    "and that you haven't loaded a savestate that was made before your last save!",
-                    status);
-            return status;
-        }
+    if (&owner != &group && sIsSharedPayloadValid) {
+        payload     = sSharedPayload;
+        payloadSize = sSharedPayloadSize;
+    } else {
+        if (s32 result = readSettingsImage(owner, finfo))
+            return result;
 
-        JSUMemoryOutputStream out(nullptr, 0);
-        gpCardManager->getWriteStream(&out);
-        TFlagManager::smInstance->save(out);
-        gpCardManager->writeBlock(gpApplication.mCurrentSaveBlock);  // This is the block being used
-        while (gpCardManager->mCommand == TCardManager::SAVEBLOCK) {
-            // Wait for save to finish
-            OSYieldThread();
-        }
+        const Settings::SettingsSaveInfo &info = owner.getSaveInfo();
+        const size_t payloadOffset             = getSettingsPayloadOffset(info);
 
-        if (s32 status = gpCardManager->getLastStatus()) {
-            OSPanic(__FILE__, __LINE__,
-                    "Failed to save block for autosave! (Status: %d)\nMake sure your memory card "
-                    "is okay and that "
-                    "you haven't loaded a savestate that was made before your last save!",
-                    status);
-            return status;
-        }
+        payload     = reinterpret_cast<const u8 *>(sCardBuffer) + payloadOffset;
+        payloadSize = CARD_BLOCKS_TO_BYTES(info.mBlocks) - payloadOffset;
 
-        gpCardManager->unmount();
-        TFlagManager::smInstance->saveSuccess();
-    }
+        if (!isTaggedPayload(payload, payloadSize)) {
+            if (&owner != &group)
+                return CARD_ERROR_READY;
 
-    {
-        s32 cardStatus = Settings::mountCard();
-        {
-            if (cardStatus < CARD_ERROR_READY) {
-                OSPanic(__FILE__, __LINE__,
-                        "Failed to mount memory card for autosave! (Status: %d)\nMake sure your "
-                        "memory card is okay and that you haven't loaded a savestate that was made "
-                        "before your last save!",
-                        cardStatus);
-
-                gpCardManager->mount_(true);
-                return cardStatus;
+            // Positional save from before the tagged format, rewritten on the next save
+            if (sCardBuffer[0] != group.getMajorVersion()) {
+                return CARD_ERROR_BROKEN;
             }
-            Settings::saveAllSettings();
-            Settings::unmountCard();
-        }
 
-        gpCardManager->mount_(true);
+            JSUMemoryInputStream in(payload, payloadSize);
+            for (auto &setting : group.getSettings()) {
+                setting->load(in);
+            }
+            return CARD_ERROR_READY;
+        }
     }
 
-    {
-        JSUMemoryOutputStream out(nullptr, 0);
-        gpCardManager->getOptionWriteStream(&out);
-        TFlagManager::smInstance->saveOption(out);
-        gpCardManager->writeOptionBlock();
+    // The engine's save predates the tagged format, nothing is packed into it yet
+    if (payloadSize == 0)
+        return CARD_ERROR_READY;
 
-        OSReport("Last Status (Option Save): %d\n", gpCardManager->getLastStatus());
-    }
+    s32 result = loadSettingsSection(group, payload, payloadSize);
+    if (result == CARD_ERROR_NOFILE && &owner != &group)
+        result = readSpilledSettings(group);
+    if (result == CARD_ERROR_NOFILE)
+        result = CARD_ERROR_READY;
 
-    return CARD_ERROR_READY;
+    return result;
+}
+
+s32 CloseSavedSettings(const Settings::SettingsGroup &group, CARDFileInfo *finfo) {
+    auto &info = group.getSaveInfo();
+    if (info.mSaveGlobal)
+        __CARDSetDiskID(&info.mGameCode);
+    s32 ret = CARDClose(finfo);
+    if (info.mSaveGlobal)
+        __CARDSetDiskID(DISK_GAME_ID);
+    return ret;
 }
 
 SettingsDirector::~SettingsDirector() { gpMSound->exitStage(); }
@@ -828,9 +1473,10 @@ void SettingsDirector::initializeSettingsLayout() {
 
     int i = 0;
     TGlobalVector<Settings::SettingsGroup *> settingsGroups;
-    getSettingsGroups(settingsGroups);
-
-    settingsGroups.insert(settingsGroups.begin(), &sSunshineSettingsGroup);
+    settingsGroups.insert(settingsGroups.end(), &sSunshineSettingsGroup);
+    for (auto &group : getSettingsGroups()) {
+        settingsGroups.insert(settingsGroups.end(), group);
+    }
 
     for (auto &group : settingsGroups) {
         auto *groupName = Settings::getGroupName(*group);
@@ -1181,9 +1827,6 @@ void SettingsDirector::saveSettings_() {
 
         CARDFileInfo finfo;
 
-        TGlobalVector<Settings::SettingsGroup *> groups;
-        getSettingsGroups(groups);
-
         Settings::saveAllSettings();
 
         Settings::unmountCard();
@@ -1238,7 +1881,31 @@ SMS_PATCH_BL(SMS_PORT_REGION(0x80299D0C, 0, 0, 0), checkForSettingsMenu);
 
 static J2DScreen *sNotificationScreen;
 static J2DTextBox *sNotificationBox;
-static TGlobalVector<TGlobalString> sUnlockedSettings;
+struct UnlockNotification {
+    char mText[100];
+    UnlockNotification *mNext;
+};
+
+static TObjectPool<UnlockNotification, 16> sUnlockNotificationPool("Unlock Notifications");
+static UnlockNotification *sUnlockedSettings     = nullptr;
+static UnlockNotification *sUnlockedSettingsTail = nullptr;
+
+// Set when unlocks were left for later because every notification slot was live
+static bool sHasDeferredUnlocks = false;
+
+static void popUnlockNotification() {
+    UnlockNotification *notif = sUnlockedSettings;
+    sUnlockedSettings         = notif->mNext;
+    if (!sUnlockedSettings)
+        sUnlockedSettingsTail = nullptr;
+    sUnlockNotificationPool.destroy(notif);
+
+    // A slot just freed up, so pick up the deferred unlocks on the next update
+    if (sHasDeferredUnlocks) {
+        sHasDeferredUnlocks     = false;
+        sIsUnlockCheckRequested = true;
+    }
+}
 
 static OSTime sLastTime  = 0;
 static int sVisualState  = 0;
@@ -1270,8 +1937,12 @@ inline size_t setting_hash::operator()(BetterSMS::Settings::SingleSetting *v) co
 BETTER_SMS_FOR_CALLBACK void initUnlockedSettings(TApplication *app) {
     sLastTime = 0;
 
-    sUnlockedSettings.clear();
-    sNewUnlockMap.clear();
+    while (sUnlockedSettings) {
+        popUnlockNotification();
+    }
+    sHasDeferredUnlocks = false;
+    sIsUnlockInfosValid = false;
+    sUnlockPollTimer    = 0;
 
     memset(sNotifTextBuf, 0, 128);
 
@@ -1298,57 +1969,70 @@ BETTER_SMS_FOR_CALLBACK void initUnlockedSettings(TApplication *app) {
     sVisualState = 0;
 }
 
-BETTER_SMS_FOR_CALLBACK void
-checkForUnlockedSettings(const Settings::SettingsGroup &group,
-                         TGlobalVector<Settings::SingleSetting *> &out) {
-    SettingMetaInfo *info = nullptr;
-    for (auto &setting : group.getSettings()) {
-        for (size_t i = 0; i < sNewUnlockMap.size(); ++i) {
-            if (strcmp(sNewUnlockMap[i].mID, setting->getName()) == 0) {
-                info = &sNewUnlockMap[i];
-                break;
-            }
+static void rebuildUnlockInfos() {
+    sUnlockInfos.clear();
+    for (auto &group : getSettingsGroups()) {
+        for (auto &setting : group->getSettings()) {
+            sUnlockInfos.push_back({setting, group, isSettingAccessible(*setting)});
         }
+    }
+    sIsUnlockInfosValid = true;
+}
 
-        bool isSettingAccessible = setting->isUnlocked() && setting->isUserEditable();
+// Returns false when every slot is live, the caller keeps the setting pending in that case
+static bool pushUnlockNotification(const Settings::SettingsGroup &group,
+                                   const Settings::SingleSetting &setting) {
+    UnlockNotification *notif = sUnlockNotificationPool.construct();
+    if (!notif)
+        return false;
 
-        if (info == nullptr) {
-            sNewUnlockMap.push_back({setting->getName(), isSettingAccessible});
-            continue;
-        }
+    snprintf(notif->mText, sizeof(notif->mText), "%s\n\nUnlocked the \"%s\" setting!",
+             Settings::getGroupName(group), setting.getName());
+    notif->mNext = nullptr;
 
-        if (isSettingAccessible &&
-            !info->mIsUnlocked) {  // This means the setting was just unlocked
-            out.insert(out.begin(), setting);
-            info->mIsUnlocked = true;
-        }
+    if (sUnlockedSettingsTail)
+        sUnlockedSettingsTail->mNext = notif;
+    else
+        sUnlockedSettings = notif;
+    sUnlockedSettingsTail = notif;
+
+    if (sUnlockedSettings == notif) {
+        strncpy(sNotificationBox->mStrPtr, notif->mText, 100);
     }
+    return true;
 }
 
+BETTER_SMS_FOR_EXPORT void Settings::requestUnlockCheck() { sIsUnlockCheckRequested = true; }
+
 BETTER_SMS_FOR_CALLBACK void updateUnlockedSettings(TApplication *app) {
-    TGlobalVector<Settings::SettingsGroup *> groups;
-    getSettingsGroups(groups);
+    if (!sIsUnlockCheckRequested && ++sUnlockPollTimer < UNLOCK_POLL_INTERVAL)
+        return;
 
-    for (auto &group : groups) {
-        TGlobalVector<Settings::SingleSetting *> unlockedSettings;
-        checkForUnlockedSettings(*group, unlockedSettings);
+    sIsUnlockCheckRequested = false;
+    sUnlockPollTimer        = 0;
 
-        for (auto &setting : unlockedSettings) {
-            char notifbuf[128];
-            snprintf(notifbuf, 100, "%s\n\nUnlocked the \"%s\" setting!",
-                     Settings::getGroupName(*group), setting->getName());
+    // Settings seen for the first time are taken as they are, only changes notify
+    if (!sIsUnlockInfosValid) {
+        rebuildUnlockInfos();
+        return;
+    }
 
-            sUnlockedSettings.push_back(notifbuf);
+    for (auto &info : sUnlockInfos) {
+        if (info.mIsUnlocked || !isSettingAccessible(*info.mSetting))
+            continue;
 
-            if (sUnlockedSettings.size() == 1) {
-                strncpy(sNotificationBox->mStrPtr, notifbuf, 100);
-            }
+        // Left locked in the cache, so it is found again once a notification has been shown
+        if (!pushUnlockNotification(*info.mGroup, *info.mSetting)) {
+            sHasDeferredUnlocks = true;
+            break;
         }
+
+        info.mIsUnlocked = true;
     }
 }
 
 BETTER_SMS_FOR_CALLBACK void drawUnlockedSettings(TApplication *app, const J2DOrthoGraph *ortho) {
-    if (sUnlockedSettings.size() == 0)
+    if (!sUnlockedSettings)
         return;
 
     ReInitializeGX();
@@ -1377,10 +2061,9 @@ BETTER_SMS_FOR_CALLBACK void drawUnlockedSettings(TApplication *app, const J2DOr
     } else {
         sNotificationBox->mAlpha = Max(sNotificationBox->mAlpha - 10, 0);
         if (sNotificationBox->mAlpha == 0) {
-            sUnlockedSettings.erase(sUnlockedSettings.begin());
-            if (sUnlockedSettings.size() > 0) {
-                auto notif = sUnlockedSettings.begin();
-                strncpy(sNotificationBox->mStrPtr, notif->c_str(), 100);
+            popUnlockNotification();
+            if (sUnlockedSettings) {
+                strncpy(sNotificationBox->mStrPtr, sUnlockedSettings->mText, 100);
             }
             sVisualState = 0;
         }
@@ -1,4 +1,6 @@
 #include <Dolphin/DVD.h>
+#include <Dolphin/OS.h>
+#include <Dolphin/mem.h>
 #include <JSystem/J2D/J2DOrthoGraph.hxx>
 #include <JSystem/JDrama/JDRNameRef.hxx>
 
@@ -12,6 +14,7 @@
 
 #include "libs/container.hxx"
 #include "libs/global_vector.hxx"
+#include "libs/lock.hxx"
 #include "libs/profiler.hxx"
 #include "libs/string.hxx"
 
@@ -20,12 +23,14 @@
 #include "module.hxx"
 #include "stage.hxx"
 
+#include "p_module.hxx"
+
 using namespace BetterSMS;
 
-static TGlobalVector<Stage::InitCallback> sStageInitCBs;
-static TGlobalVector<Stage::UpdateCallback> sStageUpdateCBs;
-static TGlobalVector<Stage::Draw2DCallback> sStageDrawCBs;
-static TGlobalVector<Stage::ExitCallback> sStageExitCBs;
+static TGlobalVector<TModuleCallback<Stage::InitCallback>> sStageInitCBs;
+static TGlobalVector<TModuleCallback<Stage::UpdateCallback>> sStageUpdateCBs;
+static TGlobalVector<TModuleCallback<Stage::Draw2DCallback>> sStageDrawCBs;
+static TGlobalVector<TModuleCallback<Stage::ExitCallback>> sStageExitCBs;
 
 Stage::TStageParams *Stage::TStageParams::sStageConfig = nullptr;
 
@@ -34,22 +39,22 @@ BETTER_SMS_FOR_EXPORT Stage::TStageParams *BetterSMS::Stage::getStageConfigurati
 }
 
 BETTER_SMS_FOR_EXPORT bool BetterSMS::Stage::addInitCallback(InitCallback cb) {
-    sStageInitCBs.push_back(cb);
+    sStageInitCBs.push_back(makeModuleCallback(cb, "Stage::Init"));
     return true;
 }
 
 BETTER_SMS_FOR_EXPORT bool BetterSMS::Stage::addUpdateCallback(UpdateCallback cb) {
-    sStageUpdateCBs.push_back(cb);
+    sStageUpdateCBs.push_back(makeModuleCallback(cb, "Stage::Update"));
     return true;
 }
 
 BETTER_SMS_FOR_EXPORT bool BetterSMS::Stage::addDraw2DCallback(Draw2DCallback cb) {
-    sStageDrawCBs.push_back(cb);
+    sStageDrawCBs.push_back(makeModuleCallback(cb, "Stage::Draw2D"));
     return true;
 }
 
 BETTER_SMS_FOR_EXPORT bool BetterSMS::Stage::addExitCallback(ExitCallback cb) {
-    sStageExitCBs.push_back(cb);
+    sStageExitCBs.push_back(makeModuleCallback(cb, "Stage::Exit"));
     return true;
 }
 
@@ -68,21 +73,96 @@ BETTER_SMS_FOR_EXPORT const char *BetterSMS::Stage::getStageName(u8 area, u8 epi
     return stageName.mArchiveName;
 }
 
-BETTER_SMS_FOR_EXPORT bool BetterSMS::Stage::isDivingStage(u8 area, u8 episode) {
-    Stage::TStageParams params;
-    if (const char *stageName = Stage::getStageName(area, episode)) {
-        params.load(stageName);
+#pragma region ParamsCache
+
+#define STAGE_PARAMS_CACHE_SIZE 128
+
+// Compact result of a stage .prm lookup, so menus that query many stages don't seek the disc
+struct StageParamsCacheEntry {
+    u16 mKey;
+    Stage::TStageParams::ConfigKind mKind;
+    bool mIsValid;
+    bool mIsExStage;
+    bool mIsDivingStage;
+};
+
+static StageParamsCacheEntry *sStageParamsCache = nullptr;
+
+// Filled on every call when the cache couldn't be allocated
+static StageParamsCacheEntry sStageParamsUncached;
+
+u32 gStageParamsCacheHits   = 0;
+u32 gStageParamsCacheMisses = 0;
+
+static StageParamsCacheEntry *findStageParamsSlot(u16 key, u8 area, u8 episode) {
+    if (!sStageParamsCache) {
+        sStageParamsCache = static_cast<StageParamsCacheEntry *>(JKRHeap::alloc(
+            sizeof(StageParamsCacheEntry) * STAGE_PARAMS_CACHE_SIZE, 4, JKRHeap::sSystemHeap));
+        if (!sStageParamsCache)
+            return nullptr;
+        memset(sStageParamsCache, 0, sizeof(StageParamsCacheEntry) * STAGE_PARAMS_CACHE_SIZE);
+    }
+
+    // Open addressing, the home slot is replaced once the probe window is exhausted
+    const u32 home = (area * 8 + episode) % STAGE_PARAMS_CACHE_SIZE;
+    StageParamsCacheEntry *slot = &sStageParamsCache[home];
+    for (u32 i = 0; i < 8; ++i) {
+        StageParamsCacheEntry *probe = &sStageParamsCache[(home + i) % STAGE_PARAMS_CACHE_SIZE];
+        if (!probe->mIsValid || probe->mKey == key)
+            return probe;
     }
-    return params.mIsDivingStage.get();
+    return slot;
 }
 
-BETTER_SMS_FOR_EXPORT bool BetterSMS::Stage::isExStage(u8 area, u8 episode) {
+static const StageParamsCacheEntry *getCachedStageParams(u8 area, u8 episode) {
+    const u16 key = (area << 8) | episode;
+
+    StageParamsCacheEntry *slot = findStageParamsSlot(key, area, episode);
+    if (!slot) {
+        slot = &sStageParamsUncached;
+    } else if (slot->mIsValid && slot->mKey == key) {
+        gStageParamsCacheHits += 1;
+        return slot;
+    }
+
+    gStageParamsCacheMisses += 1;
+
     Stage::TStageParams params;
+    params.reset();
+
+    Stage::TStageParams::ConfigKind kind = Stage::TStageParams::ConfigKind::NONE;
     if (const char *stageName = Stage::getStageName(area, episode)) {
-        params.load(stageName);
+        kind = params.load(stageName);
     }
-    if (params.isCustomConfig()) {
-        return params.mIsExStage.get();
+
+    slot->mKey           = key;
+    slot->mKind          = kind;
+    slot->mIsValid       = true;
+    slot->mIsExStage     = params.mIsExStage.get();
+    slot->mIsDivingStage = params.mIsDivingStage.get();
+    return slot;
+}
+
+// Extern to stage exit
+BETTER_SMS_FOR_CALLBACK void invalidateStageParamsCache(TApplication *app) {
+    if (!sStageParamsCache)
+        return;
+
+    for (size_t i = 0; i < STAGE_PARAMS_CACHE_SIZE; ++i) {
+        sStageParamsCache[i].mIsValid = false;
+    }
+}
+
+#pragma endregion
+
+BETTER_SMS_FOR_EXPORT bool BetterSMS::Stage::isDivingStage(u8 area, u8 episode) {
+    return getCachedStageParams(area, episode)->mIsDivingStage;
+}
+
+BETTER_SMS_FOR_EXPORT bool BetterSMS::Stage::isExStage(u8 area, u8 episode) {
+    const StageParamsCacheEntry *entry = getCachedStageParams(area, episode);
+    if (entry->mKind != TStageParams::ConfigKind::NONE) {
+        return entry->mIsExStage;
     } else {
         return (area >= TGameSequence::AREA_DOLPICEX0 && area <= TGameSequence::AREA_COROEX6);
     }
@@ -154,50 +234,178 @@ char *BetterSMS::Stage::TStageParams::stageNameToParamPath(char *dst, const char
     return dst;
 }
 
-void BetterSMS::Stage::TStageParams::load(const char *stageName) {
+bool BetterSMS::Stage::TStageParams::loadFromPath(const char *path) {
     DVDFileInfo fileInfo;
-    s32 entrynum;
 
+    s32 entrynum = DVDConvertPathToEntrynum(path);
+    if (entrynum < 0)
+        return false;
+
+    DVDFastOpen(entrynum, &fileInfo);
+    void *buffer = JKRHeap::alloc(fileInfo.mLen, 32, nullptr);
+
+    DVDReadPrio(&fileInfo, buffer, fileInfo.mLen, 0, 2);
+    DVDClose(&fileInfo);
+    {
+        JSUMemoryInputStream stream(buffer, fileInfo.mLen);
+        loadFromStream(stream);
+        JKRHeap::free(buffer, nullptr);
+    }
+    return true;
+}
+
+void BetterSMS::Stage::TStageParams::loadFromStream(JSUMemoryInputStream &stream) {
+    TParams::load(stream);
+    mIsCustomConfigLoaded = true;
+}
+
+BetterSMS::Stage::TStageParams::ConfigKind
+BetterSMS::Stage::TStageParams::load(const char *stageName) {
     char path[64];
+
     stageNameToParamPath(path, stageName, false);
+    if (loadFromPath(path))
+        return ConfigKind::SPECIFIC;
 
-    entrynum = DVDConvertPathToEntrynum(path);
-    if (entrynum >= 0) {
-        DVDFastOpen(entrynum, &fileInfo);
-        void *buffer = JKRHeap::alloc(fileInfo.mLen, 32, nullptr);
-
-        DVDReadPrio(&fileInfo, buffer, fileInfo.mLen, 0, 2);
-        DVDClose(&fileInfo);
-        {
-            JSUMemoryInputStream stream(buffer, fileInfo.mLen);
-            TParams::load(stream);
-            JKRHeap::free(buffer, nullptr);
-        }
-        mIsCustomConfigLoaded = true;
-        return;
+    stageNameToParamPath(path, stageName, true);
+    if (loadFromPath(path))
+        return ConfigKind::GENERALIZED;
+
+    reset();
+    return ConfigKind::NONE;
+}
+
+#pragma region ParamsPrefetch
+
+enum class PrefetchState : u8 { IDLE, BUSY, READY, FAILED };
+
+// Two slots so a retargeted transition can start a new read while the old one drains
+struct StageParamsPrefetch {
+    SMS_ALIGN(32) DVDFileInfo mFileInfo;
+    void *mBuffer;
+    u32 mSize;
+    u16 mKey;
+    volatile PrefetchState mState;
+};
+
+static StageParamsPrefetch sStageParamsPrefetch[2];
+static OSThreadQueue sStageParamsPrefetchQueue;
+static bool sIsPrefetchQueueInitialized = false;
+
+static void releasePrefetch(StageParamsPrefetch &prefetch) {
+    if (prefetch.mState != PrefetchState::IDLE)
+        DVDClose(&prefetch.mFileInfo);
+    if (prefetch.mBuffer) {
+        JKRHeap::free(prefetch.mBuffer, JKRHeap::sSystemHeap);
+        prefetch.mBuffer = nullptr;
     }
+    prefetch.mState = PrefetchState::IDLE;
+}
 
-    stageNameToParamPath(path, stageName, true);
+static void cbForStageParamsReadAsync_(u32 result, DVDFileInfo *finfo) {
+    for (auto &prefetch : sStageParamsPrefetch) {
+        if (&prefetch.mFileInfo != finfo)
+            continue;
+        prefetch.mState = static_cast<s32>(result) < 0 ? PrefetchState::FAILED
+                                                        : PrefetchState::READY;
+    }
+    OSWakeupThread(&sStageParamsPrefetchQueue);
+}
+
+static s32 resolveStageParamsEntry(const char *stageName) {
+    char path[64];
+
+    Stage::TStageParams::stageNameToParamPath(path, stageName, false);
+    s32 entrynum = DVDConvertPathToEntrynum(path);
+    if (entrynum >= 0)
+        return entrynum;
+
+    Stage::TStageParams::stageNameToParamPath(path, stageName, true);
+    return DVDConvertPathToEntrynum(path);
+}
+
+BETTER_SMS_FOR_EXPORT bool BetterSMS::Stage::prefetchStageParams(u8 area, u8 episode) {
+    if (!sIsPrefetchQueueInitialized) {
+        OSInitThreadQueue(&sStageParamsPrefetchQueue);
+        sIsPrefetchQueueInitialized = true;
+    }
+
+    const u16 key = (area << 8) | episode;
+
+    StageParamsPrefetch *target = nullptr;
+    for (auto &prefetch : sStageParamsPrefetch) {
+        if (prefetch.mKey == key && (prefetch.mState == PrefetchState::BUSY ||
+                                     prefetch.mState == PrefetchState::READY))
+            return true;
+        if (prefetch.mState != PrefetchState::BUSY && !target)
+            target = &prefetch;
+    }
+
+    // Both reads are in flight, the director falls back to a synchronous load
+    if (!target)
+        return false;
+
+    releasePrefetch(*target);
+
+    const char *stageName = getStageName(area, episode);
+    if (!stageName)
+        return false;
 
-    entrynum = DVDConvertPathToEntrynum(path);
-    if (entrynum >= 0) {
-        DVDFastOpen(entrynum, &fileInfo);
-        void *buffer = JKRHeap::alloc(fileInfo.mLen, 32, nullptr);
-
-        DVDReadPrio(&fileInfo, buffer, fileInfo.mLen, 0, 2);
-        DVDClose(&fileInfo);
-        {
-            JSUMemoryInputStream stream(buffer, fileInfo.mLen);
-            TParams::load(stream);
-            JKRHeap::free(buffer, nullptr);
+    const s32 entrynum = resolveStageParamsEntry(stageName);
+    if (entrynum < 0 || !DVDFastOpen(entrynum, &target->mFileInfo))
+        return false;
+
+    target->mSize   = OSRoundUp32B(target->mFileInfo.mLen);
+    target->mBuffer = JKRHeap::alloc(target->mSize, 32, JKRHeap::sSystemHeap);
+    if (!target->mBuffer) {
+        DVDClose(&target->mFileInfo);
+        return false;
+    }
+
+    target->mKey   = key;
+    target->mState = PrefetchState::BUSY;
+
+    if (!DVDReadAsync(&target->mFileInfo, target->mBuffer, target->mSize, 0,
+                      cbForStageParamsReadAsync_)) {
+        releasePrefetch(*target);
+        return false;
+    }
+
+    return true;
+}
+
+// Parses the prefetched params for this stage if a read was issued, blocking only on the remainder
+static bool consumePrefetchedStageParams(Stage::TStageParams *config, u8 area, u8 episode) {
+    if (!sIsPrefetchQueueInitialized)
+        return false;
+
+    const u16 key = (area << 8) | episode;
+
+    bool consumed = false;
+    for (auto &prefetch : sStageParamsPrefetch) {
+        if (prefetch.mState == PrefetchState::BUSY && prefetch.mKey == key) {
+            TAtomicGuard guard;
+            while (prefetch.mState == PrefetchState::BUSY) {
+                OSSleepThread(&sStageParamsPrefetchQueue);
+            }
         }
-        mIsCustomConfigLoaded = true;
-        return;
+
+        if (prefetch.mState == PrefetchState::READY && prefetch.mKey == key && !consumed) {
+            JSUMemoryInputStream stream(prefetch.mBuffer, prefetch.mFileInfo.mLen);
+            config->loadFromStream(stream);
+            consumed = true;
+        }
+
+        // Stale reads are dropped here so the system heap isn't held across the stage
+        if (prefetch.mState != PrefetchState::BUSY)
+            releasePrefetch(prefetch);
     }
 
-    reset();
+    return consumed;
 }
 
+#pragma endregion
+
 void initStageLoading(TMarDirector *director) {
     Loading::setLoading(true);
     director->loadResource();
@@ -213,8 +421,12 @@ BETTER_SMS_FOR_CALLBACK void loadStageConfig(TMarDirector *) {
 
     Stage::TStageParams *config = Stage::getStageConfiguration();
     config->reset();
-    config->load(Stage::getStageName(gpApplication.mCurrentScene.mAreaID,
-                                     gpApplication.mCurrentScene.mEpisodeID));
+
+    const u8 area    = gpApplication.mCurrentScene.mAreaID;
+    const u8 episode = gpApplication.mCurrentScene.mEpisodeID;
+    if (!consumePrefetchedStageParams(config, area, episode)) {
+        config->load(Stage::getStageName(area, episode));
+    }
 }
 
 // Extern to stage init
@@ -243,8 +455,11 @@ void initStageCallbacks(TMarDirector *director) {
 
     loadStageConfig(director);
 
-    for (auto &item : sStageInitCBs) {
-        item(director);
+    {
+        BETTERSMS_PROFILE_ZONE("Stage::Init");
+        for (auto &item : sStageInitCBs) {
+            item(director);
+        }
     }
 
     director->setupObjects();
@@ -263,6 +478,7 @@ void updateStageCallbacks(TApplication *app) {
         return;
 
     if (gpMarDirector && app->mContext == TApplication::CONTEXT_DIRECT_STAGE) {
+        BETTERSMS_PROFILE_ZONE("Stage::Update");
         for (auto &item : sStageUpdateCBs) {
             item(gpMarDirector);
         }
@@ -272,6 +488,7 @@ void updateStageCallbacks(TApplication *app) {
 void drawStageCallbacks(J2DOrthoGraph *ortho) {
     ortho->setup2D();
 
+    BETTERSMS_PROFILE_ZONE("Stage::Draw2D");
     for (auto &item : sStageDrawCBs) {
         item(gpMarDirector, ortho);
     }
@@ -284,8 +501,11 @@ void exitStageCallbacks(TApplication *app) {
     if (app->mContext != TApplication::CONTEXT_DIRECT_STAGE)
         return;
 
-    for (auto &item : sStageExitCBs) {
-        item(app);
+    {
+        BETTERSMS_PROFILE_ZONE("Stage::Exit");
+        for (auto &item : sStageExitCBs) {
+            item(app);
+        }
     }
 
     resetStageConfig(app);
@@ -0,0 +1,4 @@
+#pragma once
+
+// Host stand-in for the SDK header, the kernels only need the libm basics
+#include <math.h>
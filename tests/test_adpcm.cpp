@@ -0,0 +1,130 @@
+#include <chrono>
+#include <stdio.h>
+#include <string.h>
+#include <vector>
+
+#include "p_adpcm.hxx"
+
+// Decodes the reference .adp through the engine's ADP kernel and checks every sample against
+// the PCM produced by tools/make_adp_reference.py, then reports the kernel's throughput.
+
+static bool readFile(const char *name, std::vector<u8> &out) {
+    char path[512];
+    snprintf(path, sizeof(path), "%s/%s", BETTER_SMS_TEST_DATA_DIR, name);
+
+    FILE *file = fopen(path, "rb");
+    if (!file) {
+        fprintf(stderr, "adpcm: can't open %s\n", path);
+        return false;
+    }
+
+    fseek(file, 0, SEEK_END);
+    out.resize(ftell(file));
+    fseek(file, 0, SEEK_SET);
+    const bool isRead = fread(out.data(), 1, out.size(), file) == out.size();
+    fclose(file);
+    return isRead;
+}
+
+static void decodeFrames(const std::vector<u8> &adp, size_t first, size_t last,
+                         ADPHistory *history, s16 *out) {
+    for (size_t i = first; i < last; ++i)
+        decodeADPFrame(&adp[i * ADPFrameSize], out + (i - first) * ADPFrameSamples * 2, history);
+}
+
+static bool checkReference(const std::vector<u8> &adp, const std::vector<u8> &pcm) {
+    const size_t frames = adp.size() / ADPFrameSize;
+    if (adp.size() % ADPFrameSize != 0 || pcm.size() != frames * ADPFrameSamples * 4) {
+        fprintf(stderr, "adpcm: %zu bytes of ADP don't match %zu bytes of PCM\n", adp.size(),
+                pcm.size());
+        return false;
+    }
+
+    std::vector<s16> decoded(frames * ADPFrameSamples * 2);
+    ADPHistory history[2] = {};
+    decodeFrames(adp, 0, frames, history, decoded.data());
+
+    u32 failures = 0;
+    for (size_t i = 0; i < decoded.size(); ++i) {
+        const s16 expected = (s16)(pcm[i * 2] | (pcm[i * 2 + 1] << 8));
+        if (decoded[i] == expected)
+            continue;
+
+        if (failures++ < 8) {
+            fprintf(stderr, "frame %zu sample %zu %s: expected %d, decoded %d\n",
+                    i / (ADPFrameSamples * 2), (i / 2) % ADPFrameSamples, i & 1 ? "R" : "L",
+                    expected, decoded[i]);
+        }
+    }
+
+    if (failures > 0) {
+        fprintf(stderr, "adpcm: %u of %zu samples diverged\n", failures, decoded.size());
+        return false;
+    }
+
+    // A loop back has to restore the history saved at the loop start, or the predictor carries
+    // the loop end's state into the first frames and the replay drifts
+    const size_t loopStart = frames / 3;
+    const size_t loopEnd   = frames / 2;
+
+    ADPHistory loopHistory[2] = {};
+    decodeFrames(adp, 0, loopStart, loopHistory, decoded.data());
+
+    const ADPHistory savedHistory[2] = {loopHistory[0], loopHistory[1]};
+    std::vector<s16> firstPass((loopEnd - loopStart) * ADPFrameSamples * 2);
+    decodeFrames(adp, loopStart, loopEnd, loopHistory, firstPass.data());
+
+    loopHistory[0] = savedHistory[0];
+    loopHistory[1] = savedHistory[1];
+    std::vector<s16> secondPass(firstPass.size());
+    decodeFrames(adp, loopStart, loopEnd, loopHistory, secondPass.data());
+
+    if (memcmp(firstPass.data(), secondPass.data(), firstPass.size() * sizeof(s16)) != 0) {
+        fprintf(stderr, "adpcm: loop replay with restored history diverged\n");
+        return false;
+    }
+
+    printf("adpcm: %zu frames (%zu stereo samples) match the reference\n", frames,
+           frames * ADPFrameSamples);
+    return true;
+}
+
+static void benchmark(const std::vector<u8> &adp) {
+    typedef std::chrono::steady_clock Clock;
+
+    const size_t frames = adp.size() / ADPFrameSize;
+    const int passes    = 400;
+
+    std::vector<s16> decoded(frames * ADPFrameSamples * 2);
+    u32 checksum = 0;
+
+    const Clock::time_point start = Clock::now();
+    for (int pass = 0; pass < passes; ++pass) {
+        ADPHistory history[2] = {};
+        decodeFrames(adp, 0, frames, history, decoded.data());
+        checksum += (u16)decoded[pass % decoded.size()];
+    }
+    const Clock::time_point end = Clock::now();
+
+    const f64 samples = (f64)frames * ADPFrameSamples * passes;
+    const f64 secs    = std::chrono::duration<f64>(end - start).count();
+
+    // One stereo sample per output frame, a stream plays 48000 of them a second
+    printf("adpcm: %.2f M stereo samples/s (%.0fx a 48 kHz stream), %.1f ns/frame\n",
+           samples / secs / 1e6, samples / secs / 48000.0,
+           secs * 1e9 / ((f64)frames * passes));
+    printf("adpcm: checksum %u\n", checksum);
+}
+
+int main() {
+    std::vector<u8> adp;
+    std::vector<u8> pcm;
+    if (!readFile("adp_reference.adp", adp) || !readFile("adp_reference.pcm", pcm))
+        return 1;
+
+    if (!checkReference(adp, pcm))
+        return 1;
+
+    benchmark(adp);
+    return 0;
+}
@@ -0,0 +1,373 @@
+#include <chrono>
+#include <stdio.h>
+#include <vector>
+
+#include "p_wall_edge.hxx"
+
+// Replays a deterministic trace of wall queries through the original per-query solver (edge
+// projections divide by the edge Y delta) and through the precomputed kernel (multiply by the
+// cached reciprocal), checks they agree and reports the throughput of both.
+//
+// The trace is synthetic: walls and queries come from a seeded generator shaped like level
+// geometry, not from a capture of the game. It checks the kernel against the reference solver,
+// but the throughput numbers don't reflect the wall mix or query locality of a real stage.
+
+struct Vec3 {
+    f32 x, y, z;
+};
+
+struct Wall {
+    Vec3 mVertices[3];
+    Vec3 mNormal;
+    f32 mProjectionFactor;
+};
+
+struct Query {
+    u32 mWall;
+    Vec3 mOrigin;
+    f32 mRadius;
+};
+
+enum WallResult { WALL_MISS, WALL_FACE, WALL_EDGE, WALL_CORNER };
+
+struct WallOutcome {
+    WallResult mResult;
+    f32 mPositions[3];
+    f32 mMarginRadius;
+    bool mIsNearBoundary;  // The reference sat within rounding of a range check
+};
+
+static u32 sSeed = 0x5EED1234;
+
+static f32 nextRandom(f32 lo, f32 hi) {
+    sSeed = sSeed * 1664525 + 1013904223;
+    return lo + (hi - lo) * (f32)(sSeed >> 8) / (f32)(1 << 24);
+}
+
+static bool isNearBoundary(f32 v) {
+    const f32 eps = 1e-4f;
+    return fabsf(v) < eps || fabsf(v - 1.0f) < eps;
+}
+
+static bool buildWall(Wall &wall) {
+    // Mostly vertical triangles with some lean, like level geometry flagged as walls
+    const f32 x  = nextRandom(-2000.0f, 2000.0f);
+    const f32 y  = nextRandom(-500.0f, 500.0f);
+    const f32 z  = nextRandom(-2000.0f, 2000.0f);
+    const f32 dx = nextRandom(-600.0f, 600.0f);
+    const f32 dz = nextRandom(-600.0f, 600.0f);
+
+    wall.mVertices[0] = {x, y, z};
+    wall.mVertices[1] = {x + dx, y + nextRandom(-300.0f, 300.0f), z + dz};
+    wall.mVertices[2] = {x + nextRandom(-80.0f, 80.0f) + dx * nextRandom(0.0f, 1.0f),
+                         y + nextRandom(200.0f, 800.0f),
+                         z + nextRandom(-80.0f, 80.0f) + dz * nextRandom(0.0f, 1.0f)};
+
+    const Vec3 &a = wall.mVertices[0];
+    const Vec3 &b = wall.mVertices[1];
+    const Vec3 &c = wall.mVertices[2];
+
+    Vec3 n = {(b.y - a.y) * (c.z - a.z) - (b.z - a.z) * (c.y - a.y),
+              (b.z - a.z) * (c.x - a.x) - (b.x - a.x) * (c.z - a.z),
+              (b.x - a.x) * (c.y - a.y) - (b.y - a.y) * (c.x - a.x)};
+
+    const f32 length = sqrtf(n.x * n.x + n.y * n.y + n.z * n.z);
+    if (length < 1.0f)
+        return false;
+
+    n.x /= length;
+    n.y /= length;
+    n.z /= length;
+
+    // The game only files planes this steep as walls
+    if (fabsf(n.y) > 0.2f)
+        return false;
+
+    wall.mNormal           = n;
+    wall.mProjectionFactor = -(n.x * a.x + n.y * a.y + n.z * a.z);
+    return true;
+}
+
+static void buildQuery(const std::vector<Wall> &walls, u32 index, Query &query) {
+    const Wall &wall = walls[index];
+
+    // Somewhere on or around the face, pushed off the plane by up to a bit more than the radius
+    f32 u = nextRandom(-0.2f, 1.2f);
+    f32 v = nextRandom(-0.2f, 1.2f);
+    if (u + v > 1.4f) {
+        u = 1.4f - u;
+        v = 1.4f - v;
+    }
+
+    const Vec3 &a = wall.mVertices[0];
+    const Vec3 &b = wall.mVertices[1];
+    const Vec3 &c = wall.mVertices[2];
+
+    query.mWall   = index;
+    query.mRadius = nextRandom(30.0f, 80.0f);
+
+    const f32 push = nextRandom(-1.2f, 1.2f) * query.mRadius;
+
+    query.mOrigin.x = a.x + (b.x - a.x) * u + (c.x - a.x) * v + wall.mNormal.x * push;
+    query.mOrigin.y = a.y + (b.y - a.y) * u + (c.y - a.y) * v;
+    query.mOrigin.z = a.z + (b.z - a.z) * u + (c.z - a.z) * v + wall.mNormal.z * push;
+}
+
+static bool getWallOffset(const Wall &wall, const Query &query, f32 &offset) {
+    offset = wall.mNormal.x * query.mOrigin.x + wall.mNormal.y * query.mOrigin.y +
+             wall.mNormal.z * query.mOrigin.z + wall.mProjectionFactor;
+    return !(offset < -query.mRadius || offset > query.mRadius);
+}
+
+// The solver step as it was before the edge cache, everything rebuilt and divided per query
+static bool solveEdgeReference(const Wall &wall, const f32 *edge, const f32 *relative,
+                               f32 *positions, f32 &margin_radius, WallOutcome &out) {
+    const f32 v = relative[1] / edge[1];
+    out.mIsNearBoundary |= isNearBoundary(v);
+    if (v < 0.0f || v > 1.0f)
+        return false;
+
+    f32 DOOD[2];
+    DOOD[0]          = edge[0] * v - relative[0];
+    DOOD[1]          = edge[2] * v - relative[2];
+    f32 invDenom     = sqrtf(DOOD[0] * DOOD[0] + DOOD[1] * DOOD[1]);
+    const f32 offset = invDenom - margin_radius;
+    out.mIsNearBoundary |= fabsf(offset) < 1e-3f;
+    if (offset > 0.0f)
+        return false;
+
+    invDenom = offset / invDenom;
+    positions[0] += (DOOD[0] *= invDenom);
+    positions[2] += (DOOD[1] *= invDenom);
+    margin_radius += 0.01f;
+
+    out.mResult = DOOD[0] * wall.mNormal.x + DOOD[1] * wall.mNormal.z < WallCornerThreshold * offset
+                      ? WALL_CORNER
+                      : WALL_EDGE;
+    return true;
+}
+
+static void solveReference(const Wall &wall, const Query &query, WallOutcome &out) {
+    const Vec3 &origin = query.mOrigin;
+    f32 *positions     = out.mPositions;
+
+    out.mResult         = WALL_MISS;
+    out.mIsNearBoundary = false;
+    out.mMarginRadius   = query.mRadius - 1.0f;
+    positions[0]        = origin.x;
+    positions[1]        = origin.y;
+    positions[2]        = origin.z;
+
+    f32 offset;
+    if (!getWallOffset(wall, query, offset))
+        return;
+
+    f32 VMatrix[3][3];
+    VMatrix[0][0] = wall.mVertices[1].x - wall.mVertices[0].x;
+    VMatrix[1][0] = wall.mVertices[2].x - wall.mVertices[0].x;
+    VMatrix[2][0] = origin.x - wall.mVertices[0].x;
+    VMatrix[0][1] = wall.mVertices[1].y - wall.mVertices[0].y;
+    VMatrix[1][1] = wall.mVertices[2].y - wall.mVertices[0].y;
+    VMatrix[2][1] = origin.y - wall.mVertices[0].y;
+    VMatrix[0][2] = wall.mVertices[1].z - wall.mVertices[0].z;
+    VMatrix[1][2] = wall.mVertices[2].z - wall.mVertices[0].z;
+    VMatrix[2][2] = origin.z - wall.mVertices[0].z;
+
+    f32 DOOD[5];
+    DOOD[0] = VMatrix[0][0] * VMatrix[0][0] + VMatrix[0][1] * VMatrix[0][1] +
+              VMatrix[0][2] * VMatrix[0][2];
+    DOOD[1] = VMatrix[0][0] * VMatrix[1][0] + VMatrix[0][1] * VMatrix[1][1] +
+              VMatrix[0][2] * VMatrix[1][2];
+    DOOD[2] = VMatrix[1][0] * VMatrix[1][0] + VMatrix[1][1] * VMatrix[1][1] +
+              VMatrix[1][2] * VMatrix[1][2];
+    DOOD[3] = VMatrix[2][0] * VMatrix[0][0] + VMatrix[2][1] * VMatrix[0][1] +
+              VMatrix[2][2] * VMatrix[0][2];
+    DOOD[4] = VMatrix[2][0] * VMatrix[1][0] + VMatrix[2][1] * VMatrix[1][1] +
+              VMatrix[2][2] * VMatrix[1][2];
+
+    const f32 invDenom = 1.0f / (DOOD[0] * DOOD[2] - DOOD[1] * DOOD[1]);
+    const f32 v        = (DOOD[2] * DOOD[3] - DOOD[1] * DOOD[4]) * invDenom;
+    const f32 w        = (DOOD[0] * DOOD[4] - DOOD[1] * DOOD[3]) * invDenom;
+
+    out.mIsNearBoundary |= isNearBoundary(v) || isNearBoundary(w) || isNearBoundary(v + w);
+
+    if (!(v < 0.0f || v > 1.0f || w < 0.0f || w > 1.0f || v + w > 1.0f)) {
+        positions[0] += wall.mNormal.x * (query.mRadius - offset);
+        positions[2] += wall.mNormal.z * (query.mRadius - offset);
+        out.mResult = WALL_FACE;
+        return;
+    }
+
+    if (offset < 0)
+        return;
+
+    // Edge 1-2, then 1-3, then 2-3 rebuilt from vertex 1
+    if (VMatrix[0][1] != 0.0f &&
+        solveEdgeReference(wall, VMatrix[0], VMatrix[2], positions, out.mMarginRadius, out))
+        return;
+
+    if (VMatrix[1][1] != 0.0f &&
+        solveEdgeReference(wall, VMatrix[1], VMatrix[2], positions, out.mMarginRadius, out))
+        return;
+
+    VMatrix[1][0] = wall.mVertices[2].x - wall.mVertices[1].x;
+    VMatrix[2][0] = origin.x - wall.mVertices[1].x;
+    VMatrix[1][1] = wall.mVertices[2].y - wall.mVertices[1].y;
+    VMatrix[2][1] = origin.y - wall.mVertices[1].y;
+    VMatrix[1][2] = wall.mVertices[2].z - wall.mVertices[1].z;
+    VMatrix[2][2] = origin.z - wall.mVertices[1].z;
+
+    if (VMatrix[1][1] != 0.0f)
+        solveEdgeReference(wall, VMatrix[1], VMatrix[2], positions, out.mMarginRadius, out);
+}
+
+static void solveCached(const Wall &wall, const TWallEdgeTerms<Vec3> &terms, const Query &query,
+                        WallOutcome &out) {
+    const Vec3 &origin = query.mOrigin;
+    f32 *positions     = out.mPositions;
+
+    out.mResult         = WALL_MISS;
+    out.mIsNearBoundary = false;
+    out.mMarginRadius   = query.mRadius - 1.0f;
+    positions[0]        = origin.x;
+    positions[1]        = origin.y;
+    positions[2]        = origin.z;
+
+    f32 offset;
+    if (!getWallOffset(wall, query, offset))
+        return;
+
+    if (isInsideWallFace(terms, wall.mVertices[0], origin)) {
+        positions[0] += wall.mNormal.x * (query.mRadius - offset);
+        positions[2] += wall.mNormal.z * (query.mRadius - offset);
+        out.mResult = WALL_FACE;
+        return;
+    }
+
+    if (offset < 0)
+        return;
+
+    bool isCorner = false;
+    if (pushOutOfWallEdges(terms, wall.mNormal.x, wall.mNormal.z, wall.mVertices[0],
+                           wall.mVertices[1], positions, origin, out.mMarginRadius, isCorner))
+        out.mResult = isCorner ? WALL_CORNER : WALL_EDGE;
+}
+
+static bool checkEquivalent(const std::vector<Wall> &walls,
+                            const std::vector<TWallEdgeTerms<Vec3>> &terms,
+                            const std::vector<Query> &queries) {
+    u32 counts[4]  = {};
+    u32 boundaries = 0;
+    u32 failures   = 0;
+
+    for (size_t i = 0; i < queries.size(); ++i) {
+        const Query &query = queries[i];
+
+        WallOutcome expected, actual;
+        solveReference(walls[query.mWall], query, expected);
+        solveCached(walls[query.mWall], terms[query.mWall], query, actual);
+
+        counts[expected.mResult] += 1;
+
+        bool isMatch = expected.mResult == actual.mResult;
+        for (int j = 0; isMatch && j < 3; ++j)
+            isMatch = fabsf(expected.mPositions[j] - actual.mPositions[j]) < 1e-2f;
+
+        if (isMatch)
+            continue;
+
+        // A reciprocal can land one ulp away from the quotient, which only matters on the edge
+        // of a range check. Anything else is a real divergence.
+        if (expected.mIsNearBoundary) {
+            boundaries += 1;
+            continue;
+        }
+
+        if (failures++ < 8) {
+            fprintf(stderr,
+                    "query %zu: reference %d (%f, %f) != cached %d (%f, %f)\n", i,
+                    expected.mResult, expected.mPositions[0], expected.mPositions[2],
+                    actual.mResult, actual.mPositions[0], actual.mPositions[2]);
+        }
+    }
+
+    printf("wall_edge: %zu queries, %u miss, %u face, %u edge, %u corner, %u on a boundary\n",
+           queries.size(), counts[WALL_MISS], counts[WALL_FACE], counts[WALL_EDGE],
+           counts[WALL_CORNER], boundaries);
+
+    // Every outcome has to be exercised or the comparison proves nothing
+    for (int i = 0; i < 4; ++i) {
+        if (counts[i] == 0) {
+            fprintf(stderr, "wall_edge: trace never produced outcome %d\n", i);
+            return false;
+        }
+    }
+
+    if (failures > 0) {
+        fprintf(stderr, "wall_edge: %u of %zu queries diverged\n", failures, queries.size());
+        return false;
+    }
+
+    return true;
+}
+
+static void benchmark(const std::vector<Wall> &walls,
+                      const std::vector<TWallEdgeTerms<Vec3>> &terms,
+                      const std::vector<Query> &queries) {
+    typedef std::chrono::steady_clock Clock;
+
+    const int passes = 20;
+    f32 checksum     = 0.0f;
+
+    const Clock::time_point referenceStart = Clock::now();
+    for (int pass = 0; pass < passes; ++pass) {
+        for (size_t i = 0; i < queries.size(); ++i) {
+            WallOutcome out;
+            solveReference(walls[queries[i].mWall], queries[i], out);
+            checksum += out.mPositions[0];
+        }
+    }
+    const Clock::time_point cachedStart = Clock::now();
+    for (int pass = 0; pass < passes; ++pass) {
+        for (size_t i = 0; i < queries.size(); ++i) {
+            WallOutcome out;
+            solveCached(walls[queries[i].mWall], terms[queries[i].mWall], queries[i], out);
+            checksum -= out.mPositions[0];
+        }
+    }
+    const Clock::time_point cachedEnd = Clock::now();
+
+    const f64 total         = (f64)queries.size() * passes;
+    const f64 referenceSecs = std::chrono::duration<f64>(cachedStart - referenceStart).count();
+    const f64 cachedSecs    = std::chrono::duration<f64>(cachedEnd - cachedStart).count();
+
+    printf("wall_edge: reference %.1f ns/query (%.2f M queries/s)\n",
+           referenceSecs * 1e9 / total, total / referenceSecs / 1e6);
+    printf("wall_edge: cached    %.1f ns/query (%.2f M queries/s), %.2fx\n",
+           cachedSecs * 1e9 / total, total / cachedSecs / 1e6, referenceSecs / cachedSecs);
+    printf("wall_edge: checksum %f\n", checksum);
+}
+
+int main() {
+    std::vector<Wall> walls;
+    while (walls.size() < 2048) {
+        Wall wall;
+        if (buildWall(wall))
+            walls.push_back(wall);
+    }
+
+    std::vector<TWallEdgeTerms<Vec3>> terms(walls.size());
+    for (size_t i = 0; i < walls.size(); ++i)
+        computeWallEdgeTerms(walls[i].mVertices[0], walls[i].mVertices[1], walls[i].mVertices[2],
+                             terms[i]);
+
+    std::vector<Query> queries(200000);
+    for (size_t i = 0; i < queries.size(); ++i)
+        buildQuery(walls, (u32)(i % walls.size()), queries[i]);
+
+    if (!checkEquivalent(walls, terms, queries))
+        return 1;
+
+    benchmark(walls, terms, queries);
+    return 0;
+}
@@ -0,0 +1,151 @@
+#!/usr/bin/env python3
+"""Generates the ADP reference data for test_adpcm.
+
+Writes tests/data/adp_reference.adp and tests/data/adp_reference.pcm. The .adp is a tone, a
+full scale square, noise and silence encoded frame by frame, followed by frames of random
+bytes so every header (all four filters, shifts up to 15) and both clamps get exercised.
+Encoders only ever write filters 0-3, so the random headers stay within those too. The
+.pcm is what the drive plays back for it: interleaved stereo, signed 16-bit little endian,
+decoded with the switch-on-filter form of the ADP decoder rather than the engine's table.
+
+Deterministic, rerunning it reproduces the checked in files byte for byte.
+"""
+
+import math
+import os
+import random
+import struct
+
+FRAME_SIZE = 32
+FRAME_SAMPLES = 28
+SAMPLE_RATE = 48000
+
+ENCODED_FRAMES = 512
+RANDOM_FRAMES = 64
+
+
+def clamp(value, lo, hi):
+    return lo if value < lo else hi if value > hi else value
+
+
+def to_s16(value):
+    value &= 0xFFFF
+    return value - 0x10000 if value & 0x8000 else value
+
+
+def decode_sample(nibble, header, hist):
+    filt = header >> 4
+    if filt == 1:
+        predicted = hist[0] * 0x3C
+    elif filt == 2:
+        predicted = hist[0] * 0x73 - hist[1] * 0x34
+    elif filt == 3:
+        predicted = hist[0] * 0x62 - hist[1] * 0x37
+    else:
+        predicted = 0
+
+    predicted = clamp((predicted + 0x20) >> 6, -0x200000, 0x1FFFFF)
+    sample = ((to_s16(nibble << 12) >> (header & 0xF)) << 6) + predicted
+
+    hist[1] = hist[0]
+    hist[0] = sample
+    return clamp(sample >> 6, -0x8000, 0x7FFF)
+
+
+def decode_frame(frame, hists):
+    out = []
+    for i in range(FRAME_SAMPLES):
+        byte = frame[4 + i]
+        out.append(decode_sample(byte & 0xF, frame[0], hists[0]))
+        out.append(decode_sample(byte >> 4, frame[1], hists[1]))
+    return out
+
+
+def encode_channel(samples, hist):
+    """Picks the filter and shift with the least squared error, returns (header, nibbles)."""
+    best = None
+    for filt in range(4):
+        for shift in range(13):
+            header = (filt << 4) | shift
+            trial = list(hist)
+            scale = 1 << (12 - shift)
+            nibbles = []
+            error = 0
+            for target in samples:
+                # Same prediction as the decoder, so the residual is what the nibble must carry
+                probe = list(trial)
+                base = decode_sample(0, header, probe)
+                nibble = clamp(int(round((target - base) / scale)), -8, 7) & 0xF
+                decoded = decode_sample(nibble, header, trial)
+                nibbles.append(nibble)
+                error += (decoded - target) ** 2
+                if best and error >= best[0]:
+                    break
+            else:
+                best = (error, header, nibbles, trial)
+    hist[:] = best[3]
+    return best[1], best[2]
+
+
+def make_signal(frames):
+    rng = random.Random(0xADC0DE)
+    count = frames * FRAME_SAMPLES
+    left = []
+    right = []
+    for n in range(count):
+        t = n / SAMPLE_RATE
+        part = n * 4 // count
+        if part == 0:
+            # Rising sweep against a steady tone
+            left.append(int(12000 * math.sin(2 * math.pi * (200 + 4000 * t) * t)))
+            right.append(int(9000 * math.sin(2 * math.pi * 440 * t)))
+        elif part == 1:
+            # Full scale square, pushes the predictor into its clamps
+            square = 32767 if (n // 37) % 2 else -32768
+            left.append(square)
+            right.append(-square)
+        elif part == 2:
+            left.append(rng.randint(-20000, 20000))
+            right.append(rng.randint(-3000, 3000))
+        else:
+            left.append(0)
+            right.append(0)
+    return left, right
+
+
+def main():
+    root = os.path.join(os.path.dirname(os.path.abspath(__file__)), "..", "data")
+    os.makedirs(root, exist_ok=True)
+
+    left, right = make_signal(ENCODED_FRAMES)
+    enc_hists = [[0, 0], [0, 0]]
+    adp = bytearray()
+
+    for f in range(ENCODED_FRAMES):
+        lo = f * FRAME_SAMPLES
+        headerL, nibblesL = encode_channel(left[lo:lo + FRAME_SAMPLES], enc_hists[0])
+        headerR, nibblesR = encode_channel(right[lo:lo + FRAME_SAMPLES], enc_hists[1])
+        adp += bytes([headerL, headerR, headerL, headerR])
+        adp += bytes((r << 4) | l for l, r in zip(nibblesL, nibblesR))
+
+    rng = random.Random(0xF00D)
+    for _ in range(RANDOM_FRAMES):
+        headerL = rng.randrange(0x40)
+        headerR = rng.randrange(0x40)
+        adp += bytes([headerL, headerR, headerL, headerR])
+        adp += bytes(rng.randrange(256) for _ in range(FRAME_SIZE - 4))
+
+    dec_hists = [[0, 0], [0, 0]]
+    pcm = bytearray()
+    for f in range(len(adp) // FRAME_SIZE):
+        samples = decode_frame(adp[f * FRAME_SIZE:(f + 1) * FRAME_SIZE], dec_hists)
+        pcm += struct.pack("<%dh" % len(samples), *samples)
+
+    with open(os.path.join(root, "adp_reference.adp"), "wb") as out:
+        out.write(adp)
+    with open(os.path.join(root, "adp_reference.pcm"), "wb") as out:
+        out.write(pcm)
+
+
+if __name__ == "__main__":
+    main()